@@ -0,0 +1,163 @@
+// writes csv data generated from a seed and a list of columns into a file,
+// the rows are generated on multiple threads, eg:
+//     csv_generate --rows=100000000 --columns=int,double,text:3-12
+//                  --quote=0.1 --newline=0.01 --errors=0.001 --output=d.csv
+#include "csv_generator.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct options {
+    size_t rows = 1000000;
+    uint64_t seed = 42;
+    size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::string output;
+    ss_bench::csv_schema schema;
+};
+
+bool parse_option(const std::string& arg, const std::string& name,
+                  std::string& value) {
+    std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+bool parse_char(const std::string& value, char& c) {
+    if (value.size() != 1) {
+        return false;
+    }
+    c = value[0];
+    return true;
+}
+
+bool parse_options(int argc, char** argv, options& opts) {
+    auto& schema = opts.schema;
+    ss_bench::parse_columns("int,double,text", schema.columns);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+        try {
+            if (parse_option(arg, "rows", value)) {
+                opts.rows = std::stoull(value);
+            } else if (parse_option(arg, "seed", value)) {
+                opts.seed = std::stoull(value);
+            } else if (parse_option(arg, "threads", value)) {
+                opts.threads = std::max<size_t>(std::stoul(value), 1);
+            } else if (parse_option(arg, "output", value)) {
+                opts.output = value;
+            } else if (parse_option(arg, "columns", value)) {
+                if (!ss_bench::parse_columns(value, schema.columns)) {
+                    return false;
+                }
+            } else if (parse_option(arg, "quote", value)) {
+                schema.quote_ratio = std::stod(value);
+            } else if (parse_option(arg, "escape", value)) {
+                schema.escape_ratio = std::stod(value);
+            } else if (parse_option(arg, "newline", value)) {
+                schema.newline_ratio = std::stod(value);
+            } else if (parse_option(arg, "crlf", value)) {
+                schema.crlf_ratio = std::stod(value);
+            } else if (parse_option(arg, "spaces", value)) {
+                schema.space_ratio = std::stod(value);
+            } else if (parse_option(arg, "errors", value)) {
+                schema.error_ratio = std::stod(value);
+            } else if (parse_option(arg, "delimiter", value)) {
+                if (!parse_char(value, schema.delimiter)) {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        } catch (...) {
+            return false;
+        }
+    }
+    return !opts.output.empty();
+}
+
+void print_usage(const char* name) {
+    std::cerr << "usage: " << name
+              << " --output=FILE [--rows=N] [--seed=N] [--threads=N] "
+                 "[--columns=int,double,text:MIN-MAX,...] [--quote=RATIO] "
+                 "[--escape=RATIO] [--newline=RATIO] [--crlf=RATIO] "
+                 "[--spaces=RATIO] [--errors=RATIO] [--delimiter=C]"
+              << std::endl;
+}
+
+struct chunk {
+    std::string data;
+    size_t errors;
+};
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    FILE* file = std::fopen(opts.output.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << opts.output << " could not be opened" << std::endl;
+        return 1;
+    }
+
+    // the chunks are generated in parallel and written in order, at most
+    // two chunks per thread are kept in memory
+    constexpr size_t chunk_rows = 64 * 1024;
+    ss_bench::csv_generator generator{opts.schema, opts.seed};
+    std::deque<std::future<chunk>> chunks;
+    size_t next_row = 0;
+    size_t errors = 0;
+    size_t bytes = 0;
+
+    auto launch = [&] {
+        size_t first = next_row;
+        size_t count = std::min(chunk_rows, opts.rows - first);
+        next_row += count;
+        chunks.push_back(std::async(std::launch::async, [&, first, count] {
+            chunk c;
+            c.data.reserve(count * 64);
+            c.errors = generator.generate(first, count, c.data);
+            return c;
+        }));
+    };
+
+    while (next_row < opts.rows || !chunks.empty()) {
+        while (next_row < opts.rows && chunks.size() < 2 * opts.threads) {
+            launch();
+        }
+
+        chunk c = chunks.front().get();
+        chunks.pop_front();
+        errors += c.errors;
+        bytes += c.data.size();
+        if (std::fwrite(c.data.data(), 1, c.data.size(), file) !=
+            c.data.size()) {
+            std::cerr << opts.output << " write failed" << std::endl;
+            std::fclose(file);
+            return 1;
+        }
+    }
+
+    if (std::fclose(file) != 0) {
+        std::cerr << opts.output << " write failed" << std::endl;
+        return 1;
+    }
+
+    std::cerr << opts.rows << " rows, " << bytes << " bytes, " << errors
+              << " invalid rows" << std::endl;
+    return 0;
+}
@@ -0,0 +1,312 @@
+#pragma once
+// deterministic generator of csv data used by the benchmarks and the
+// stress tests, the same seed and schema always give the same data
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ss_bench {
+
+////////////////
+// schema
+////////////////
+
+enum class column_type { integer, decimal, text };
+
+struct column {
+    column_type type{column_type::text};
+
+    // length of text fields, uniformly distributed
+    size_t min_length{3};
+    size_t max_length{12};
+};
+
+// all ratios are probabilities from 0 to 1
+struct csv_schema {
+    std::vector<column> columns;
+
+    // text fields which are quoted, half of them contain the delimiter and
+    // a doubled quote
+    double quote_ratio{0};
+
+    // text fields which are not quoted and contain an escaped delimiter
+    double escape_ratio{0};
+
+    // text fields which contain a new line, those fields are quoted
+    double newline_ratio{0};
+
+    // lines which end with "\r\n" instead of "\n"
+    double crlf_ratio{0};
+
+    // fields surrounded by spaces
+    double space_ratio{0};
+
+    // rows which cannot be converted, either because a number is invalid or
+    // because the row has an extra column
+    double error_ratio{0};
+
+    char delimiter{','};
+    char quote{'"'};
+    char escape{'\\'};
+};
+
+// parses a list of columns, eg. "int,double,text:3-12,text:5", the length
+// of text columns is optional, returns false if the description is invalid
+inline bool parse_columns(const std::string& description,
+                          std::vector<column>& columns) {
+    columns.clear();
+    size_t begin = 0;
+    while (begin <= description.size()) {
+        size_t end = description.find(',', begin);
+        if (end == std::string::npos) {
+            end = description.size();
+        }
+
+        std::string name = description.substr(begin, end - begin);
+        std::string length;
+        if (auto colon = name.find(':'); colon != std::string::npos) {
+            length = name.substr(colon + 1);
+            name.resize(colon);
+        }
+
+        column c;
+        if (name == "int") {
+            c.type = column_type::integer;
+        } else if (name == "double") {
+            c.type = column_type::decimal;
+        } else if (name == "text") {
+            c.type = column_type::text;
+        } else {
+            return false;
+        }
+
+        if (!length.empty()) {
+            if (c.type != column_type::text) {
+                return false;
+            }
+
+            auto dash = length.find('-');
+            try {
+                c.min_length = std::stoul(length.substr(0, dash));
+                c.max_length = dash == std::string::npos
+                                   ? c.min_length
+                                   : std::stoul(length.substr(dash + 1));
+            } catch (...) {
+                return false;
+            }
+
+            if (c.min_length == 0 || c.min_length > c.max_length) {
+                return false;
+            }
+        }
+
+        columns.push_back(c);
+        begin = end + 1;
+    }
+    return !columns.empty();
+}
+
+////////////////
+// generator
+////////////////
+
+// every row is generated from its own state derived from the seed and the
+// index of the row, so any range of rows can be generated independently,
+// eg. on multiple threads, and the result does not depend on the ranges
+class csv_generator {
+public:
+    csv_generator(csv_schema schema, uint64_t seed = 42)
+        : schema_{std::move(schema)}, seed_{seed} {
+        for (size_t i = 0; i < schema_.columns.size(); ++i) {
+            if (schema_.columns[i].type != column_type::text) {
+                number_columns_.push_back(i);
+            }
+        }
+    }
+
+    const csv_schema& schema() const {
+        return schema_;
+    }
+
+    // appends the rows from 'first' to 'first + count' to 'out', returns
+    // the number of rows with an injected error
+    size_t generate(size_t first, size_t count, std::string& out) const {
+        size_t errors = 0;
+        for (size_t i = first; i < first + count; ++i) {
+            errors += generate_row(i, out);
+        }
+        return errors;
+    }
+
+    std::string generate(size_t rows) const {
+        std::string out;
+        generate(0, rows, out);
+        return out;
+    }
+
+    // true if an error is injected into the row with the given index
+    bool row_invalid(size_t row) const {
+        random r{seed_, row};
+        return r.chance(schema_.error_ratio);
+    }
+
+private:
+    ////////////////
+    // random
+    ////////////////
+
+    class random {
+    public:
+        random(uint64_t seed, uint64_t row)
+            : state_{mix(seed ^ mix(row + 0x9e3779b97f4a7c15ull))} {
+        }
+
+        uint64_t next() {
+            return mix(state_ += 0x9e3779b97f4a7c15ull);
+        }
+
+        uint64_t number(uint64_t max) {
+            return next() % max;
+        }
+
+        bool chance(double ratio) {
+            return ratio > 0 && (next() >> 11) * 0x1.0p-53 < ratio;
+        }
+
+    private:
+        // splitmix64
+        static uint64_t mix(uint64_t z) {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        uint64_t state_;
+    };
+
+    ////////////////
+    // rows
+    ////////////////
+
+    // the error decision is the first value of the row so that
+    // 'row_invalid' does not need to generate the row
+    bool generate_row(size_t row, std::string& out) const {
+        random r{seed_, row};
+        bool invalid = r.chance(schema_.error_ratio);
+
+        size_t invalid_column = schema_.columns.size();
+        if (invalid && !number_columns_.empty() && r.number(2) == 0) {
+            invalid_column = number_columns_[r.number(number_columns_.size())];
+        }
+
+        for (size_t i = 0; i < schema_.columns.size(); ++i) {
+            if (i != 0) {
+                out += schema_.delimiter;
+            }
+
+            bool spaced = r.chance(schema_.space_ratio);
+            if (spaced) {
+                out += ' ';
+            }
+
+            if (i == invalid_column) {
+                out += '#';
+                append_word(r, 1, 4, out);
+            } else {
+                append_field(r, schema_.columns[i], out);
+            }
+
+            if (spaced) {
+                out += ' ';
+            }
+        }
+
+        if (invalid && invalid_column == schema_.columns.size()) {
+            out += schema_.delimiter;
+            append_word(r, 1, 4, out);
+        }
+
+        out += r.chance(schema_.crlf_ratio) ? "\r\n" : "\n";
+        return invalid;
+    }
+
+    void append_field(random& r, const column& c, std::string& out) const {
+        switch (c.type) {
+        case column_type::integer:
+            append_number(static_cast<int64_t>(r.number(2000001)) - 1000000,
+                          out);
+            break;
+        case column_type::decimal:
+            append_number(static_cast<int64_t>(r.number(10000)), out);
+            out += '.';
+            append_fraction(r.number(1000), out);
+            break;
+        case column_type::text:
+            append_text(r, c, out);
+            break;
+        }
+    }
+
+    void append_text(random& r, const column& c, std::string& out) const {
+        if (r.chance(schema_.newline_ratio)) {
+            out += schema_.quote;
+            append_word(r, 1, c.max_length, out);
+            out += '\n';
+            append_word(r, 1, c.max_length, out);
+            out += schema_.quote;
+        } else if (r.chance(schema_.quote_ratio)) {
+            out += schema_.quote;
+            append_word(r, c.min_length, c.max_length, out);
+            if (r.number(2) == 0) {
+                out += schema_.delimiter;
+                out += schema_.quote;
+                out += schema_.quote;
+                append_word(r, 1, c.max_length, out);
+            }
+            out += schema_.quote;
+        } else if (r.chance(schema_.escape_ratio)) {
+            append_word(r, 1, c.max_length, out);
+            out += schema_.escape;
+            out += schema_.delimiter;
+            append_word(r, 1, c.max_length, out);
+        } else {
+            append_word(r, c.min_length, c.max_length, out);
+        }
+    }
+
+    // lower case letters, a single random value gives up to 12 of them
+    static void append_word(random& r, size_t min_length, size_t max_length,
+                            std::string& out) {
+        size_t length = min_length + r.number(max_length - min_length + 1);
+        while (length > 0) {
+            uint64_t value = r.next();
+            for (size_t i = 0; i < 12 && length > 0; ++i, --length) {
+                out += static_cast<char>('a' + value % 26);
+                value /= 26;
+            }
+        }
+    }
+
+    static void append_number(int64_t value, std::string& out) {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    static void append_fraction(uint64_t value, std::string& out) {
+        out += static_cast<char>('0' + value / 100);
+        out += static_cast<char>('0' + value / 10 % 10);
+        out += static_cast<char>('0' + value % 10);
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    csv_schema schema_;
+    uint64_t seed_;
+    std::vector<size_t> number_columns_;
+};
+
+} /* ss_bench */
@@ -0,0 +1,375 @@
+// benchmark runner for the splitter, the converter and the parser, the
+// results are written as json, eg:
+//     ssp_bench --rows=200000 --repetitions=5 --filter=quoted --output=r.json
+#include "csv_generator.hpp"
+#include <ss/parser.hpp>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+////////////////
+// options
+////////////////
+
+struct options {
+    size_t rows = 200000;
+    size_t repetitions = 5;
+    std::string filter;
+    std::string output;
+};
+
+bool parse_option(const std::string& arg, const std::string& name,
+                  std::string& value) {
+    std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+bool parse_options(int argc, char** argv, options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+        if (parse_option(arg, "rows", value)) {
+            opts.rows = std::stoul(value);
+        } else if (parse_option(arg, "repetitions", value)) {
+            opts.repetitions = std::max<size_t>(std::stoul(value), 1);
+        } else if (parse_option(arg, "filter", value)) {
+            opts.filter = value;
+        } else if (parse_option(arg, "output", value)) {
+            opts.output = value;
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--rows=N] [--repetitions=N] [--filter=TEXT] "
+                         "[--output=FILE]"
+                      << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+////////////////
+// data
+////////////////
+
+using ss_bench::column_type;
+
+// type of each column is chosen by its index
+constexpr column_type column_field(size_t i) {
+    return i % 3 == 0 ? column_type::integer
+                      : (i % 3 == 1 ? column_type::decimal : column_type::text);
+}
+
+template <size_t I>
+using column_t = std::conditional_t<
+    column_field(I) == column_type::integer, int,
+    std::conditional_t<column_field(I) == column_type::decimal, double,
+                       std::string>>;
+
+template <size_t... Is>
+std::tuple<column_t<Is>...> make_row_type(std::index_sequence<Is...>);
+
+template <size_t N>
+using row_t = decltype(make_row_type(std::make_index_sequence<N>{}));
+
+enum class style { plain, quoted, escaped, trimmed, multiline };
+
+// the data is the same on every run, so the results of different runs can
+// be compared
+std::string make_csv(size_t rows, size_t columns, style s) {
+    ss_bench::csv_schema schema;
+    for (size_t i = 0; i < columns; ++i) {
+        ss_bench::column c;
+        c.type = column_field(i);
+        schema.columns.push_back(c);
+    }
+
+    switch (s) {
+    case style::quoted:
+        schema.quote_ratio = 1;
+        break;
+    case style::escaped:
+        schema.escape_ratio = 0.25;
+        break;
+    case style::trimmed:
+        schema.space_ratio = 1;
+        break;
+    case style::multiline:
+        schema.quote_ratio = 1;
+        schema.newline_ratio = 0.25;
+        break;
+    default:
+        break;
+    }
+
+    return ss_bench::csv_generator{schema}.generate(rows);
+}
+
+// records with a field spanning 'lines' lines, either quoted or with
+// escaped new lines, used to check that joining the lines of a record costs
+// time linear in its size
+std::string make_long_records(size_t records, size_t lines, bool escaped) {
+    std::string csv;
+    for (size_t i = 0; i < records; ++i) {
+        csv.append(std::to_string(i)).append(escaped ? "," : ",\"");
+        for (size_t j = 0; j < lines; ++j) {
+            csv.append("line ").append(std::to_string(j));
+            csv.append(escaped ? "\\\n" : "\n");
+        }
+        csv.append(escaped ? ",x\n" : "\",x\n");
+    }
+    return csv;
+}
+
+std::vector<std::string> split_lines(const std::string& csv) {
+    std::vector<std::string> lines;
+    std::istringstream in{csv};
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+////////////////
+// measurement
+////////////////
+
+struct result {
+    std::string name;
+    std::string setup;
+    std::string mode;
+    size_t rows;
+    size_t valid_rows;
+    size_t bytes;
+    double seconds;
+};
+
+// the best time of all repetitions is taken, the function returns the
+// number of valid rows, which also keeps the work from being optimized away
+template <typename Fun>
+double measure(size_t repetitions, size_t& valid_rows, Fun&& fun) {
+    double best = 0;
+    for (size_t i = 0; i < repetitions; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        valid_rows = fun();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - begin;
+        if (i == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+class runner {
+public:
+    runner(const options& opts) : opts_{opts} {
+    }
+
+    // splits every line, the line is copied first since the splitter
+    // modifies it if quoting or escaping is enabled
+    template <typename... Options>
+    void split(const std::string& setup, const std::string& csv) {
+        if (!enabled("split", setup)) {
+            return;
+        }
+
+        auto lines = split_lines(csv);
+        ss::converter<Options...> c;
+        std::string line;
+        size_t valid_rows = 0;
+        double seconds = measure(opts_.repetitions, valid_rows, [&] {
+            size_t valid = 0;
+            for (const auto& l : lines) {
+                line = l;
+                valid += !c.split(line.data()).empty() && c.valid();
+            }
+            return valid;
+        });
+        add("split", setup, lines.size(), valid_rows, csv.size(), seconds);
+    }
+
+    // converts lines which were split beforehand
+    template <typename Row, typename... Options>
+    void convert(const std::string& setup, const std::string& csv) {
+        if (!enabled("convert", setup)) {
+            return;
+        }
+
+        auto lines = split_lines(csv);
+        ss::converter<Options...> c;
+        std::vector<typename ss::converter<Options...>::split_data> split;
+        split.reserve(lines.size());
+        for (auto& line : lines) {
+            split.push_back(c.split(line.data()));
+        }
+
+        size_t valid_rows = 0;
+        double seconds = measure(opts_.repetitions, valid_rows, [&] {
+            size_t valid = 0;
+            for (const auto& elems : split) {
+                c.template convert<Row>(elems);
+                valid += c.valid();
+            }
+            return valid;
+        });
+        add("convert", setup, lines.size(), valid_rows, csv.size(),
+            seconds);
+    }
+
+    // reads and converts the whole file using get_next
+    template <typename Row, typename... Options>
+    void parse(const std::string& setup, const std::string& csv,
+               size_t rows) {
+        if (!enabled("parse", setup)) {
+            return;
+        }
+
+        auto file_name = (std::filesystem::temp_directory_path() /
+                          ("ssp_bench_" + setup + ".csv"))
+                             .string();
+        {
+            std::ofstream out{file_name, std::ios::binary};
+            out << csv;
+        }
+
+        size_t valid_rows = 0;
+        double seconds = measure(opts_.repetitions, valid_rows, [&] {
+            ss::parser<Options...> p{file_name, ","};
+            size_t valid = 0;
+            while (!p.eof()) {
+                p.template get_next<Row>();
+                valid += p.valid();
+            }
+            return valid;
+        });
+        std::filesystem::remove(file_name);
+        add("parse", setup, rows, valid_rows, csv.size(), seconds);
+    }
+
+    template <typename Row, typename... Options>
+    void all(const std::string& setup, const std::string& csv, size_t rows) {
+        split<Options...>(setup, csv);
+        convert<Row, Options...>(setup, csv);
+        parse<Row, Options...>(setup, csv, rows);
+    }
+
+    void write_json(std::ostream& out) const {
+        out << "{\n  \"context\": {\n"
+            << "    \"rows\": " << opts_.rows << ",\n"
+            << "    \"repetitions\": " << opts_.repetitions << ",\n"
+#ifdef SSP_DISABLE_FAST_FLOAT
+            << "    \"fast_float\": false\n"
+#else
+            << "    \"fast_float\": true\n"
+#endif
+            << "  },\n  \"benchmarks\": [";
+
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const auto& r = results_[i];
+            double mb_per_s = r.bytes / r.seconds / (1024 * 1024);
+            double rows_per_s = r.rows / r.seconds;
+            out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << r.name
+                << "\", \"setup\": \"" << r.setup << "\", \"mode\": \""
+                << r.mode << "\", \"rows\": " << r.rows
+                << ", \"valid_rows\": " << r.valid_rows
+                << ", \"bytes\": " << r.bytes << ", \"seconds\": "
+                << r.seconds << ", \"mb_per_s\": " << mb_per_s
+                << ", \"rows_per_s\": " << rows_per_s << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    bool enabled(const std::string& mode, const std::string& setup) const {
+        return (mode + "/" + setup).find(opts_.filter) != std::string::npos;
+    }
+
+    void add(const std::string& mode, const std::string& setup, size_t rows,
+             size_t valid_rows, size_t bytes, double seconds) {
+        results_.push_back(result{mode + "/" + setup, setup, mode, rows,
+                                  valid_rows, bytes, seconds});
+        std::cerr << results_.back().name << ": " << seconds << "s"
+                  << std::endl;
+    }
+
+    const options& opts_;
+    std::vector<result> results_;
+};
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        return 1;
+    }
+
+    constexpr size_t columns = 6;
+    constexpr size_t wide_columns = 48;
+    constexpr size_t narrow_columns = 2;
+    size_t rows = opts.rows;
+
+    // wide rows are fewer so all of the setups have a similar size
+    size_t wide_rows = std::max<size_t>(rows / 8, 1);
+
+    runner r{opts};
+    r.all<row_t<columns>>("plain", make_csv(rows, columns, style::plain),
+                          rows);
+    r.all<row_t<columns>, ss::quote<'"'>>(
+        "quoted", make_csv(rows, columns, style::quoted), rows);
+    r.all<row_t<columns>, ss::escape<'\\'>>(
+        "escaped", make_csv(rows, columns, style::escaped), rows);
+    r.all<row_t<columns>, ss::trim<' '>>(
+        "trimmed", make_csv(rows, columns, style::trimmed), rows);
+    r.all<row_t<wide_columns>>(
+        "wide", make_csv(wide_rows, wide_columns, style::plain), wide_rows);
+    r.all<row_t<narrow_columns>>(
+        "narrow", make_csv(rows, narrow_columns, style::plain), rows);
+
+    // the same data as plain, split into an array instead of a vector
+    r.all<row_t<columns>, ss::max_columns<columns>>(
+        "inline", make_csv(rows, columns, style::plain), rows);
+
+    // the same data as quoted and trimmed, split by the table driven engine
+    r.all<row_t<columns>, ss::quote<'"'>, ss::table_driven>(
+        "quoted_table", make_csv(rows, columns, style::quoted), rows);
+    r.all<row_t<columns>, ss::trim<' '>, ss::table_driven>(
+        "trimmed_table", make_csv(rows, columns, style::trimmed), rows);
+
+    // records span multiple lines, so only the parser can read them
+    r.parse<row_t<columns>, ss::quote<'"'>, ss::multiline>(
+        "multiline", make_csv(rows, columns, style::multiline), rows);
+
+    // the same number of lines joined into many short records or into a
+    // single long one, the throughput should be about the same
+    using long_row = std::tuple<int, std::string, std::string>;
+    size_t long_records = std::max<size_t>(rows / 64, 1);
+    r.parse<long_row, ss::quote<'"'>, ss::multiline>(
+        "short_quoted", make_long_records(long_records, 64, false),
+        long_records);
+    r.parse<long_row, ss::quote<'"'>, ss::multiline>(
+        "long_quoted", make_long_records(1, rows, false), 1);
+    r.parse<long_row, ss::escape<'\\'>, ss::multiline>(
+        "long_escaped", make_long_records(1, rows, true), 1);
+
+    if (opts.output.empty()) {
+        r.write_json(std::cout);
+    } else {
+        std::ofstream out{opts.output};
+        r.write_json(out);
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ss {
+
+////////////////
+// arena
+////////////////
+
+// monotonic storage used to keep extracted std::string_view values valid
+// after the line they were read from is discarded, the memory is handed out
+// from large blocks and is released all at once
+class arena {
+public:
+    constexpr static size_t default_block_size = 64 * 1024;
+
+    arena(size_t block_size = default_block_size)
+        : block_size_{std::max<size_t>(block_size, 1)} {
+    }
+
+    // the moved from arena is left empty, its position would otherwise
+    // point into the blocks which were moved
+    arena(arena&& other)
+        : block_size_{other.block_size_},
+          blocks_{std::move(other.blocks_)},
+          block_index_{std::exchange(other.block_index_, 0)},
+          curr_{std::exchange(other.curr_, nullptr)},
+          available_{std::exchange(other.available_, 0)},
+          used_{std::exchange(other.used_, 0)} {
+        other.blocks_.clear();
+    }
+
+    arena& operator=(arena&& other) {
+        if (this != &other) {
+            block_size_ = other.block_size_;
+            blocks_ = std::move(other.blocks_);
+            block_index_ = std::exchange(other.block_index_, 0);
+            curr_ = std::exchange(other.curr_, nullptr);
+            available_ = std::exchange(other.available_, 0);
+            used_ = std::exchange(other.used_, 0);
+            other.blocks_.clear();
+        }
+        return *this;
+    }
+
+    arena(const arena& other) = delete;
+    arena& operator=(const arena& other) = delete;
+
+    // copies the given range into the arena, the returned view stays valid
+    // until the arena is cleared, released or destroyed
+    std::string_view store(const char* begin, const char* end) {
+        size_t size = end - begin;
+        if (size == 0) {
+            return std::string_view{};
+        }
+
+        char* dst = allocate(size);
+        std::memcpy(dst, begin, size);
+        return std::string_view{dst, size};
+    }
+
+    std::string_view store(std::string_view value) {
+        return store(value.data(), value.data() + value.size());
+    }
+
+    char* allocate(size_t size) {
+        if (size > available_) {
+            next_block(size);
+        }
+
+        char* ret = curr_;
+        curr_ += size;
+        available_ -= size;
+        used_ += size;
+        return ret;
+    }
+
+    // invalidates all stored values but keeps the allocated blocks so
+    // they can be reused
+    void clear() {
+        block_index_ = 0;
+        used_ = 0;
+        if (blocks_.empty()) {
+            curr_ = nullptr;
+            available_ = 0;
+        } else {
+            curr_ = blocks_.front().data.get();
+            available_ = blocks_.front().size;
+        }
+    }
+
+    // invalidates all stored values and frees all of the memory
+    void release() {
+        blocks_.clear();
+        clear();
+    }
+
+    // number of bytes handed out since the last clear
+    size_t used() const {
+        return used_;
+    }
+
+    // number of bytes allocated by the arena
+    size_t capacity() const {
+        size_t capacity = 0;
+        for (const auto& block : blocks_) {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+private:
+    struct block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void next_block(size_t min_size) {
+        // try to reuse the blocks left over from before the last clear
+        while (block_index_ + 1 < blocks_.size()) {
+            auto& next = blocks_[++block_index_];
+            if (next.size >= min_size) {
+                curr_ = next.data.get();
+                available_ = next.size;
+                return;
+            }
+        }
+
+        size_t size = std::max(block_size_, min_size);
+        blocks_.push_back(
+            block{std::unique_ptr<char[]>{new char[size]}, size});
+        block_index_ = blocks_.size() - 1;
+        curr_ = blocks_.back().data.get();
+        available_ = size;
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    size_t block_size_;
+    std::vector<block> blocks_;
+    size_t block_index_{0};
+    char* curr_{nullptr};
+    size_t available_{0};
+    size_t used_{0};
+};
+
+} /* ss */
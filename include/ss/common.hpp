@@ -16,7 +16,15 @@ constexpr inline auto default_delimiter = ",";
 template <bool StringError>
 inline void assert_string_error_defined() {
     static_assert(StringError,
-                  "'string_error' needs to be enabled to use 'error_msg'");
+                  "'string_error' or 'structured_error' needs to be enabled "
+                  "to use 'error_msg'");
+}
+
+template <bool StructuredError>
+inline void assert_structured_error_defined() {
+    static_assert(StructuredError,
+                  "'structured_error' needs to be enabled to use "
+                  "'error_info'");
 }
 
 template <bool ThrowOnError>
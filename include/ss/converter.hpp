@@ -1,19 +1,80 @@
 #pragma once
+#include "arena.hpp"
+#include "error.hpp"
 #include "exception.hpp"
 #include "extract.hpp"
 #include "function_traits.hpp"
 #include "restrictions.hpp"
 #include "splitter.hpp"
+#include "stats.hpp"
 #include "type_traits.hpp"
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace ss {
 INIT_HAS_METHOD(tied)
 INIT_HAS_METHOD(ss_valid)
+INIT_HAS_METHOD(ss_extract)
 INIT_HAS_METHOD(error)
 
+////////////////
+// column selection
+////////////////
+
+// selects the column at index 'N' to be converted into 'T',
+// eg. convert<ss::col<3, int>, ss::col<1, std::string>> converts only the
+// columns at index 3 and 1 into a tuple<int, std::string>
+template <size_t N, typename T>
+struct col {
+    static_assert(!std::is_void_v<T>, "selected column cannot be void");
+
+    constexpr static size_t index = N;
+    using type = T;
+};
+
+template <typename T>
+struct is_col : std::false_type {};
+
+template <size_t N, typename T>
+struct is_col<col<N, T>> : std::true_type {};
+
+template <typename T>
+struct column_type {
+    using type = T;
+};
+
+template <size_t N, typename T>
+struct column_type<col<N, T>> {
+    using type = T;
+};
+
+template <typename T>
+using column_type_t = typename column_type<T>::type;
+
+// number of columns needed to convert the selected columns, 0 if no
+// columns are selected
+template <typename... Ts>
+struct selected_columns {
+    constexpr static size_t value = 0;
+};
+
+template <size_t N, typename T, typename... Ts>
+struct selected_columns<col<N, T>, Ts...> {
+    constexpr static size_t value = (N + 1 > selected_columns<Ts...>::value)
+                                        ? N + 1
+                                        : selected_columns<Ts...>::value;
+};
+
+template <typename... Ts>
+constexpr size_t selected_columns_v = selected_columns<Ts...>::value;
+
 ////////////////
 // replace validator
 ////////////////
@@ -29,7 +90,21 @@ struct no_validator;
 
 template <typename T>
 struct no_validator<T, typename std::enable_if_t<has_m_ss_valid_t<T>>> {
-    using type = typename member_wrapper<decltype(&T::ss_valid)>::arg_type;
+    using type = typename no_validator<
+        typename member_wrapper<decltype(&T::ss_valid)>::arg_type>::type;
+};
+
+// conversion types (eg. ss::enum_map) are replaced with the type they
+// convert to
+template <typename T>
+struct no_validator<T, typename std::enable_if_t<!has_m_ss_valid_t<T> &&
+                                                 has_m_ss_extract_t<T>>> {
+    using type = typename T::value_type;
+};
+
+template <size_t N, typename T>
+struct no_validator<col<N, T>, void> {
+    using type = typename no_validator<T>::type;
 };
 
 template <typename T, typename U>
@@ -52,6 +127,32 @@ struct no_validator_tup<std::tuple<T>> : no_validator<T> {};
 template <typename... Ts>
 using no_validator_tup_t = typename no_validator_tup<Ts...>::type;
 
+////////////////
+// extractor
+////////////////
+
+// the conversion type which is used to extract the value, if any, eg.
+// extractor_t<ss::nx<shape_map, shape::circle>> <=> shape_map
+template <typename T, typename U = void>
+struct extractor {
+    using type = none;
+};
+
+template <typename T>
+struct extractor<T, typename std::enable_if_t<has_m_ss_valid_t<T>>> {
+    using type = typename extractor<
+        typename member_wrapper<decltype(&T::ss_valid)>::arg_type>::type;
+};
+
+template <typename T>
+struct extractor<T, typename std::enable_if_t<!has_m_ss_valid_t<T> &&
+                                              has_m_ss_extract_t<T>>> {
+    using type = T;
+};
+
+template <typename T>
+using extractor_t = typename extractor<T>::type;
+
 ////////////////
 // no void tuple
 ////////////////
@@ -92,6 +193,158 @@ struct tied_class {
 template <typename... Ts>
 constexpr bool tied_class_v = tied_class<Ts...>::value;
 
+// check if the 'tied' method of a non const object returns non const
+// references, in which case the object can be filled in place
+template <typename T, typename U = void>
+struct tied_in_place : std::false_type {};
+
+template <typename T>
+struct tied_in_place<T, std::void_t<decltype(std::declval<T&>().tied())>> {
+    template <typename U>
+    struct is_mutable_ref
+        : std::bool_constant<std::is_lvalue_reference_v<U> &&
+                             !std::is_const_v<std::remove_reference_t<U>>> {
+    };
+
+    constexpr static bool value =
+        std::is_default_constructible_v<T> &&
+        all_of<is_mutable_ref,
+               decltype(std::declval<T&>().tied())>::value;
+};
+
+template <typename T>
+constexpr bool tied_in_place_v = tied_in_place<T>::value;
+
+////////////////
+// direct construction
+////////////////
+
+// check if 'Ts' is a single tuple or tied class
+template <typename... Ts>
+struct compound_argument : std::false_type {};
+
+template <typename T>
+struct compound_argument<T>
+    : std::bool_constant<tied_class_v<T> || is_instance_of_v<std::tuple, T>> {
+};
+
+// converts into any type, used to check if 'T' takes more values
+struct any_value {
+    template <typename U>
+    operator U() const;
+};
+
+// check if 'T' can be initialized using braces from values of 'Us...'
+template <typename T, typename Tuple, typename = void>
+struct brace_constructible : std::false_type {};
+
+template <typename T, typename... Us>
+struct brace_constructible<T, std::tuple<Us...>,
+                           std::void_t<decltype(T{std::declval<Us>()...})>>
+    : std::true_type {};
+
+// check if 'T' is constructed from exactly the values of 'Ts', aggregates
+// with more members would leave them without an initializer
+template <typename T, typename... Ts>
+struct exact_construction {
+    using values = std::tuple<no_validator_t<column_type_t<Ts>>...>;
+    using more_values =
+        std::tuple<no_validator_t<column_type_t<Ts>>..., any_value>;
+
+    constexpr static bool value = brace_constructible<T, values>::value &&
+                                  !brace_constructible<T, more_values>::value;
+};
+
+// check if the values of 'Ts' can be extracted one by one
+template <typename... Ts>
+struct separate_arguments
+    : std::bool_constant<(sizeof...(Ts) > 0) &&
+                         count_v<std::is_void, Ts...> == 0 &&
+                         !compound_argument<Ts...>::value> {};
+
+// check if 'T' can be constructed directly from the values extracted as
+// 'Ts' without a tuple in between
+template <typename T, typename... Ts>
+struct direct_construction
+    : std::conjunction<separate_arguments<Ts...>,
+                       exact_construction<T, Ts...>> {};
+
+template <typename T, typename... Ts>
+constexpr bool direct_construction_v = direct_construction<T, Ts...>::value;
+
+////////////////
+// memoization
+////////////////
+
+// unique address for each type, used as a key
+template <typename... Ts>
+struct type_tag {
+    constexpr static char id{};
+};
+
+constexpr static size_t memo_value_size = 16;
+
+// values which can be stored in a memo entry
+template <typename T>
+struct memoizable {
+    constexpr static bool value = std::is_trivially_copyable_v<T> &&
+                                  sizeof(T) <= memo_value_size &&
+                                  alignof(T) <= alignof(std::max_align_t);
+};
+
+template <typename T>
+constexpr bool memoizable_v = memoizable<T>::value;
+
+// result of the extraction of a column into a type, the type is null if
+// the column was not extracted
+struct memo_entry {
+    const void* type;
+    bool valid;
+    alignas(std::max_align_t) unsigned char value[memo_value_size];
+};
+
+////////////////
+// plan
+////////////////
+
+// precomputed column positions used to convert lines into 'Ts', usually
+// made by parser::make_plan from the names of the header fields, it can
+// be reused for any input with the same header
+template <typename... Ts>
+class plan {
+    static_assert(sizeof...(Ts) > 0, "plan needs at least one type");
+    static_assert(count_v<std::is_void, Ts...> == 0,
+                  "plan types cannot be void");
+
+public:
+    plan() = default;
+
+    // 'columns' are the positions of the values within a line which has
+    // 'number_of_columns' columns
+    plan(const std::array<size_t, sizeof...(Ts)>& columns,
+         size_t number_of_columns)
+        : columns_{columns}, number_of_columns_{number_of_columns},
+          valid_{true} {
+    }
+
+    bool valid() const {
+        return valid_;
+    }
+
+    const std::array<size_t, sizeof...(Ts)>& columns() const {
+        return columns_;
+    }
+
+    size_t number_of_columns() const {
+        return number_of_columns_;
+    }
+
+private:
+    std::array<size_t, sizeof...(Ts)> columns_{};
+    size_t number_of_columns_{0};
+    bool valid_{false};
+};
+
 ////////////////
 // converter
 ////////////////
@@ -102,17 +355,34 @@ class converter {
 
     constexpr static auto string_error = setup<Options...>::string_error;
     constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
     constexpr static auto default_delimiter = ",";
+    constexpr static auto collect_stats = setup<Options...>::collect_stats;
 
-    using error_type = std::conditional_t<string_error, std::string, bool>;
+    using null_values = typename setup<Options...>::null_values;
+
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
 
 public:
+    using split_data = typename splitter<Options...>::split_data;
+
+    converter() = default;
+
+    // the split data is allocated using the memory resource, requires the
+    // 'use_pmr' setup option
+    explicit converter(ss::memory_resource* resource) : splitter_{resource} {
+    }
+
     // parses line with given delimiter, returns a 'T' object created with
     // extracted values of type 'Ts'
     template <typename T, typename... Ts>
     T convert_object(line_ptr_type line,
                      const std::string& delim = default_delimiter) {
-        return to_object<T>(convert<Ts...>(line, delim));
+        split(line, delim, selected_columns_v<Ts...>);
+        return convert_object<T, Ts...>(splitter_.split_data_);
     }
 
     // parses line with given delimiter, returns tuple of objects with
@@ -120,7 +390,7 @@ public:
     template <typename... Ts>
     no_void_validator_tup_t<Ts...> convert(
         line_ptr_type line, const std::string& delim = default_delimiter) {
-        split(line, delim);
+        split(line, delim, selected_columns_v<Ts...>);
         if (splitter_.valid()) {
             return convert<Ts...>(splitter_.split_data_);
         } else {
@@ -129,16 +399,26 @@ public:
         }
     }
 
-    // parses already split line, returns 'T' object with extracted values
+    // parses already split line, returns 'T' object with extracted values,
+    // the object is constructed directly from the extracted values
+    // without a tuple in between if possible
     template <typename T, typename... Ts>
     T convert_object(const split_data& elems) {
-        return to_object<T>(convert<Ts...>(elems));
+        if constexpr (direct_construction_v<T, Ts...>) {
+            if (!check_columns<Ts...>(elems)) {
+                return T{no_validator_t<column_type_t<Ts>>{}...};
+            }
+            return construct_object<T, Ts...>(elems,
+                                              std::index_sequence_for<Ts...>{});
+        } else {
+            return to_object<T>(convert<Ts...>(elems));
+        }
     }
 
     // same as above, but uses cached split line
     template <typename T, typename... Ts>
     T convert_object() {
-        return to_object<T>(convert<Ts...>());
+        return convert_object<T, Ts...>(splitter_.split_data_);
     }
 
     // parses already split line, returns either a tuple of objects with
@@ -149,6 +429,18 @@ public:
     no_void_validator_tup_t<T, Ts...> convert(const split_data& elems) {
         if constexpr (sizeof...(Ts) == 0 && is_instance_of_v<std::tuple, T>) {
             return convert_impl(elems, static_cast<T*>(nullptr));
+        } else if constexpr (tied_class_v<T, Ts...> && tied_in_place_v<T>) {
+            using arg_ref_tuple = decltype(std::declval<T&>().tied());
+            using arg_tuple = apply_trait_t<std::decay, arg_ref_tuple>;
+
+            T value{};
+            if (check_columns(elems, static_cast<arg_tuple*>(nullptr))) {
+                auto refs = value.tied();
+                fill_tied(refs, elems,
+                          std::make_index_sequence<
+                              std::tuple_size_v<arg_ref_tuple>>{});
+            }
+            return value;
         } else if constexpr (tied_class_v<T, Ts...>) {
             using arg_ref_tuple = std::result_of_t<decltype (&T::tied)(T)>;
             using arg_tuple = apply_trait_t<std::decay, arg_ref_tuple>;
@@ -166,9 +458,79 @@ public:
         return convert<T, Ts...>(splitter_.split_data_);
     }
 
+    // converts the cached split line into an existing tuple, reusing the
+    // storage of its elements, on error the elements after the invalid
+    // one keep their previous values
+    template <typename... Ts>
+    void convert_into(no_void_validator_tup_t<Ts...>& dst) {
+        static_assert(!compound_argument<Ts...>::value,
+                      "tuples and tied classes cannot be converted into");
+        if (check_columns<Ts...>(splitter_.split_data_)) {
+            extract_multiple<0, 0, Ts...>(dst, splitter_.split_data_);
+        }
+    }
+
+    // same as above, but converts into an existing object, which is
+    // filled in place if it is a tied class
+    template <typename T, typename... Ts>
+    void convert_object_into(T& dst) {
+        if constexpr (sizeof...(Ts) == 0 && tied_in_place_v<T>) {
+            using arg_ref_tuple = decltype(std::declval<T&>().tied());
+            using arg_tuple = apply_trait_t<std::decay, arg_ref_tuple>;
+
+            if (check_columns(splitter_.split_data_,
+                              static_cast<arg_tuple*>(nullptr))) {
+                auto refs = dst.tied();
+                fill_tied(refs, splitter_.split_data_,
+                          std::make_index_sequence<
+                              std::tuple_size_v<arg_ref_tuple>>{});
+            }
+        } else if constexpr (sizeof...(Ts) == 0) {
+            dst = convert<T>();
+        } else {
+            dst = convert_object<T, Ts...>(splitter_.split_data_);
+        }
+    }
+
+    // parses already split line using the column positions of the plan,
+    // the column mapping is ignored
+    template <typename... Ts>
+    no_void_validator_tup_t<Ts...> convert(const ss::plan<Ts...>& plan,
+                                           const split_data& elems) {
+        clear_error();
+
+        if (!splitter_.valid()) {
+            handle_error_bad_split();
+            return {};
+        }
+
+        if (!plan.valid()) {
+            handle_error_incompatible_mapping(sizeof...(Ts), 0);
+            return {};
+        }
+
+        if (elems.size() != plan.number_of_columns()) {
+            handle_error_number_of_columns(plan.number_of_columns(),
+                                           elems.size());
+            return {};
+        }
+
+        no_void_validator_tup_t<Ts...> ret{};
+        extract_planned(plan, ret, elems, std::index_sequence_for<Ts...>{});
+        return ret;
+    }
+
+    // same as above, but uses cached split line
+    template <typename... Ts>
+    no_void_validator_tup_t<Ts...> convert(const ss::plan<Ts...>& plan) {
+        return convert(plan, splitter_.split_data_);
+    }
+
     bool valid() const {
         if constexpr (string_error) {
             return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
         } else if constexpr (throw_on_error) {
             return true;
         } else {
@@ -177,10 +539,30 @@ public:
     }
 
     const std::string& error_msg() const {
-        assert_string_error_defined<string_error>();
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = error_.message();
+            return error_msg_;
+        } else {
+            return error_;
+        }
+    }
+
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
         return error_;
     }
 
+    // conversions, failures and shifted escapes counted since the
+    // converter was created, the counters of the reader are not set
+    ss::parser_stats stats() const {
+        static_assert(collect_stats,
+                      "collect_stats needs to be enabled to use this method");
+        ss::parser_stats ret = stats_;
+        ret.escapes_shifted = splitter_.escapes_shifted_;
+        return ret;
+    }
+
     bool unterminated_quote() const {
         return splitter_.unterminated_quote();
     }
@@ -189,15 +571,47 @@ public:
     // contain the beginnings and the ends of each column of the string
     const split_data& split(line_ptr_type line,
                             const std::string& delim = default_delimiter) {
+        return split(line, delim, 0);
+    }
+
+    // extracted std::string_view values will be copied into the given
+    // arena, and will stay valid as long as the arena does, passing
+    // nullptr makes the values point into the line again
+    void use_arena(ss::arena* arena) {
+        arena_ = arena;
+    }
+
+private:
+    // splits only the first 'columns' columns of the line if not 0, the
+    // rest of the line is ignored, not used with quoted multiline since
+    // the whole line is needed to find unterminated quotes
+    const split_data& split(line_ptr_type line, const std::string& delim,
+                            size_t columns) {
         splitter_.split_data_.clear();
         if (line[0] == '\0') {
             return splitter_.split_data_;
         }
 
-        return splitter_.split(line, delim);
+        if constexpr (setup<Options...>::multiline::enabled &&
+                      setup<Options...>::quote::enabled) {
+            columns = 0;
+        }
+
+        return splitter_.split(line, delim, columns);
+    }
+
+    ////////////////
+    // memoization
+    ////////////////
+
+    // clears the stored extraction results, and enables or disables
+    // storing them for the current line, one result is stored per column
+    void memoize(bool enabled) {
+        memo_.assign(enabled ? splitter_.split_data_.size() : 0,
+                     memo_entry{});
+        memo_enabled_ = enabled;
     }
 
-private:
     ////////////////
     // resplit
     ////////////////
@@ -218,6 +632,8 @@ private:
     void clear_error() {
         if constexpr (string_error) {
             error_.clear();
+        } else if constexpr (structured_error) {
+            error_.code = error_code::none;
         } else {
             error_ = false;
         }
@@ -234,20 +650,45 @@ private:
         return error;
     }
 
+    void count_failure(error_code code) {
+        if constexpr (collect_stats) {
+            ++stats_.failures[static_cast<size_t>(code)];
+        }
+    }
+
+    void set_field_error(error_code code, const string_range msg,
+                         size_t pos) {
+        error_.set(code);
+        error_.column = pos;
+        error_.raw = msg;
+        error_.offset = msg.first - splitter_.line_;
+    }
+
     void handle_error_bad_split() {
+        if constexpr (collect_stats) {
+            count_failure(splitter_.error_code_);
+        }
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(splitter_.error_msg());
+        } else if constexpr (structured_error) {
+            error_ = splitter_.error_;
         } else if constexpr (!throw_on_error) {
             error_ = true;
         }
     }
 
     void handle_error_unterminated_escape() {
+        count_failure(error_code::unterminated_escape);
+
         if constexpr (string_error) {
             error_.clear();
             splitter_.handle_error_unterminated_escape();
             error_.append(splitter_.error_msg());
+        } else if constexpr (structured_error) {
+            splitter_.handle_error_unterminated_escape();
+            error_ = splitter_.error_;
         } else if constexpr (throw_on_error) {
             splitter_.handle_error_unterminated_escape();
         } else {
@@ -256,10 +697,15 @@ private:
     }
 
     void handle_error_unterminated_quote() {
+        count_failure(error_code::unterminated_quote);
+
         if constexpr (string_error) {
             error_.clear();
             splitter_.handle_error_unterminated_quote();
             error_.append(splitter_.error_msg());
+        } else if constexpr (structured_error) {
+            splitter_.handle_error_unterminated_quote();
+            error_ = splitter_.error_;
         } else if constexpr (throw_on_error) {
             splitter_.handle_error_unterminated_quote();
         } else {
@@ -270,9 +716,13 @@ private:
     void handle_error_multiline_limit_reached() {
         constexpr static auto error_msg = "multiline limit reached";
 
+        count_failure(error_code::multiline_limit_reached);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::multiline_limit_reached);
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg};
         } else {
@@ -280,12 +730,34 @@ private:
         }
     }
 
+    void handle_error_record_too_large(size_t limit) {
+        constexpr static auto error_msg = "record too large, limit: ";
+
+        count_failure(error_code::record_too_large);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg).append(std::to_string(limit));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::record_too_large);
+            error_.expected = limit;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg + std::to_string(limit)};
+        } else {
+            error_ = true;
+        }
+    }
+
     void handle_error_invalid_conversion(const string_range msg, size_t pos) {
         constexpr static auto error_msg = "invalid conversion for parameter ";
 
+        count_failure(error_code::invalid_conversion);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg).append(error_sufix(msg, pos));
+        } else if constexpr (structured_error) {
+            set_field_error(error_code::invalid_conversion, msg, pos);
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg + error_sufix(msg, pos)};
         } else {
@@ -295,9 +767,14 @@ private:
 
     void handle_error_validation_failed(const char* const error,
                                         const string_range msg, size_t pos) {
+        count_failure(error_code::validation_failed);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error).append(" ").append(error_sufix(msg, pos));
+        } else if constexpr (structured_error) {
+            set_field_error(error_code::validation_failed, msg, pos);
+            error_.detail = error;
         } else if constexpr (throw_on_error) {
             throw ss::exception{error + (" " + error_sufix(msg, pos))};
         } else {
@@ -310,12 +787,18 @@ private:
             "invalid number of columns, expected: ";
         constexpr static auto error_msg2 = ", got: ";
 
+        count_failure(error_code::number_of_columns);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg1)
                 .append(std::to_string(expected_pos))
                 .append(error_msg2)
                 .append(std::to_string(pos));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::number_of_columns);
+            error_.expected = expected_pos;
+            error_.got = pos;
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg1 + std::to_string(expected_pos) +
                                 error_msg2 + std::to_string(pos)};
@@ -330,12 +813,18 @@ private:
             "number of arguments does not match mapping, expected: ";
         constexpr static auto error_msg2 = ", got: ";
 
+        count_failure(error_code::incompatible_mapping);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg1)
                 .append(std::to_string(mapping_size))
                 .append(error_msg2)
                 .append(std::to_string(argument_size));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::incompatible_mapping);
+            error_.expected = mapping_size;
+            error_.got = argument_size;
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg1 + std::to_string(mapping_size) +
                                 error_msg2 + std::to_string(argument_size)};
@@ -350,40 +839,67 @@ private:
 
     template <typename... Ts>
     no_void_validator_tup_t<Ts...> convert_impl(const split_data& elems) {
+        if (!check_columns<Ts...>(elems)) {
+            return {};
+        }
+
+        return extract_tuple<Ts...>(elems);
+    }
+
+    // do not know how to specialize by return type :(
+    template <typename... Ts>
+    no_void_validator_tup_t<std::tuple<Ts...>> convert_impl(
+        const split_data& elems, const std::tuple<Ts...>*) {
+        return convert_impl<Ts...>(elems);
+    }
+
+    // clears the error and checks if the split line can be converted
+    // into 'Ts', sets the error if not
+    template <typename... Ts>
+    bool check_columns(const split_data& elems) {
         clear_error();
 
         if (!splitter_.valid()) {
             handle_error_bad_split();
-            return {};
+            return false;
         }
 
-        if (!columns_mapped()) {
+        if constexpr (count_v<is_col, Ts...> > 0) {
+            static_assert(count_v<is_col, Ts...> == sizeof...(Ts),
+                          "either all or none of the columns need to be "
+                          "selected using ss::col");
+
+            // the column mapping is ignored if columns are selected
+            constexpr size_t columns = selected_columns_v<Ts...>;
+            if (elems.size() < columns) {
+                handle_error_number_of_columns(columns, elems.size());
+                return false;
+            }
+        } else if (!columns_mapped()) {
             if (sizeof...(Ts) != elems.size()) {
                 handle_error_number_of_columns(sizeof...(Ts), elems.size());
-                return {};
+                return false;
             }
         } else {
             if (sizeof...(Ts) != column_mappings_.size()) {
                 handle_error_incompatible_mapping(sizeof...(Ts),
                                                   column_mappings_.size());
-                return {};
+                return false;
             }
 
             if (elems.size() != number_of_columns_) {
                 handle_error_number_of_columns(number_of_columns_,
                                                elems.size());
-                return {};
+                return false;
             }
         }
 
-        return extract_tuple<Ts...>(elems);
+        return true;
     }
 
-    // do not know how to specialize by return type :(
     template <typename... Ts>
-    no_void_validator_tup_t<std::tuple<Ts...>> convert_impl(
-        const split_data& elems, const std::tuple<Ts...>*) {
-        return convert_impl<Ts...>(elems);
+    bool check_columns(const split_data& elems, const std::tuple<Ts...>*) {
+        return check_columns<Ts...>(elems);
     }
 
     ////////////////
@@ -418,18 +934,83 @@ private:
     ////////////////
 
     template <typename T>
-    void extract_one(no_validator_t<T>& dst, const string_range msg,
-                     size_t pos) {
+    bool extract_value(const char* begin, const char* end,
+                       no_validator_t<T>& dst) {
+        using value_type = no_validator_t<T>;
+
+        if constexpr (!std::is_same_v<extractor_t<T>, none>) {
+            return extractor_t<T>::ss_extract(begin, end, dst);
+        } else {
+            if constexpr (null_values::enabled &&
+                          is_instance_of_v<std::optional, value_type>) {
+                if (null_values::match(begin, end)) {
+                    dst = std::nullopt;
+                    return true;
+                }
+
+                if constexpr (null_values::strict) {
+                    typename value_type::value_type value;
+                    if (!extract(begin, end, value)) {
+                        return false;
+                    }
+                    dst = std::move(value);
+                    return true;
+                }
+            }
+
+            return extract(begin, end, dst);
+        }
+    }
+
+    // if enabled, the results of the extractions of small trivially
+    // copyable types are stored, indexed by the column and checked against
+    // the type, so other conversions of the same line can reuse them
+    template <typename T>
+    bool extract_value_memoized(const string_range msg, size_t column,
+                                no_validator_t<T>& dst) {
+        using value_type = no_validator_t<T>;
+
+        if constexpr (memoizable_v<value_type>) {
+            if (memo_enabled_ && column < memo_.size()) {
+                const void* type = &type_tag<value_type, extractor_t<T>>::id;
+                auto& entry = memo_[column];
+                if (entry.type == type) {
+                    if (entry.valid) {
+                        std::memcpy(&dst, entry.value, sizeof(value_type));
+                    }
+                    return entry.valid;
+                }
+
+                entry.type = type;
+                entry.valid = extract_value<T>(msg.first, msg.second, dst);
+                if (entry.valid) {
+                    std::memcpy(entry.value, &dst, sizeof(value_type));
+                }
+                return entry.valid;
+            }
+        }
+
+        return extract_value<T>(msg.first, msg.second, dst);
+    }
+
+    // extracts the given column of the split data, 'pos' is the reported
+    // position of the parameter
+    template <typename T>
+    void extract_one(no_validator_t<T>& dst, const split_data& elems,
+                     size_t column, size_t pos) {
         if (!valid()) {
             return;
         }
 
+        const string_range msg = elems[column];
+
         if constexpr (std::is_same_v<T, std::string>) {
             extract(msg.first, msg.second, dst);
+            count_conversion<T>();
             return;
         }
 
-        if (!extract(msg.first, msg.second, dst)) {
+        if (!extract_value_memoized<T>(msg, column, dst)) {
             handle_error_invalid_conversion(msg, pos);
             return;
         }
@@ -445,6 +1026,42 @@ private:
                 return;
             }
         }
+
+        store_if_arena_used(dst);
+        count_conversion<no_validator_t<T>>();
+    }
+
+    template <typename T>
+    void count_conversion() {
+        if constexpr (collect_stats) {
+            if constexpr (std::is_same_v<T, bool> ||
+                          std::is_same_v<T, char>) {
+                ++stats_.other_conversions;
+            } else if constexpr (std::is_integral_v<T>) {
+                ++stats_.integer_conversions;
+            } else if constexpr (std::is_floating_point_v<T>) {
+                ++stats_.floating_point_conversions;
+            } else if constexpr (std::is_same_v<T, std::string> ||
+                                 std::is_same_v<T, std::string_view>) {
+                ++stats_.string_conversions;
+            } else {
+                ++stats_.other_conversions;
+            }
+        }
+    }
+
+    template <typename T>
+    void store_if_arena_used(T& dst) {
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            if (arena_) {
+                dst = arena_->store(dst);
+            }
+        } else if constexpr (std::is_same_v<T,
+                                            std::optional<std::string_view>>) {
+            if (arena_ && dst) {
+                dst = arena_->store(*dst);
+            }
+        }
     }
 
     template <size_t ArgN, size_t TupN, typename... Ts>
@@ -455,12 +1072,22 @@ private:
         constexpr bool not_void = !std::is_void_v<elem_t>;
         constexpr bool one_element = count_not_v<std::is_void, Ts...> == 1;
 
-        if constexpr (not_void) {
+        if constexpr (is_col<elem_t>::value) {
+            using col_t = column_type_t<elem_t>;
+            constexpr size_t pos = elem_t::index;
+
+            if constexpr (one_element) {
+                extract_one<col_t>(tup, elems, pos, pos);
+            } else {
+                auto& el = std::get<TupN>(tup);
+                extract_one<col_t>(el, elems, pos, pos);
+            }
+        } else if constexpr (not_void) {
             if constexpr (one_element) {
-                extract_one<elem_t>(tup, elems[column_position(ArgN)], ArgN);
+                extract_one<elem_t>(tup, elems, column_position(ArgN), ArgN);
             } else {
                 auto& el = std::get<TupN>(tup);
-                extract_one<elem_t>(el, elems[column_position(ArgN)], ArgN);
+                extract_one<elem_t>(el, elems, column_position(ArgN), ArgN);
             }
         }
 
@@ -470,6 +1097,48 @@ private:
         }
     }
 
+    template <typename Tuple, size_t... Is>
+    void fill_tied(Tuple& refs, const split_data& elems,
+                   std::index_sequence<Is...>) {
+        using arg_tuple = apply_trait_t<std::decay, Tuple>;
+        (extract_one<std::tuple_element_t<Is, arg_tuple>>(
+             std::get<Is>(refs), elems, column_position(Is), Is),
+         ...);
+    }
+
+    // extracts the value of the argument 'I', 'T' can be ss::col
+    template <typename T, size_t I>
+    no_validator_t<column_type_t<T>> extract_argument(const split_data& elems) {
+        no_validator_t<column_type_t<T>> value{};
+        if constexpr (is_col<T>::value) {
+            extract_one<column_type_t<T>>(value, elems, T::index, T::index);
+        } else {
+            extract_one<T>(value, elems, column_position(I), I);
+        }
+        return value;
+    }
+
+    // braced initialization guarantees left to right evaluation, so the
+    // error semantics are the same as when extracting into a tuple
+    template <typename T, typename... Ts, size_t... Is>
+    T construct_object(const split_data& elems, std::index_sequence<Is...>) {
+        return T{extract_argument<Ts, Is>(elems)...};
+    }
+
+    template <typename... Ts, size_t... Is>
+    void extract_planned(const ss::plan<Ts...>& plan,
+                         no_void_validator_tup_t<Ts...>& tup,
+                         const split_data& elems, std::index_sequence<Is...>) {
+        const auto& columns = plan.columns();
+        if constexpr (sizeof...(Ts) == 1) {
+            extract_one<Ts...>(tup, elems, columns[0], columns[0]);
+        } else {
+            (extract_one<Ts>(std::get<Is>(tup), elems, columns[Is],
+                             columns[Is]),
+             ...);
+        }
+    }
+
     template <typename... Ts>
     no_void_validator_tup_t<Ts...> extract_tuple(const split_data& elems) {
         static_assert(!all_of_v<std::is_void, Ts...>,
@@ -484,13 +1153,24 @@ private:
     ////////////////
 
     error_type error_{};
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
     splitter<Options...> splitter_;
 
     template <typename...>
     friend class parser;
 
+    template <typename...>
+    friend class push_parser;
+
     std::vector<size_t> column_mappings_;
     size_t number_of_columns_;
+
+    ss::arena* arena_{nullptr};
+
+    std::vector<memo_entry> memo_;
+    bool memo_enabled_{false};
+
+    std::conditional_t<collect_stats, ss::parser_stats, none> stats_{};
 };
 
 } /* ss */
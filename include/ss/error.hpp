@@ -0,0 +1,186 @@
+#pragma once
+#include "common.hpp"
+#include <cstdint>
+#include <string>
+
+namespace ss {
+
+////////////////
+// error code
+////////////////
+
+enum class error_code : uint8_t {
+    none,
+    file_not_open,
+    eof_reached,
+    empty_delimiter,
+    mismatched_quote,
+    unterminated_escape,
+    unterminated_quote,
+    invalid_resplit,
+    multiline_limit_reached,
+    invalid_conversion,
+    validation_failed,
+    number_of_columns,
+    incompatible_mapping,
+    failed_check,
+    header_ignored,
+    invalid_field,
+    field_used_multiple_times,
+    empty_mapping,
+    invalid_header,
+    write_failed,
+    invalid_output_field,
+    missing_block,
+    record_too_large,
+    too_many_columns
+};
+
+// number of error codes, needs to be updated if one is added after the last
+constexpr inline size_t error_code_count =
+    static_cast<size_t>(error_code::too_many_columns) + 1;
+
+inline const char* error_code_name(error_code code) {
+    switch (code) {
+    case error_code::none:
+        return "none";
+    case error_code::file_not_open:
+        return "file not open";
+    case error_code::eof_reached:
+        return "read on end of file";
+    case error_code::empty_delimiter:
+        return "empty delimiter";
+    case error_code::mismatched_quote:
+        return "mismatched quote";
+    case error_code::unterminated_escape:
+        return "unterminated escape";
+    case error_code::unterminated_quote:
+        return "unterminated quote";
+    case error_code::invalid_resplit:
+        return "invalid resplit";
+    case error_code::multiline_limit_reached:
+        return "multiline limit reached";
+    case error_code::invalid_conversion:
+        return "invalid conversion";
+    case error_code::validation_failed:
+        return "validation failed";
+    case error_code::number_of_columns:
+        return "invalid number of columns";
+    case error_code::incompatible_mapping:
+        return "number of arguments does not match mapping";
+    case error_code::failed_check:
+        return "failed check";
+    case error_code::header_ignored:
+        return "header ignored";
+    case error_code::invalid_field:
+        return "header does not contain given field";
+    case error_code::field_used_multiple_times:
+        return "given field used multiple times";
+    case error_code::empty_mapping:
+        return "received empty mapping";
+    case error_code::invalid_header:
+        return "header contains duplicates";
+    case error_code::write_failed:
+        return "write failed";
+    case error_code::invalid_output_field:
+        return "field cannot be written without quoting or escaping";
+    case error_code::missing_block:
+        return "missing block";
+    case error_code::record_too_large:
+        return "record too large";
+    case error_code::too_many_columns:
+        return "too many columns";
+    }
+    return "unknown";
+}
+
+////////////////
+// error info
+////////////////
+
+// compact description of an error used by the 'structured_error' setup
+// option, no memory is allocated when it is set, the message is formatted
+// only if requested
+struct error_info {
+    error_code code{error_code::none};
+
+    // line of the file, 0 if not related to a line
+    size_t line{0};
+
+    // index of the column, if related to one
+    size_t column{0};
+
+    // byte offset of the field within the file when set by the parser,
+    // or within the line when set by the converter or the splitter
+    size_t offset{0};
+
+    // raw content of the field, valid only until the next line is read
+    string_range raw{nullptr, nullptr};
+
+    // static message of the failed restriction, if any
+    const char* detail{nullptr};
+
+    // expected and received number of columns or arguments
+    size_t expected{0};
+    size_t got{0};
+
+    bool valid() const {
+        return code == error_code::none;
+    }
+
+    void set(error_code new_code) {
+        *this = error_info{};
+        code = new_code;
+    }
+
+    std::string message() const {
+        std::string msg;
+        msg.reserve(64);
+        switch (code) {
+        case error_code::mismatched_quote:
+            msg.append("mismatched quote at position: ")
+                .append(std::to_string(offset));
+            break;
+        case error_code::invalid_conversion:
+            msg.append("invalid conversion for parameter ");
+            append_field(msg);
+            break;
+        case error_code::validation_failed:
+            msg.append(detail ? detail : "validation error").append(" ");
+            append_field(msg);
+            break;
+        case error_code::invalid_output_field:
+            msg.append(error_code_name(code)).append(" ");
+            append_field(msg);
+            break;
+        case error_code::number_of_columns:
+        case error_code::incompatible_mapping:
+            msg.append(error_code_name(code))
+                .append(", expected: ")
+                .append(std::to_string(expected))
+                .append(", got: ")
+                .append(std::to_string(got));
+            break;
+        case error_code::record_too_large:
+        case error_code::too_many_columns:
+            msg.append(error_code_name(code))
+                .append(", limit: ")
+                .append(std::to_string(expected));
+            break;
+        default:
+            msg.append(error_code_name(code));
+            break;
+        }
+        return msg;
+    }
+
+private:
+    void append_field(std::string& msg) const {
+        msg.append("at column ").append(std::to_string(column + 1));
+        if (raw.first != nullptr) {
+            msg.append(": \'").append(raw.first, raw.second).append("\'");
+        }
+    }
+};
+
+} /* ss */
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "type_traits.hpp"
+#include <array>
+#include <cctype>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <optional>
@@ -130,15 +133,136 @@ std::enable_if_t<is_instance_of_v<std::optional, T>, bool> extract(
     return true;
 }
 
+////////////////
+// lexical classification
+////////////////
+
+// bitmask of the kinds of values a field could possibly be converted to,
+// it is conservative, if a bit is set the conversion may still fail, but
+// if it is not set the conversion is certain to fail
+struct lexical_class {
+    constexpr static uint8_t none = 0;
+    constexpr static uint8_t integer = 1 << 0;
+    constexpr static uint8_t floating_point = 1 << 1;
+    constexpr static uint8_t boolean = 1 << 2;
+    constexpr static uint8_t character = 1 << 3;
+    constexpr static uint8_t any = 0xff;
+};
+
+// classifies the field in a single pass over the raw characters
+inline uint8_t lexical_classify(const char* const begin,
+                                const char* const end) {
+    size_t size = end - begin;
+    if (size == 0) {
+#ifdef SSP_DISABLE_FAST_FLOAT
+        // strtod accepts empty input
+        return lexical_class::floating_point;
+#else
+        return lexical_class::none;
+#endif
+    }
+
+    uint8_t ret = lexical_class::none;
+
+    if (size == 1) {
+        ret |= lexical_class::character;
+        if (*begin == '0' || *begin == '1') {
+            ret |= lexical_class::boolean;
+        }
+    } else if ((size == 4 && strncmp(begin, "true", size) == 0) ||
+               (size == 5 && strncmp(begin, "false", size) == 0)) {
+        ret |= lexical_class::boolean;
+    }
+
+    const char* curr = (*begin == '-') ? begin + 1 : begin;
+    if (curr != end) {
+        const char* digit = curr;
+        while (digit != end && *digit >= '0' && *digit <= '9') {
+            ++digit;
+        }
+
+        if (digit == end) {
+            return ret | lexical_class::integer | lexical_class::floating_point;
+        }
+    }
+
+    // the floating point conversions also accept a sign, a leading dot,
+    // exponents and special values like 'inf' and 'nan'
+    curr = (*begin == '-' || *begin == '+') ? begin + 1 : begin;
+    if (curr != end) {
+        switch (*curr) {
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case '.':
+        case 'i':
+        case 'I':
+        case 'n':
+        case 'N':
+            ret |= lexical_class::floating_point;
+            break;
+        default:
+            break;
+        }
+    }
+
+#ifdef SSP_DISABLE_FAST_FLOAT
+    // strtod skips leading whitespace
+    if (std::isspace(static_cast<unsigned char>(*begin))) {
+        ret |= lexical_class::floating_point;
+    }
+#endif
+
+    return ret;
+}
+
+// the kinds of fields the conversion for the given type may accept
+template <typename T>
+constexpr uint8_t lexical_mask() {
+    if constexpr (std::is_same_v<T, bool>) {
+        return lexical_class::boolean;
+    } else if constexpr (std::is_same_v<T, char>) {
+        return lexical_class::character;
+    } else if constexpr (std::is_integral_v<T>) {
+        return lexical_class::integer;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return lexical_class::floating_point;
+    } else {
+        return lexical_class::any;
+    }
+}
+
+template <typename T, size_t... Is>
+constexpr bool variant_needs_classification(std::index_sequence<Is...>) {
+    return ((lexical_mask<std::variant_alternative_t<Is, T>>() !=
+             lexical_class::any) ||
+            ...);
+}
+
+// the alternatives are tried in order, but the ones which cannot accept
+// the classified field are skipped without being constructed
 template <typename T, size_t I>
-bool extract_variant(const char* begin, const char* end, T& value) {
+bool extract_variant(const char* begin, const char* end, T& value,
+                     uint8_t lexical = lexical_class::any) {
     using IthType = std::variant_alternative_t<I, std::decay_t<T>>;
-    IthType ithValue;
-    if (extract<IthType>(begin, end, ithValue)) {
-        value = ithValue;
-        return true;
-    } else if constexpr (I + 1 < std::variant_size_v<T>) {
-        return extract_variant<T, I + 1>(begin, end, value);
+    constexpr auto mask = lexical_mask<IthType>();
+    if (mask == lexical_class::any || (mask & lexical)) {
+        IthType ithValue;
+        if (extract<IthType>(begin, end, ithValue)) {
+            value.template emplace<I>(std::move(ithValue));
+            return true;
+        }
+    }
+
+    if constexpr (I + 1 < std::variant_size_v<T>) {
+        return extract_variant<T, I + 1>(begin, end, value, lexical);
     }
     return false;
 }
@@ -146,9 +270,173 @@ bool extract_variant(const char* begin, const char* end, T& value) {
 template <typename T>
 std::enable_if_t<is_instance_of_v<std::variant, T>, bool> extract(
     const char* begin, const char* end, T& value) {
-    return extract_variant<T, 0>(begin, end, value);
+    constexpr auto size = std::variant_size_v<T>;
+    if constexpr (variant_needs_classification<T>(
+                      std::make_index_sequence<size>{})) {
+        return extract_variant<T, 0>(begin, end, value,
+                                     lexical_classify(begin, end));
+    } else {
+        return extract_variant<T, 0>(begin, end, value);
+    }
 }
 
+////////////////
+// enum map
+////////////////
+
+// maps a token to an enum value, the token is given as a pointer to a
+// null terminated constant array with static storage duration
+template <auto Token, auto Value>
+struct enum_code {
+    constexpr static const char* token = Token;
+    constexpr static auto value = Value;
+
+    static_assert(std::is_same_v<decltype(Token), const char*>,
+                  "enum code tokens need to be given as constant char arrays");
+};
+
+// conversion type which converts tokens directly into enum values, the
+// lookup is done using a perfect hash table generated at compile time, eg:
+//     constexpr char circle[] = "circle";
+//     constexpr char square[] = "square";
+//     using shape_map = ss::enum_map<shape, ss::enum_code<circle,
+//     shape::circle>, ss::enum_code<square, shape::square>>;
+//     auto [s, x] = c.convert<shape_map, double>("circle,10");
+template <typename E, typename... Codes>
+class enum_map {
+    static_assert(std::is_enum_v<E>, "enum map needs to be used with an enum");
+    static_assert(sizeof...(Codes) > 0, "enum map needs at least one code");
+    static_assert(
+        (std::is_same_v<std::decay_t<decltype(Codes::value)>, E> && ...),
+        "enum code values need to be of the mapped enum type");
+
+    constexpr static size_t codes_size = sizeof...(Codes);
+
+    constexpr static size_t make_table_size() {
+        size_t size = 1;
+        while (size < 2 * codes_size) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    constexpr static size_t table_size = make_table_size();
+
+    constexpr static std::array<const char*, codes_size> tokens{
+        Codes::token...};
+    constexpr static std::array<size_t, codes_size> sizes{
+        std::char_traits<char>::length(Codes::token)...};
+    constexpr static std::array<E, codes_size> values{Codes::value...};
+
+    constexpr static uint64_t hash(const char* const begin, size_t size,
+                                   uint64_t seed) {
+        uint64_t h = seed ^ size;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= static_cast<unsigned char>(begin[i]);
+            h *= 1099511628211ull;
+        }
+        return h ^ (h >> 29);
+    }
+
+    constexpr static bool has_duplicates() {
+        for (size_t i = 0; i < codes_size; ++i) {
+            for (size_t j = i + 1; j < codes_size; ++j) {
+                if (sizes[i] != sizes[j]) {
+                    continue;
+                }
+
+                size_t k = 0;
+                while (k < sizes[i] && tokens[i][k] == tokens[j][k]) {
+                    ++k;
+                }
+
+                if (k == sizes[i]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // searches for a seed which maps all tokens into different slots,
+    // zero is returned if no seed was found
+    constexpr static uint64_t find_seed() {
+        for (uint64_t seed = 14695981039346656037ull, i = 0; i < 4096;
+             ++i, seed += 0x9e3779b97f4a7c15ull) {
+            std::array<bool, table_size> used{};
+            bool collision = false;
+            for (size_t j = 0; j < codes_size && !collision; ++j) {
+                auto slot = hash(tokens[j], sizes[j], seed) & (table_size - 1);
+                collision = used[slot];
+                used[slot] = true;
+            }
+
+            if (!collision) {
+                return seed;
+            }
+        }
+        return 0;
+    }
+
+    static_assert(!has_duplicates(), "enum map contains duplicate tokens");
+
+    constexpr static uint64_t seed = find_seed();
+    static_assert(seed != 0, "could not generate enum map hash table");
+
+    // slot values are indexes of the codes increased by one, zero if empty
+    constexpr static std::array<size_t, table_size> make_slots() {
+        std::array<size_t, table_size> slots{};
+        for (size_t i = 0; i < codes_size; ++i) {
+            slots[hash(tokens[i], sizes[i], seed) & (table_size - 1)] = i + 1;
+        }
+        return slots;
+    }
+
+    constexpr static std::array<size_t, table_size> slots = make_slots();
+
+public:
+    using value_type = E;
+
+    enum_map() = default;
+
+    // allows the map to be used within restrictions, eg:
+    // ss::nx<shape_map, shape::circle>
+    enum_map(E value) : value_{value} {
+    }
+
+    operator E() const {
+        return value_;
+    }
+
+    friend bool operator==(const enum_map& lhs, E rhs) {
+        return lhs.value_ == rhs;
+    }
+
+    friend bool operator!=(const enum_map& lhs, E rhs) {
+        return lhs.value_ != rhs;
+    }
+
+    static bool ss_extract(const char* begin, const char* end, E& value) {
+        size_t size = end - begin;
+        auto slot = slots[hash(begin, size, seed) & (table_size - 1)];
+        if (slot == 0) {
+            return false;
+        }
+
+        --slot;
+        if (sizes[slot] != size ||
+            std::memcmp(begin, tokens[slot], size) != 0) {
+            return false;
+        }
+
+        value = values[slot];
+        return true;
+    }
+
+private:
+    E value_{};
+};
+
 ////////////////
 // extract specialization
 ////////////////
@@ -185,7 +473,7 @@ inline bool extract(const char* begin, const char* end, char& value) {
 
 template <>
 inline bool extract(const char* begin, const char* end, std::string& value) {
-    value = std::string{begin, end};
+    value.assign(begin, end);
     return true;
 }
 
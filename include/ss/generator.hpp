@@ -0,0 +1,170 @@
+#pragma once
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine) &&                \
+    defined(__has_include)
+#if __has_include(<coroutine>)
+#define SSP_HAS_COROUTINES
+#endif
+#endif
+
+#ifdef SSP_HAS_COROUTINES
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace ss {
+
+////////////////
+// generator
+////////////////
+
+// coroutine which yields references to values it owns, similar to
+// std::generator<T&>, available only if coroutines are supported, the
+// generator can be iterated over, or driven manually using 'next' and
+// 'value', eg. by a scheduler which interleaves multiple inputs
+template <typename T>
+class generator {
+public:
+    struct promise_type {
+        generator get_return_object() {
+            return generator{handle::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always yield_value(T& value) noexcept {
+            value_ = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept {
+        }
+
+        void unhandled_exception() {
+            exception_ = std::current_exception();
+        }
+
+        T* value_{nullptr};
+        std::exception_ptr exception_;
+    };
+
+    using handle = std::coroutine_handle<promise_type>;
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator() = default;
+
+        explicit iterator(generator* generator) : generator_{generator} {
+        }
+
+        iterator& operator++() {
+            generator_->next();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        T& operator*() const {
+            return generator_->value();
+        }
+
+        T* operator->() const {
+            return &generator_->value();
+        }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return it.generator_ == nullptr || it.generator_->done();
+        }
+
+    private:
+        generator* generator_{nullptr};
+    };
+
+    generator(generator&& other) noexcept
+        : handle_{std::exchange(other.handle_, nullptr)} {
+    }
+
+    generator& operator=(generator&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    generator(const generator& other) = delete;
+    generator& operator=(const generator& other) = delete;
+
+    ~generator() {
+        destroy();
+    }
+
+    // resumes the coroutine until the next value is yielded, returns false
+    // if there are no more values, rethrows exceptions from the coroutine
+    bool next() {
+        if (done()) {
+            return false;
+        }
+
+        handle_.resume();
+        if (auto exception = handle_.promise().exception_) {
+            handle_.promise().exception_ = nullptr;
+            std::rethrow_exception(exception);
+        }
+        return !handle_.done();
+    }
+
+    // the last yielded value, valid until 'next' is called
+    T& value() const {
+        return *handle_.promise().value_;
+    }
+
+    bool done() const {
+        return !handle_ || handle_.done();
+    }
+
+    iterator begin() {
+        next();
+        return iterator{this};
+    }
+
+    std::default_sentinel_t end() const {
+        return {};
+    }
+
+private:
+    explicit generator(handle handle) : handle_{handle} {
+    }
+
+    void destroy() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    handle handle_{nullptr};
+};
+
+} /* ss */
+#endif
@@ -0,0 +1,195 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// polymorphic memory resources are not available in older standard
+// libraries, eg. libstdc++ of gcc 8
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define SSP_HAS_PMR 1
+#endif
+#endif
+
+namespace ss {
+
+////////////////
+// memory resource
+////////////////
+
+#ifdef SSP_HAS_PMR
+using memory_resource = std::pmr::memory_resource;
+
+template <typename T>
+using resource_allocator = std::pmr::polymorphic_allocator<T>;
+
+inline memory_resource* default_memory_resource() {
+    return std::pmr::get_default_resource();
+}
+#else
+// only declared, the 'use_pmr' setup option cannot be used
+class memory_resource;
+
+template <typename T>
+using resource_allocator = std::allocator<T>;
+
+inline memory_resource* default_memory_resource() {
+    return nullptr;
+}
+#endif
+
+// containers which allocate using the memory resource given to the parser,
+// the converter or the splitter if 'Pmr' is true, the default allocator is
+// used otherwise
+template <bool Pmr, typename T>
+using allocator_t =
+    std::conditional_t<Pmr, resource_allocator<T>, std::allocator<T>>;
+
+template <bool Pmr, typename T>
+using vector_t = std::vector<T, allocator_t<Pmr, T>>;
+
+template <bool Pmr>
+using string_t =
+    std::basic_string<char, std::char_traits<char>, allocator_t<Pmr, char>>;
+
+// fixed size replacement of split_data used if the 'max_columns' setup
+// option is defined, the splitter stops before the capacity is exceeded
+template <size_t N>
+class inline_split_data {
+public:
+    using value_type = string_range;
+    using iterator = string_range*;
+    using const_iterator = const string_range*;
+
+    template <typename Begin, typename End>
+    void emplace_back(Begin begin, End end) {
+        assert(size_ < N);
+        data_[size_++] = string_range{begin, end};
+    }
+
+    void pop_back() {
+        --size_;
+    }
+
+    void clear() {
+        size_ = 0;
+    }
+
+    void reserve(size_t) {
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    constexpr static size_t capacity() {
+        return N;
+    }
+
+    string_range& operator[](size_t i) {
+        return data_[i];
+    }
+
+    const string_range& operator[](size_t i) const {
+        return data_[i];
+    }
+
+    iterator begin() {
+        return data_.data();
+    }
+
+    iterator end() {
+        return data_.data() + size_;
+    }
+
+    const_iterator begin() const {
+        return data_.data();
+    }
+
+    const_iterator end() const {
+        return data_.data() + size_;
+    }
+
+private:
+    std::array<string_range, N> data_;
+    size_t size_{0};
+};
+
+template <bool Pmr>
+allocator_t<Pmr, char> make_allocator(memory_resource* resource) {
+    if constexpr (Pmr) {
+        return resource_allocator<char>{resource};
+    } else {
+        (void)resource;
+        return {};
+    }
+}
+
+#ifdef SSP_HAS_PMR
+// the same as get_line, but the buffer is allocated using the memory
+// resource, 'n' needs to be the exact size of the buffer since it is
+// needed to deallocate it
+inline ssize_t get_line(char** lineptr, size_t* n, FILE* stream,
+                        memory_resource* resource) {
+#if __unix__
+    // the stream is locked once per line instead of once per character,
+    // the allocation may throw
+    struct stream_lock {
+        stream_lock(FILE* stream) : stream_{stream} {
+            flockfile(stream_);
+        }
+
+        ~stream_lock() {
+            funlockfile(stream_);
+        }
+
+        FILE* stream_;
+    } lock{stream};
+    auto next_char = [stream] { return getc_unlocked(stream); };
+#else
+    auto next_char = [stream] { return getc(stream); };
+#endif
+
+    size_t pos = 0;
+    for (int c = next_char(); c != EOF; c = next_char()) {
+        if (pos + 1 >= *n) {
+            size_t new_size = std::max<size_t>(2 * *n, 128);
+            auto new_ptr = static_cast<char*>(resource->allocate(new_size, 1));
+            if (*lineptr != nullptr) {
+                std::copy_n(*lineptr, pos, new_ptr);
+                resource->deallocate(*lineptr, *n, 1);
+            }
+            *n = new_size;
+            *lineptr = new_ptr;
+        }
+
+        (*lineptr)[pos++] = c;
+        if (c == '\n') {
+            break;
+        }
+    }
+
+    if (pos == 0) {
+        return -1;
+    }
+
+    (*lineptr)[pos] = '\0';
+    return pos;
+}
+#else
+// only declared, called only if 'use_pmr' is enabled
+ssize_t get_line(char** lineptr, size_t* n, FILE* stream,
+                 memory_resource* resource);
+#endif
+
+} /* ss */
@@ -0,0 +1,405 @@
+#pragma once
+#include "common.hpp"
+#include "error.hpp"
+#include "exception.hpp"
+#include "probe.hpp"
+#include "writer.hpp"
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __unix__
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace ss {
+
+////////////////
+// parallel writer
+////////////////
+
+// writes row blocks formatted on multiple threads into a file, each block
+// is given a sequence number, starting from 0, and the blocks are written
+// in the order of their sequence numbers by a separate thread, consecutive
+// blocks are written using a single call where supported, producers wait
+// while the submitted blocks which are not yet written exceed the limit
+template <typename... Options>
+class parallel_writer {
+    constexpr static auto string_error = setup<Options...>::string_error;
+    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
+
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
+
+    // number of blocks written with one call
+    constexpr static size_t max_batch_size = 64;
+
+public:
+    using block = row_block<Options...>;
+
+    constexpr static size_t default_max_buffered = 64 * 1024 * 1024;
+
+    parallel_writer(const std::string& file_name,
+                    const std::string& delim = ss::default_delimiter,
+                    size_t max_buffered = default_max_buffered)
+        : file_name_{file_name}, delim_{delim}, max_buffered_{max_buffered} {
+        if (!open()) {
+            handle_error_file_not_open();
+            return;
+        }
+
+        thread_ = std::thread{[this] { run(); }};
+    }
+
+    parallel_writer(parallel_writer&& other) = delete;
+    parallel_writer& operator=(parallel_writer&& other) = delete;
+    parallel_writer(const parallel_writer& other) = delete;
+    parallel_writer& operator=(const parallel_writer& other) = delete;
+
+    // the remaining blocks are written, errors are ignored
+    ~parallel_writer() {
+        stop();
+    }
+
+    bool valid() const {
+        if constexpr (string_error) {
+            return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
+        } else if constexpr (throw_on_error) {
+            return true;
+        } else {
+            return !error_;
+        }
+    }
+
+    const std::string& error_msg() const {
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = file_name_ + ": " + error_.message();
+            return error_msg_;
+        } else {
+            return error_;
+        }
+    }
+
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
+        return error_;
+    }
+
+    // returns an empty block, the memory of the written blocks is reused,
+    // can be called from any thread
+    block make_block() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (free_blocks_.empty()) {
+            return block{delim_};
+        }
+
+        block b = std::move(free_blocks_.back());
+        free_blocks_.pop_back();
+        return b;
+    }
+
+    // passes the block with the given sequence number to the writing
+    // thread, each number is to be used once, can be called from any
+    // thread, waits while the buffered blocks exceed the limit unless the
+    // block is the next one to be written, returns false if the sequence
+    // number was already used, or if writing failed, the error is reported
+    // by 'finish'
+    bool submit(size_t sequence, block&& b) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        space_.wait(lock, [&] {
+            return failed_ || stop_ || buffered_ == 0 || sequence == next_ ||
+                   buffered_ + b.size() <= max_buffered_;
+        });
+
+        if (failed_ || stop_ || !file_open()) {
+            return false;
+        }
+
+        // a block with a sequence number which was already used is not
+        // buffered, it would never be written
+        size_t size = b.size();
+        if (sequence < next_ ||
+            !pending_.emplace(sequence, std::move(b)).second) {
+            return false;
+        }
+
+        buffered_ += size;
+        if (sequence == next_) {
+            ready_.notify_one();
+        }
+        return true;
+    }
+
+    // waits until the submitted blocks are written and closes the file,
+    // all of the sequence numbers up to the last one need to be submitted,
+    // the blocks after a missing one are not written
+    void finish() {
+        if (!thread_.joinable()) {
+            return;
+        }
+
+        bool missing = stop();
+        if (failed_) {
+            handle_error_write_failed();
+        } else if (missing) {
+            handle_error_missing_block();
+        }
+    }
+
+private:
+    ////////////////
+    // writing thread
+    ////////////////
+
+    // returns true if blocks were left unwritten
+    bool stop() {
+        if (!thread_.joinable()) {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stop_ = true;
+        }
+        ready_.notify_one();
+        space_.notify_all();
+        thread_.join();
+        close();
+
+        bool missing = !pending_.empty();
+        pending_.clear();
+        return missing;
+    }
+
+    bool next_ready() const {
+        return !pending_.empty() && pending_.begin()->first == next_;
+    }
+
+    void run() {
+        std::vector<block> batch;
+        std::unique_lock<std::mutex> lock{mutex_};
+        while (true) {
+            ready_.wait(lock, [this] { return stop_ || next_ready(); });
+            if (!next_ready()) {
+                break;
+            }
+
+            while (batch.size() < max_batch_size && next_ready()) {
+                batch.push_back(std::move(pending_.begin()->second));
+                pending_.erase(pending_.begin());
+                ++next_;
+            }
+
+            // once a write fails the following blocks are not written, so
+            // the file does not continue after the lost data
+            lock.unlock();
+            bool failed = failed_ || !write(batch);
+            SSP_PROBE2(write_batch, batch.size(), batch_size(batch));
+            lock.lock();
+
+            failed_ = failed;
+            for (auto& b : batch) {
+                buffered_ -= b.size();
+                if (free_blocks_.size() < max_batch_size) {
+                    b.clear();
+                    free_blocks_.push_back(std::move(b));
+                }
+            }
+            batch.clear();
+            space_.notify_all();
+        }
+    }
+
+    static size_t batch_size(const std::vector<block>& blocks) {
+        size_t size = 0;
+        for (const auto& b : blocks) {
+            size += b.size();
+        }
+        return size;
+    }
+
+    ////////////////
+    // output
+    ////////////////
+
+#if __unix__
+    bool open() {
+        fd_ = ::open(file_name_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        return fd_ != -1;
+    }
+
+    bool file_open() const {
+        return fd_ != -1;
+    }
+
+    void close() {
+        if (fd_ != -1) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    // consecutive blocks are written using one call, partial writes are
+    // continued from where they stopped
+    bool write(const std::vector<block>& blocks) {
+        std::vector<iovec> iov;
+        iov.reserve(blocks.size());
+        for (const auto& b : blocks) {
+            if (!b.empty()) {
+                iov.push_back(iovec{const_cast<char*>(b.data()), b.size()});
+            }
+        }
+
+        size_t first = 0;
+        while (first < iov.size()) {
+            ssize_t written = ::writev(fd_, iov.data() + first,
+                                       static_cast<int>(iov.size() - first));
+            if (written < 0) {
+                // interrupted by a signal before anything was written
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+
+            size_t remaining = static_cast<size_t>(written);
+            while (first < iov.size() && remaining >= iov[first].iov_len) {
+                remaining -= iov[first++].iov_len;
+            }
+
+            if (remaining > 0) {
+                iov[first].iov_base =
+                    static_cast<char*>(iov[first].iov_base) + remaining;
+                iov[first].iov_len -= remaining;
+            }
+        }
+        return true;
+    }
+#else
+    bool open() {
+        file_ = fopen(file_name_.c_str(), "wb");
+        if (file_) {
+            setvbuf(file_, nullptr, _IONBF, 0);
+        }
+        return file_ != nullptr;
+    }
+
+    bool file_open() const {
+        return file_ != nullptr;
+    }
+
+    void close() {
+        if (file_) {
+            fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    bool write(const std::vector<block>& blocks) {
+        for (const auto& b : blocks) {
+            if (fwrite(b.data(), 1, b.size(), file_) != b.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+
+    ////////////////
+    // error
+    ////////////////
+
+    void handle_error_file_not_open() {
+        constexpr static auto error_msg = " could not be opened";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::file_not_open);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_write_failed() {
+        constexpr static auto error_msg = " write failed";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::write_failed);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_missing_block() {
+        constexpr static auto error_msg = " missing block with sequence: ";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg).append(
+                std::to_string(next_));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::missing_block);
+            error_.expected = next_;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg +
+                                std::to_string(next_)};
+        } else {
+            error_ = true;
+        }
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    std::string file_name_;
+    std::string delim_;
+    size_t max_buffered_;
+
+    error_type error_{};
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
+
+#if __unix__
+    int fd_{-1};
+#else
+    FILE* file_{nullptr};
+#endif
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable space_;
+
+    // blocks waiting for the ones before them, by sequence number
+    std::map<size_t, block> pending_;
+    std::vector<block> free_blocks_;
+    size_t next_{0};
+    size_t buffered_{0};
+    bool failed_{false};
+    bool stop_{false};
+
+    std::thread thread_;
+};
+
+} /* ss */
@@ -3,13 +3,23 @@
 // TODO add single header tests
 #include "common.hpp"
 #include "converter.hpp"
+#include "error.hpp"
 #include "exception.hpp"
 #include "extract.hpp"
+#include "generator.hpp"
+#include "memory.hpp"
+#include "probe.hpp"
+#include "reject.hpp"
 #include "restrictions.hpp"
+#include "stats.hpp"
+#include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace ss {
@@ -18,9 +28,17 @@ template <typename... Options>
 class parser {
     constexpr static auto string_error = setup<Options...>::string_error;
     constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
 
     using multiline = typename setup<Options...>::multiline;
-    using error_type = std::conditional_t<string_error, std::string, bool>;
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
+
+    using error_log = typename setup<Options...>::error_log;
+    constexpr static bool record_errors =
+        structured_error && error_log::record;
 
     constexpr static bool escaped_multiline_enabled =
         multiline::enabled && setup<Options...>::escape::enabled;
@@ -32,21 +50,44 @@ class parser {
 
     constexpr static bool ignore_empty = setup<Options...>::ignore_empty;
 
+    constexpr static bool is_const_line =
+        !setup<Options...>::quote::enabled &&
+        !setup<Options...>::escape::enabled;
+
+    constexpr static bool collect_stats = setup<Options...>::collect_stats;
+    constexpr static size_t timing_sample_rate =
+        setup<Options...>::stats::timing_sample_rate;
+
+    using max_record_size = typename setup<Options...>::max_record_size;
+    using max_columns = typename setup<Options...>::max_columns;
+    constexpr static bool shrink_buffers = setup<Options...>::shrink_buffers;
+    constexpr static bool estimate_record_size =
+        shrink_buffers || collect_stats;
+
+    constexpr static bool use_pmr = setup<Options...>::use_pmr;
+
 public:
+    using reject_sink = std::function<void(const ss::rejected_record&)>;
+
     parser(const std::string& file_name,
            const std::string& delim = ss::default_delimiter)
-        : file_name_{file_name}, reader_{file_name_, delim} {
-        if (reader_.file_) {
-            read_line();
-            if constexpr (ignore_header) {
-                ignore_next();
-            } else {
-                raw_header_ = reader_.get_buffer();
-            }
-        } else {
-            handle_error_file_not_open();
-            eof_ = true;
-        }
+        : file_name_{file_name},
+          reader_{file_name_, delim, ss::default_memory_resource()} {
+        open();
+    }
+
+    // the line buffers, the split data, the raw records and the header are
+    // allocated using the memory resource, requires the 'use_pmr' setup
+    // option
+    parser(const std::string& file_name, const std::string& delim,
+           ss::memory_resource* resource)
+        : file_name_{file_name}, reader_{file_name_, delim, resource},
+          header_(make_allocator<use_pmr>(resource)),
+          header_slots_(make_allocator<use_pmr>(resource)),
+          raw_header_(make_allocator<use_pmr>(resource)) {
+        static_assert(use_pmr, "use_pmr needs to be enabled to use a memory "
+                               "resource");
+        open();
     }
 
     parser(parser&& other) = default;
@@ -59,6 +100,8 @@ public:
     bool valid() const {
         if constexpr (string_error) {
             return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
         } else if constexpr (throw_on_error) {
             return true;
         } else {
@@ -67,10 +110,52 @@ public:
     }
 
     const std::string& error_msg() const {
-        assert_string_error_defined<string_error>();
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = file_name_;
+            if (error_.line != 0) {
+                error_msg_.append(" ").append(std::to_string(error_.line));
+            }
+            error_msg_.append(": ").append(error_.message());
+            return error_msg_;
+        } else {
+            return error_;
+        }
+    }
+
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
         return error_;
     }
 
+    // errors recorded according to the 'structured_error_log' setup option,
+    // the raw ranges of the recorded errors are not kept
+    const std::vector<ss::error_info>& recorded_errors() const {
+        static_assert(record_errors,
+                      "structured_error_log needs to be enabled to use this "
+                      "method");
+        return recorded_errors_;
+    }
+
+    // number of errors which occurred, including the ones not recorded
+    size_t error_count() const {
+        assert_structured_error_defined<structured_error>();
+        return error_count_;
+    }
+
+    // counters collected since the parser was created, enabled using the
+    // 'collect_stats' setup option
+    ss::parser_stats stats() const {
+        static_assert(collect_stats,
+                      "collect_stats needs to be enabled to use this method");
+        ss::parser_stats ret = reader_.stats_;
+        ret.bytes_read = reader_.bytes_read_;
+        ret.record_size_percentile = reader_.record_size_estimate_;
+        ret += reader_.converter_->stats();
+        ret += reader_.next_line_converter_->stats();
+        return ret;
+    }
+
     bool eof() const {
         return eof_;
     }
@@ -81,7 +166,13 @@ public:
 
     template <typename T, typename... Ts>
     T get_object() {
-        return to_object<T>(get_next<Ts...>());
+        if constexpr (std::is_default_constructible_v<T>) {
+            return read_and_convert<false>(selected_columns_v<Ts...>, [this] {
+                return reader_.converter_->template convert_object<T, Ts...>();
+            });
+        } else {
+            return to_object<T>(get_next_impl<false, Ts...>());
+        }
     }
 
     size_t line() const {
@@ -91,54 +182,30 @@ public:
 
     template <typename T, typename... Ts>
     no_void_validator_tup_t<T, Ts...> get_next() {
-        std::optional<std::string> error;
-
-        if (!eof_) {
-            if constexpr (throw_on_error) {
-                try {
-                    reader_.parse();
-                } catch (const ss::exception& e) {
-                    read_line();
-                    decorate_rethrow(e);
-                }
-            } else {
-                reader_.parse();
-            }
-        }
-
-        reader_.update();
-        if (!reader_.converter_.valid()) {
-            handle_error_invalid_conversion();
-            read_line();
-            return {};
-        }
-
-        clear_error();
-
-        if (eof_) {
-            handle_error_eof_reached();
-            return {};
-        }
-
-        if constexpr (throw_on_error) {
-            try {
-                auto value = reader_.converter_.template convert<T, Ts...>();
-                read_line();
-                return value;
-            } catch (const ss::exception& e) {
-                read_line();
-                decorate_rethrow(e);
-            }
-        }
-
-        auto value = reader_.converter_.template convert<T, Ts...>();
+        return get_next_impl<false, T, Ts...>();
+    }
 
-        if (!reader_.converter_.valid()) {
-            handle_error_invalid_conversion();
-        }
+    // converts up to 'n' lines into 'out', reusing its storage, the
+    // validity of each line is stored into 'valid', returns the number of
+    // lines read, both vectors are resized to that number
+    template <typename T, typename... Ts>
+    size_t get_batch(std::vector<no_void_validator_tup_t<T, Ts...>>& out,
+                     std::vector<bool>& valid, size_t n) {
+        constexpr size_t columns = selected_columns_v<T, Ts...>;
+        return get_batch_impl(out, valid, n, columns, [this](auto& dst) {
+            reader_.converter_->template convert_into<T, Ts...>(dst);
+        });
+    }
 
-        read_line();
-        return value;
+    // same as get_batch, but converts into 'T' objects, tied classes are
+    // filled in place
+    template <typename T, typename... Ts>
+    size_t get_object_batch(std::vector<T>& out, std::vector<bool>& valid,
+                            size_t n) {
+        constexpr size_t columns = selected_columns_v<Ts...>;
+        return get_batch_impl(out, valid, n, columns, [this](auto& dst) {
+            reader_.converter_->template convert_object_into<T, Ts...>(dst);
+        });
     }
 
     bool field_exists(const std::string& field) {
@@ -151,51 +218,75 @@ public:
 
     template <typename... Ts>
     void use_fields(const Ts&... fields_args) {
-        if constexpr (ignore_header) {
-            handle_error_header_ignored();
+        auto column_mappings =
+            header_columns(std::vector<std::string>{fields_args...});
+        if (!column_mappings) {
             return;
         }
 
-        if (header_.empty()) {
-            split_header_data();
-        }
+        reader_.converter_->set_column_mapping(*column_mappings,
+                                               header_.size());
+        reader_.next_line_converter_->set_column_mapping(*column_mappings,
+                                                         header_.size());
 
-        if (!valid()) {
-            return;
+        if (line() == 1) {
+            ignore_next();
         }
+    }
 
-        auto fields = std::vector<std::string>{fields_args...};
-
-        if (fields.empty()) {
-            handle_error_empty_mapping();
-            return;
+    // resolves the given fields into a plan which can be used to convert
+    // the lines of this parser, or of any other file with the same header,
+    // the plan is invalid if the fields could not be resolved
+    template <typename... Ts, typename... Fields>
+    ss::plan<Ts...> make_plan(const Fields&... fields_args) {
+        static_assert(sizeof...(Ts) == sizeof...(Fields),
+                      "number of fields does not match the number of types");
+
+        auto column_mappings =
+            header_columns(std::vector<std::string>{fields_args...});
+        if (!column_mappings) {
+            return {};
         }
 
-        std::vector<size_t> column_mappings;
+        std::array<size_t, sizeof...(Ts)> columns;
+        std::copy(column_mappings->begin(), column_mappings->end(),
+                  columns.begin());
 
-        for (const auto& field : fields) {
-            if (std::count(fields.begin(), fields.end(), field) != 1) {
-                handle_error_field_used_multiple_times(field);
-                return;
-            }
+        if (line() == 1) {
+            ignore_next();
+        }
 
-            auto index = header_index(field);
+        return ss::plan<Ts...>{columns, header_.size()};
+    }
 
-            if (!index) {
-                handle_error_invalid_field(field);
-                return;
-            }
+    // converts the next line using the given plan, ignoring the mapping
+    // set by use_fields
+    template <typename... Ts>
+    no_void_validator_tup_t<Ts...> get_next(const ss::plan<Ts...>& plan) {
+        return read_and_convert<false>(0, [this, &plan] {
+            return reader_.converter_->convert(plan);
+        });
+    }
 
-            column_mappings.push_back(*index);
-        }
+    template <typename T, typename... Ts>
+    T get_object(const ss::plan<Ts...>& plan) {
+        return to_object<T>(get_next(plan));
+    }
 
-        reader_.converter_.set_column_mapping(column_mappings, header_.size());
-        reader_.next_line_converter_.set_column_mapping(column_mappings,
-                                                        header_.size());
+    // records which fail to be read or converted by get_next, get_object or
+    // the iterators are passed to the sink before the next line is read,
+    // passing an empty sink disables it
+    void set_reject_sink(reject_sink sink) {
+        reject_sink_ = std::move(sink);
+        reader_.capture_raw_ = static_cast<bool>(reject_sink_);
+    }
 
-        if (line() == 1) {
-            ignore_next();
-        }
+    // extracted std::string_view values will be copied into the given
+    // arena, so they stay valid after the next line is read, as long
+    // as the arena is not cleared, passing nullptr disables the copying
+    void use_arena(ss::arena* arena) {
+        reader_.converter_->use_arena(arena);
+        reader_.next_line_converter_->use_arena(arena);
     }
 
     ////////////////
@@ -284,6 +375,40 @@ public:
         return iterable<true, Ts...>{this};
     }
 
+#ifdef SSP_HAS_COROUTINES
+    ////////////////
+    // generator
+    ////////////////
+
+    // yields a reference to the same row object for each line, which is
+    // converted in place, the validity of the row can be checked using
+    // the valid method, the parser needs to outlive the generator
+    template <typename T, typename... Ts>
+    ss::generator<no_void_validator_tup_t<T, Ts...>> rows() {
+        no_void_validator_tup_t<T, Ts...> row{};
+        while (!eof_) {
+            read_and_convert<false>(selected_columns_v<T, Ts...>, [&] {
+                reader_.converter_->template convert_into<T, Ts...>(row);
+                return true;
+            });
+            co_yield row;
+        }
+    }
+
+    // same as rows, but yields a 'T' object
+    template <typename T, typename... Ts>
+    ss::generator<T> object_rows() {
+        T row{};
+        while (!eof_) {
+            read_and_convert<false>(selected_columns_v<Ts...>, [&] {
+                reader_.converter_->template convert_object_into<T, Ts...>(row);
+                return true;
+            });
+            co_yield row;
+        }
+    }
+#endif
+
     ////////////////
     // composite conversion
     ////////////////
@@ -329,7 +454,7 @@ public:
                 if constexpr (std::is_invocable_v<Fun>) {
                     fun();
                 } else {
-                    static_assert(string_error,
+                    static_assert(string_error || structured_error,
                                   "to enable error messages within the "
                                   "on_error method "
                                   "callback string_error needs to be enabled");
@@ -372,8 +497,8 @@ public:
         no_void_validator_tup_t<U, Us...> try_same() {
             parser_.clear_error();
             auto value =
-                parser_.reader_.converter_.template convert<U, Us...>();
-            if (!parser_.reader_.converter_.valid()) {
+                parser_.reader_.converter_->template convert<U, Us...>();
+            if (!parser_.reader_.converter_->valid()) {
                 parser_.handle_error_invalid_conversion();
             }
             return value;
@@ -394,8 +519,8 @@ public:
         Fun&& fun = none{}) {
         assert_throw_on_error_not_defined<throw_on_error>();
         using Ret = no_void_validator_tup_t<Ts...>;
-        return try_invoke_and_make_composite<
-            std::optional<Ret>>(get_next<Ts...>(), std::forward<Fun>(fun));
+        return try_invoke_and_make_composite<std::optional<Ret>>(
+            get_next_impl<true, Ts...>(), std::forward<Fun>(fun));
     }
 
     // identical to try_next but returns composite with object instead of a
@@ -403,11 +528,148 @@ public:
     template <typename T, typename... Ts, typename Fun = none>
     composite<std::optional<T>> try_object(Fun&& fun = none{}) {
         assert_throw_on_error_not_defined<throw_on_error>();
-        return try_invoke_and_make_composite<
-            std::optional<T>>(get_object<T, Ts...>(), std::forward<Fun>(fun));
+        return try_invoke_and_make_composite<std::optional<T>>(
+            to_object<T>(get_next_impl<true, Ts...>()),
+            std::forward<Fun>(fun));
     }
 
 private:
+    // composite conversions do not use the reject sink since the record
+    // may still be converted by one of the alternatives, for the same
+    // reason the whole line is split even if columns are selected
+    template <bool Composite, typename T, typename... Ts>
+    no_void_validator_tup_t<T, Ts...> get_next_impl() {
+        constexpr size_t columns =
+            Composite ? 0 : selected_columns_v<T, Ts...>;
+
+        return read_and_convert<Composite>(columns, [this] {
+            return reader_.converter_->template convert<T, Ts...>();
+        });
+    }
+
+    // reads the next line splitting up to 'columns' columns (all if 0) and
+    // converts it using the given function
+    template <bool Composite, typename Convert>
+    auto read_and_convert(size_t columns, Convert&& convert)
+        -> decltype(convert()) {
+        constexpr bool Reject = !Composite;
+
+        if (!eof_) {
+            SSP_PROBE1(record_start, reader_.line_number_);
+            if constexpr (throw_on_error) {
+                try {
+                    reader_.parse(columns);
+                } catch (const ss::exception& e) {
+                    reader_.update();
+                    reject_if_enabled<Reject>();
+                    finish_record(false);
+                    decorate_rethrow(e);
+                }
+            } else {
+                reader_.parse(columns);
+            }
+        }
+
+        reader_.update();
+        if (!reader_.converter_->valid()) {
+            handle_error_invalid_conversion();
+            reject_if_enabled<Reject>();
+            finish_record(false);
+            return {};
+        }
+
+        clear_error();
+
+        if (eof_) {
+            handle_error_eof_reached();
+            return {};
+        }
+
+        // the alternatives of a composite reuse the extracted values
+        reader_.converter_->memoize(Composite);
+
+        if constexpr (throw_on_error) {
+            try {
+                auto value = reader_.timed(&parser_stats::convert_ticks,
+                                           convert);
+                finish_record(true);
+                return value;
+            } catch (const ss::exception& e) {
+                reject_if_enabled<Reject>();
+                finish_record(false);
+                decorate_rethrow(e);
+            }
+        }
+
+        auto value = reader_.timed(&parser_stats::convert_ticks, convert);
+
+        if (!reader_.converter_->valid()) {
+            handle_error_invalid_conversion();
+            reject_if_enabled<Reject>();
+        }
+
+        finish_record(reader_.converter_->valid());
+        return value;
+    }
+
+    // the next line is read once the current record is done
+    void finish_record(bool valid) {
+        if (!valid) {
+            SSP_PROBE2(conversion_error, reader_.line_number_,
+                       static_cast<int>(probed_error_code()));
+        }
+        SSP_PROBE2(record_end, reader_.line_number_, valid);
+        read_line();
+    }
+
+    error_code probed_error_code() const {
+        if constexpr (structured_error) {
+            return error_.code;
+        } else {
+            return error_code::invalid_conversion;
+        }
+    }
+
+    template <typename T, typename ConvertInto>
+    size_t get_batch_impl(std::vector<T>& out, std::vector<bool>& valid,
+                          size_t n, size_t columns,
+                          ConvertInto&& convert_into) {
+        if (out.size() < n) {
+            out.resize(n);
+        }
+        valid.resize(n);
+
+        size_t size = 0;
+        for (; size < n && !eof_; ++size) {
+            auto& dst = out[size];
+            // the returned value only tells if the line was converted
+            read_and_convert<false>(columns, [&] {
+                convert_into(dst);
+                return true;
+            });
+            valid[size] = this->valid();
+        }
+
+        out.resize(size);
+        valid.resize(size);
+        SSP_PROBE1(batch_complete, size);
+        return size;
+    }
+
+    template <bool Reject>
+    void reject_if_enabled() {
+        if constexpr (Reject) {
+            if (reject_sink_) {
+                error_code code = error_code::invalid_conversion;
+                if constexpr (structured_error) {
+                    code = error_.code;
+                }
+                reject_sink_(rejected_record{reader_.line_number_,
+                                             reader_.get_raw(), code});
+            }
+        }
+    }
+
     // tries to invoke the given function (see below), if the function
     // returns a value which can be used as a conditional, and it returns
     // false, the function sets an error, and allows the invoke of the
@@ -462,30 +724,125 @@ private:
     // header
     ////////////////
 
+    // the fields are indexed using an open addressing hash table with
+    // linear probing, the slots contain the index of the field + 1, or 0
+    // if empty
     void split_header_data() {
-        ss::splitter<Options...> splitter;
-        std::string raw_header_copy = raw_header_;
+        auto splitter =
+            make_with_resource<ss::splitter<Options...>>(reader_.resource_);
+        string_t<use_pmr> raw_header_copy{
+            raw_header_, make_allocator<use_pmr>(reader_.resource_)};
         splitter.split(raw_header_copy.data(), reader_.delim_);
-        for (const auto& [begin, end] : splitter.split_data_) {
-            std::string field{begin, end};
-            if (std::find(header_.begin(), header_.end(), field) !=
-                header_.end()) {
-                handle_error_invalid_header(field);
+
+        // the header is not truncated if it is wider than 'max_columns'
+        if constexpr (max_columns::enabled) {
+            if (!splitter.valid() &&
+                splitter.split_data_.size() == max_columns::size) {
+                handle_error_header_too_wide();
+                return;
+            }
+        }
+
+        const auto& split_data = splitter.split_data_;
+        size_t slots_size = 1;
+        while (slots_size < 2 * split_data.size()) {
+            slots_size *= 2;
+        }
+
+        header_.reserve(split_data.size());
+        header_slots_.assign(slots_size, 0);
+
+        for (const auto& [begin, end] : split_data) {
+            std::string_view field{begin, static_cast<size_t>(end - begin)};
+            size_t& slot = header_slot(field);
+            if (slot != 0) {
+                handle_error_invalid_header(std::string{field});
                 header_.clear();
+                header_slots_.clear();
                 return;
             }
-            header_.push_back(std::move(field));
+
+            header_.emplace_back(field);
+            slot = header_.size();
         }
+
+        // the rows are expected to have as many columns as the header
+        reader_.converter_->splitter_.split_data_.reserve(header_.size());
+        reader_.next_line_converter_->splitter_.split_data_.reserve(
+            header_.size());
+    }
+
+    size_t& header_slot(std::string_view field) {
+        size_t mask = header_slots_.size() - 1;
+        size_t i = std::hash<std::string_view>{}(field) & mask;
+        while (header_slots_[i] != 0 &&
+               header_[header_slots_[i] - 1] != field) {
+            i = (i + 1) & mask;
+        }
+        return header_slots_[i];
+    }
+
+    std::optional<std::vector<size_t>> header_columns(
+        const std::vector<std::string>& fields) {
+        if constexpr (ignore_header) {
+            handle_error_header_ignored();
+            return std::nullopt;
+        }
+
+        if (header_.empty()) {
+            split_header_data();
+        }
+
+        if (!valid()) {
+            return std::nullopt;
+        }
+
+        if (fields.empty()) {
+            handle_error_empty_mapping();
+            return std::nullopt;
+        }
+
+        std::vector<size_t> column_mappings;
+        column_mappings.reserve(fields.size());
+
+        // the fields are sorted to find the repeated ones, which are
+        // reported before the ones missing from the header
+        std::vector<std::string_view> sorted_fields{fields.begin(),
+                                                    fields.end()};
+        std::sort(sorted_fields.begin(), sorted_fields.end());
+
+        for (const auto& field : fields) {
+            auto [first, last] = std::equal_range(sorted_fields.begin(),
+                                                  sorted_fields.end(), field);
+            if (last - first != 1) {
+                handle_error_field_used_multiple_times(field);
+                return std::nullopt;
+            }
+
+            auto index = header_index(field);
+
+            if (!index) {
+                handle_error_invalid_field(field);
+                return std::nullopt;
+            }
+
+            column_mappings.push_back(*index);
+        }
+
+        return column_mappings;
     }
 
     std::optional<size_t> header_index(const std::string& field) {
-        auto it = std::find(header_.begin(), header_.end(), field);
+        if (header_slots_.empty()) {
+            return std::nullopt;
+        }
 
-        if (it == header_.end()) {
+        size_t slot = header_slot(field);
+        if (slot == 0) {
             return std::nullopt;
         }
 
-        return std::distance(header_.begin(), it);
+        return slot - 1;
     }
 
     ////////////////
@@ -495,17 +852,44 @@ private:
     void clear_error() {
         if constexpr (string_error) {
             error_.clear();
+        } else if constexpr (structured_error) {
+            error_.code = error_code::none;
         } else {
             error_ = false;
         }
     }
 
+    void set_error(error_code code) {
+        error_.set(code);
+        error_.line = reader_.line_number_;
+        record_error();
+    }
+
+    void record_error() {
+        ++error_count_;
+        if constexpr (record_errors) {
+            if ((error_count_ - 1) % error_log::sample_rate != 0) {
+                return;
+            }
+
+            if (error_log::max_recorded != 0 &&
+                recorded_errors_.size() >= error_log::max_recorded) {
+                return;
+            }
+
+            recorded_errors_.push_back(error_);
+            recorded_errors_.back().raw = string_range{nullptr, nullptr};
+        }
+    }
+
     void handle_error_failed_check() {
         constexpr static auto error_msg = " failed check";
 
         if constexpr (string_error) {
             error_.clear();
             error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::failed_check);
         } else if constexpr (throw_on_error) {
             throw ss::exception{file_name_ + error_msg};
         } else {
@@ -519,6 +903,8 @@ private:
         if constexpr (string_error) {
             error_.clear();
             error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::file_not_open);
         } else if constexpr (throw_on_error) {
             throw ss::exception{file_name_ + error_msg};
         } else {
@@ -532,6 +918,8 @@ private:
         if constexpr (string_error) {
             error_.clear();
             error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::eof_reached);
         } else if constexpr (throw_on_error) {
             throw ss::exception{file_name_ + error_msg};
         } else {
@@ -546,7 +934,12 @@ private:
                 .append(" ")
                 .append(std::to_string(reader_.line_number_))
                 .append(": ")
-                .append(reader_.converter_.error_msg());
+                .append(reader_.converter_->error_msg());
+        } else if constexpr (structured_error) {
+            error_ = reader_.converter_->error_info();
+            error_.line = reader_.line_number_;
+            error_.offset += reader_.line_offset_;
+            record_error();
         } else if constexpr (!throw_on_error) {
             error_ = true;
         }
@@ -559,6 +952,8 @@ private:
         if constexpr (string_error) {
             error_.clear();
             error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::header_ignored);
         } else if constexpr (throw_on_error) {
             throw ss::exception{file_name_ + error_msg};
         } else {
@@ -573,6 +968,8 @@ private:
         if constexpr (string_error) {
             error_.clear();
             error_.append(file_name_).append(error_msg).append(field);
+        } else if constexpr (structured_error) {
+            set_error(error_code::invalid_field);
         } else if constexpr (throw_on_error) {
             throw ss::exception{file_name_ + error_msg + field};
         } else {
@@ -586,6 +983,8 @@ private:
         if constexpr (string_error) {
             error_.clear();
             error_.append(file_name_).append(error_msg).append(field);
+        } else if constexpr (structured_error) {
+            set_error(error_code::field_used_multiple_times);
         } else if constexpr (throw_on_error) {
             throw ss::exception{file_name_ + error_msg + field};
         } else {
@@ -599,6 +998,8 @@ private:
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::empty_mapping);
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg};
         } else {
@@ -611,7 +1012,9 @@ private:
 
         if constexpr (string_error) {
             error_.clear();
-            error_.append(error_msg).append(error_msg);
+            error_.append(error_msg).append(field);
+        } else if constexpr (structured_error) {
+            set_error(error_code::invalid_header);
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg + field};
         } else {
@@ -619,6 +1022,25 @@ private:
         }
     }
 
+    void handle_error_header_too_wide() {
+        constexpr static auto error_msg =
+            ": header has too many columns, limit: ";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg).append(
+                std::to_string(max_columns::size));
+        } else if constexpr (structured_error) {
+            set_error(error_code::too_many_columns);
+            error_.expected = max_columns::size;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg +
+                                std::to_string(max_columns::size)};
+        } else {
+            error_ = true;
+        }
+    }
+
     void decorate_rethrow(const ss::exception& e) const {
         static_assert(throw_on_error,
                       "throw_on_error needs to be enabled to use this method");
@@ -633,27 +1055,70 @@ private:
     // line reading
     ////////////////
 
+    // the splitter and the converter use the memory resource only if
+    // 'use_pmr' is enabled
+    template <typename T>
+    static T make_with_resource(ss::memory_resource* resource) {
+        if constexpr (use_pmr) {
+            return T{resource};
+        } else {
+            (void)resource;
+            return T{};
+        }
+    }
+
+    void open() {
+        SSP_PROBE2(file_open, file_name_.c_str(), reader_.file_ != nullptr);
+        if (reader_.file_) {
+            read_line();
+            if constexpr (ignore_header) {
+                ignore_next();
+            } else {
+                raw_header_ = reader_.get_buffer();
+            }
+        } else {
+            handle_error_file_not_open();
+            eof_ = true;
+        }
+    }
+
     void read_line() {
-        eof_ = !reader_.read_next();
+        reader_.timed(&parser_stats::read_ticks,
+                      [this] { eof_ = !reader_.read_next(); });
     }
 
     struct reader {
-        reader(const std::string& file_name_, const std::string& delim)
-            : delim_{delim}, file_{fopen(file_name_.c_str(), "rb")} {
+        reader(const std::string& file_name_, const std::string& delim,
+               ss::memory_resource* resource)
+            : converters_{make_with_resource<converter<Options...>>(resource),
+                          make_with_resource<converter<Options...>>(resource)},
+              delim_{delim}, file_{fopen(file_name_.c_str(), "rb")},
+              raw_(make_allocator<use_pmr>(resource)),
+              next_raw_(make_allocator<use_pmr>(resource)),
+              resource_{resource} {
         }
 
         reader(reader&& other)
             : buffer_{other.buffer_},
               next_line_buffer_{other.next_line_buffer_},
-              helper_buffer_{other.helper_buffer_}, converter_{std::move(
-                                                        other.converter_)},
-              next_line_converter_{std::move(other.next_line_converter_)},
+              helper_buffer_{other.helper_buffer_},
+              converters_{std::move(other.converters_)},
               buffer_size_{other.buffer_size_},
               next_line_buffer_size_{other.next_line_buffer_size_},
               helper_size_{other.helper_size_}, delim_{std::move(other.delim_)},
               file_{other.file_}, crlf_{other.crlf_},
-              line_number_{other.line_number_}, next_line_size_{
-                                                    other.next_line_size_} {
+              line_number_{other.line_number_},
+              next_line_size_{other.next_line_size_},
+              bytes_read_{other.bytes_read_},
+              next_line_offset_{other.next_line_offset_},
+              line_offset_{other.line_offset_}, line_size_{other.line_size_},
+              capture_raw_{other.capture_raw_},
+              raw_started_{other.raw_started_}, raw_{std::move(other.raw_)},
+              next_raw_{std::move(other.next_raw_)}, stats_{other.stats_},
+              timed_{other.timed_},
+              record_size_estimate_{other.record_size_estimate_},
+              resource_{other.resource_} {
+            select_converters(other);
             other.buffer_ = nullptr;
             other.next_line_buffer_ = nullptr;
             other.helper_buffer_ = nullptr;
@@ -665,8 +1130,8 @@ private:
                 buffer_ = other.buffer_;
                 next_line_buffer_ = other.next_line_buffer_;
                 helper_buffer_ = other.helper_buffer_;
-                converter_ = std::move(other.converter_);
-                next_line_converter_ = std::move(other.next_line_converter_);
+                converters_ = std::move(other.converters_);
+                select_converters(other);
                 buffer_size_ = other.buffer_size_;
                 next_line_buffer_size_ = other.next_line_buffer_size_;
                 helper_size_ = other.helper_size_;
@@ -675,6 +1140,18 @@ private:
                 crlf_ = other.crlf_;
                 line_number_ = other.line_number_;
                 next_line_size_ = other.next_line_size_;
+                bytes_read_ = other.bytes_read_;
+                next_line_offset_ = other.next_line_offset_;
+                line_offset_ = other.line_offset_;
+                line_size_ = other.line_size_;
+                capture_raw_ = other.capture_raw_;
+                raw_started_ = other.raw_started_;
+                raw_ = std::move(other.raw_);
+                next_raw_ = std::move(other.next_raw_);
+                stats_ = other.stats_;
+                timed_ = other.timed_;
+                record_size_estimate_ = other.record_size_estimate_;
+                resource_ = other.resource_;
 
                 other.buffer_ = nullptr;
                 other.next_line_buffer_ = nullptr;
@@ -685,10 +1162,17 @@ private:
             return *this;
         }
 
+        // the converters keep the roles they had in the other reader
+        void select_converters(const reader& other) {
+            size_t current = other.converter_ - other.converters_.data();
+            converter_ = &converters_[current];
+            next_line_converter_ = &converters_[1 - current];
+        }
+
         ~reader() {
-            free(buffer_);
-            free(next_line_buffer_);
-            free(helper_buffer_);
+            deallocate(buffer_, buffer_size_);
+            deallocate(next_line_buffer_, next_line_buffer_size_);
+            deallocate(helper_buffer_, helper_size_);
 
             if (file_) {
                 fclose(file_);
@@ -701,7 +1185,12 @@ private:
 
         // read next line each time in order to set eof_
         bool read_next() {
-            next_line_converter_.clear_error();
+            if constexpr (shrink_buffers) {
+                shrink_if_oversized(next_line_buffer_, next_line_buffer_size_);
+                shrink_if_oversized(helper_buffer_, helper_size_);
+            }
+
+            next_line_converter_->clear_error();
             ssize_t ssize = 0;
             size_t size = 0;
             while (size == 0) {
@@ -709,12 +1198,17 @@ private:
                 if (next_line_buffer_size_ > 0) {
                     next_line_buffer_[0] = '\0';
                 }
-                ssize = get_line(&next_line_buffer_, &next_line_buffer_size_,
-                                 file_);
+                next_line_offset_ = bytes_read_;
+                ssize = get_line(next_line_buffer_, next_line_buffer_size_);
 
                 if (ssize == -1) {
                     return false;
                 }
+                bytes_read_ += ssize;
+                SSP_PROBE2(read_line, line_number_, ssize);
+                if constexpr (collect_stats) {
+                    ++stats_.lines;
+                }
 
                 size = remove_eol(next_line_buffer_, ssize);
 
@@ -727,56 +1221,101 @@ private:
             return true;
         }
 
-        void parse() {
+        void parse(size_t columns = 0) {
+            if constexpr (collect_stats) {
+                if constexpr (timing_sample_rate > 0) {
+                    timed_ = stats_.records % timing_sample_rate == 0;
+                    stats_.timed_records += timed_;
+                }
+                ++stats_.records;
+
+                timed(&parser_stats::split_ticks,
+                      [&] { parse_record(columns); });
+                stats_.fields_split +=
+                    next_line_converter_->splitter_.split_data_.size();
+            } else {
+                parse_record(columns);
+            }
+
+            // the last line appended could have made the record too large
+            if constexpr (max_record_size::enabled) {
+                if (next_line_converter_->valid()) {
+                    record_too_large();
+                }
+            }
+
+            if constexpr (estimate_record_size) {
+                update_record_size_estimate(record_size());
+            }
+        }
+
+        // invokes the function, the time spent is added to the counter if
+        // the current record is sampled
+        template <typename Fun>
+        decltype(auto) timed(uint64_t parser_stats::*counter, Fun&& fun) {
+            if constexpr (timing_sample_rate > 0) {
+                tick_timer timer{timed_ ? &(stats_.*counter) : nullptr};
+                return fun();
+            } else {
+                return fun();
+            }
+        }
+
+        void parse_record(size_t columns) {
             size_t limit = 0;
+            raw_started_ = false;
+            // captured before any line is appended, so the raw record is
+            // also set if the record ends with an error while joining
+            capture_raw_if_enabled();
 
             if constexpr (escaped_multiline_enabled) {
                 while (escaped_eol(next_line_size_)) {
-                    if (multiline_limit_reached(limit)) {
+                    if (record_limit_reached(limit)) {
                         return;
                     }
 
                     if (!append_next_line_to_buffer(next_line_buffer_,
                                                     next_line_size_)) {
-                        next_line_converter_.handle_error_unterminated_escape();
+                        next_line_converter_
+                            ->handle_error_unterminated_escape();
                         return;
                     }
                 }
             }
 
-            next_line_converter_.split(next_line_buffer_, delim_);
+            next_line_converter_->split(next_line_buffer_, delim_, columns);
 
             if constexpr (quoted_multiline_enabled) {
                 while (unterminated_quote()) {
-                    next_line_size_ -= next_line_converter_.size_shifted();
+                    next_line_size_ -= next_line_converter_->size_shifted();
 
-                    if (multiline_limit_reached(limit)) {
+                    if (record_limit_reached(limit)) {
                         return;
                     }
 
                     if (!append_next_line_to_buffer(next_line_buffer_,
                                                     next_line_size_)) {
-                        next_line_converter_.handle_error_unterminated_quote();
+                        next_line_converter_->handle_error_unterminated_quote();
                         return;
                     }
 
                     if constexpr (escaped_multiline_enabled) {
                         while (escaped_eol(next_line_size_)) {
-                            if (multiline_limit_reached(limit)) {
+                            if (record_limit_reached(limit)) {
                                 return;
                             }
 
                             if (!append_next_line_to_buffer(next_line_buffer_,
                                                             next_line_size_)) {
                                 next_line_converter_
-                                    .handle_error_unterminated_escape();
+                                    ->handle_error_unterminated_escape();
                                 return;
                             }
                         }
                     }
 
-                    next_line_converter_.resplit(next_line_buffer_,
-                                                 next_line_size_, delim_);
+                    next_line_converter_->resplit(next_line_buffer_,
+                                                  next_line_size_, delim_);
                 }
             }
         }
@@ -785,18 +1324,95 @@ private:
             std::swap(buffer_, next_line_buffer_);
             std::swap(buffer_size_, next_line_buffer_size_);
             std::swap(converter_, next_line_converter_);
+            line_offset_ = next_line_offset_;
+            line_size_ = next_line_size_;
+            if constexpr (!is_const_line) {
+                std::swap(raw_, next_raw_);
+            }
+        }
+
+        // the splitter modifies the line if quoting or escaping is enabled
+        // so it has to be copied before it is split, the lines appended to
+        // it later are copied as they are read
+        void capture_raw_if_enabled() {
+            if constexpr (!is_const_line) {
+                if (capture_raw_) {
+                    next_raw_.assign(next_line_buffer_, next_line_size_);
+                    raw_started_ = true;
+                }
+            }
         }
 
-        bool multiline_limit_reached(size_t& limit) {
+        std::string_view get_raw() const {
+            if constexpr (is_const_line) {
+                return std::string_view{buffer_, line_size_};
+            } else {
+                return raw_;
+            }
+        }
+
+        // checked before the next line is appended to the record
+        bool record_limit_reached(size_t& limit) {
             if constexpr (multiline::size > 0) {
                 if (limit++ >= multiline::size) {
-                    next_line_converter_.handle_error_multiline_limit_reached();
+                    next_line_converter_
+                        ->handle_error_multiline_limit_reached();
+                    return true;
+                }
+            }
+            return record_too_large();
+        }
+
+        ////////////////
+        // record size
+        ////////////////
+
+        // bytes of the record read so far, including the new lines
+        size_t record_size() const {
+            return bytes_read_ - next_line_offset_;
+        }
+
+        // the lines of the record which are not read yet are read as
+        // separate records, as when the multiline limit is reached
+        bool record_too_large() {
+            if constexpr (max_record_size::enabled) {
+                if (record_size() > max_record_size::size) {
+                    next_line_converter_->handle_error_record_too_large(
+                        max_record_size::size);
                     return true;
                 }
             }
             return false;
         }
 
+        // the estimate moves towards the 90th percentile of the record
+        // sizes, it is exceeded by about one record in ten
+        void update_record_size_estimate(size_t size) {
+            size_t step = record_size_estimate_ / 32 + 1;
+            if (size > record_size_estimate_) {
+                record_size_estimate_ += 9 * step;
+            } else {
+                record_size_estimate_ -= std::min(step, record_size_estimate_);
+            }
+        }
+
+        // buffers left much larger than the usual records by an oversized
+        // one are released, and allocated again when the next line is read
+        void shrink_if_oversized(char*& buffer, size_t& size) {
+            constexpr static size_t min_shrink_size = 64 * 1024;
+            constexpr static size_t shrink_factor = 8;
+
+            if (size > min_shrink_size &&
+                size > shrink_factor * record_size_estimate_) {
+                deallocate(buffer, size);
+                buffer = nullptr;
+                size = 0;
+                if constexpr (collect_stats) {
+                    ++stats_.buffer_shrinks;
+                }
+            }
+        }
+
         bool escaped_eol(size_t size) {
             const char* curr;
             for (curr = next_line_buffer_ + size - 1;
@@ -808,7 +1424,7 @@ private:
         }
 
         bool unterminated_quote() {
-            return next_line_converter_.unterminated_quote();
+            return next_line_converter_->unterminated_quote();
         }
 
         void undo_remove_eol(char* buffer, size_t& string_end) {
@@ -834,17 +1450,29 @@ private:
             return size;
         }
 
+        // the capacity of the buffer is at least doubled when it grows, so
+        // the cost of joining the lines of a record is linear in its size
         void realloc_concat(char*& first, size_t& first_size,
-                            const char* const second, size_t second_size) {
-            // TODO make buffer_size an argument
-            next_line_buffer_size_ = first_size + second_size + 3;
-            auto new_first = static_cast<char*>(
-                realloc(static_cast<void*>(first), next_line_buffer_size_));
-            if (!first) {
-                throw std::bad_alloc{};
+                            size_t& buffer_size, const char* const second,
+                            size_t second_size) {
+            // space for the new line and the null character appended by
+            // undo_remove_eol if another line is joined after this one
+            size_t required_size = first_size + second_size + 3;
+            if (required_size > buffer_size) {
+                size_t new_size = std::max(required_size, 2 * buffer_size);
+                auto new_first =
+                    reallocate(first, buffer_size, new_size, first_size);
+                if (!new_first) {
+                    throw std::bad_alloc{};
+                }
+
+                first = new_first;
+                buffer_size = new_size;
+                if constexpr (collect_stats) {
+                    ++stats_.reallocs;
+                }
             }
 
-            first = new_first;
             std::copy_n(second, second_size + 1, first + first_size);
             first_size += second_size;
         }
@@ -852,20 +1480,79 @@ private:
         bool append_next_line_to_buffer(char*& buffer, size_t& size) {
             undo_remove_eol(buffer, size);
 
-            ssize_t next_ssize =
-                get_line(&helper_buffer_, &helper_size_, file_);
+            ssize_t next_ssize = get_line(helper_buffer_, helper_size_);
             if (next_ssize == -1) {
                 return false;
             }
 
+            bytes_read_ += next_ssize;
             ++line_number_;
+            SSP_PROBE2(multiline_join, line_number_, next_ssize);
+            if constexpr (collect_stats) {
+                ++stats_.lines;
+                ++stats_.multiline_joins;
+            }
+            if constexpr (!is_const_line) {
+                if (raw_started_) {
+                    next_raw_.append(crlf_ ? "\r\n" : "\n");
+                }
+            }
             size_t next_size = remove_eol(helper_buffer_, next_ssize);
-            realloc_concat(buffer, size, helper_buffer_, next_size);
+            if constexpr (!is_const_line) {
+                if (raw_started_) {
+                    next_raw_.append(helper_buffer_, next_size);
+                }
+            }
+            realloc_concat(buffer, size, next_line_buffer_size_, helper_buffer_,
+                           next_size);
             return true;
         }
 
-        std::string get_buffer() {
-            return std::string{next_line_buffer_, next_line_buffer_size_};
+        std::string_view get_buffer() {
+            return std::string_view{next_line_buffer_, next_line_size_};
+        }
+
+        ////////////////
+        // allocation
+        ////////////////
+
+        // the buffers are allocated using the memory resource if 'use_pmr'
+        // is enabled, or with malloc as done by getline otherwise
+        ssize_t get_line(char*& buffer, size_t& size) {
+            if constexpr (use_pmr) {
+                return ss::get_line(&buffer, &size, file_, resource_);
+            } else {
+                return ss::get_line(&buffer, &size, file_);
+            }
+        }
+
+        char* reallocate(char* buffer, size_t size, size_t new_size,
+                         size_t used) {
+            if constexpr (use_pmr) {
+                auto new_buffer =
+                    static_cast<char*>(resource_->allocate(new_size, 1));
+                if (buffer != nullptr) {
+                    std::copy_n(buffer, used, new_buffer);
+                    resource_->deallocate(buffer, size, 1);
+                }
+                return new_buffer;
+            } else {
+                (void)size;
+                (void)used;
+                return static_cast<char*>(
+                    realloc(static_cast<void*>(buffer), new_size));
+            }
+        }
+
+        void deallocate(char* buffer, size_t size) {
+            if constexpr (use_pmr) {
+                if (buffer != nullptr) {
+                    resource_->deallocate(buffer, size, 1);
+                }
+            } else {
+                (void)size;
+                free(buffer);
+            }
         }
 
         ////////////////
@@ -875,8 +1562,11 @@ private:
         char* next_line_buffer_{nullptr};
         char* helper_buffer_{nullptr};
 
-        converter<Options...> converter_;
-        converter<Options...> next_line_converter_;
+        // the converters are swapped by their pointers after each record,
+        // so the split data, which may be an array, is not moved
+        std::array<converter<Options...>, 2> converters_;
+        converter<Options...>* converter_{&converters_[0]};
+        converter<Options...>* next_line_converter_{&converters_[1]};
 
         size_t buffer_size_{0};
         size_t next_line_buffer_size_{0};
@@ -889,6 +1579,23 @@ private:
         size_t line_number_{0};
 
         size_t next_line_size_{0};
+
+        // byte offsets within the file
+        size_t bytes_read_{0};
+        size_t next_line_offset_{0};
+        size_t line_offset_{0};
+        size_t line_size_{0};
+
+        // raw records captured for the reject sink
+        bool capture_raw_{false};
+        bool raw_started_{false};
+        string_t<use_pmr> raw_;
+        string_t<use_pmr> next_raw_;
+
+        std::conditional_t<collect_stats, parser_stats, none> stats_{};
+        bool timed_{false};
+        size_t record_size_estimate_{0};
+        ss::memory_resource* resource_{nullptr};
     };
 
     ////////////////
@@ -897,9 +1604,15 @@ private:
 
     std::string file_name_;
     error_type error_{};
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
+    std::conditional_t<record_errors, std::vector<ss::error_info>, none>
+        recorded_errors_;
+    size_t error_count_{0};
+    reject_sink reject_sink_;
     reader reader_;
-    std::vector<std::string> header_;
-    std::string raw_header_;
+    vector_t<use_pmr, string_t<use_pmr>> header_;
+    vector_t<use_pmr, size_t> header_slots_;
+    string_t<use_pmr> raw_header_;
     bool eof_{false};
 };
 
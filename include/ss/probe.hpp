@@ -0,0 +1,29 @@
+#pragma once
+
+// static tracepoints for SystemTap, bpftrace or perf, enabled by defining
+// SSP_ENABLE_USDT if <sys/sdt.h> is available, each one is a single nop
+// instruction until a tracer is attached, eg:
+//     bpftrace -e 'usdt:./app:ssp:record_end { @[arg1] = count(); }'
+// the probes of the 'ssp' provider, with their arguments:
+//     file_open(const char* file_name, int opened)
+//     read_line(size_t line, size_t bytes)
+//     record_start(size_t line)
+//     multiline_join(size_t line, size_t bytes)
+//     conversion_error(size_t line, int error_code)
+//     record_end(size_t line, int valid)
+//     batch_complete(size_t rows)
+//     write_batch(size_t blocks, size_t bytes)
+#if defined(SSP_ENABLE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SSP_USDT_ENABLED 1
+#endif
+#endif
+
+#ifdef SSP_USDT_ENABLED
+#define SSP_PROBE1(name, a) DTRACE_PROBE1(ssp, name, a)
+#define SSP_PROBE2(name, a, b) DTRACE_PROBE2(ssp, name, a, b)
+#else
+#define SSP_PROBE1(name, a) ((void)0)
+#define SSP_PROBE2(name, a, b) ((void)0)
+#endif
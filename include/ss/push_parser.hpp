@@ -0,0 +1,287 @@
+#pragma once
+#include "common.hpp"
+#include "converter.hpp"
+#include "error.hpp"
+#include <cstring>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace ss {
+
+////////////////
+// push parser
+////////////////
+
+// parser for input which arrives in fragments of arbitrary size, eg. from
+// a socket or a message queue, the fragments are passed using 'feed' and
+// every complete record is converted and passed to the function given to
+// 'on_row', only the current incomplete record is buffered
+template <typename... Options>
+class push_parser {
+    constexpr static auto string_error = setup<Options...>::string_error;
+    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
+
+    using multiline = typename setup<Options...>::multiline;
+
+    constexpr static bool escaped_multiline_enabled =
+        multiline::enabled && setup<Options...>::escape::enabled;
+
+    constexpr static bool quoted_multiline_enabled =
+        multiline::enabled && setup<Options...>::quote::enabled;
+
+    constexpr static bool ignore_header = setup<Options...>::ignore_header;
+
+    constexpr static bool ignore_empty = setup<Options...>::ignore_empty;
+
+public:
+    push_parser(const std::string& delim = ss::default_delimiter)
+        : delim_{delim} {
+    }
+
+    push_parser(push_parser&& other) = default;
+    push_parser& operator=(push_parser&& other) = default;
+
+    push_parser(const push_parser& other) = delete;
+    push_parser& operator=(const push_parser& other) = delete;
+
+    bool valid() const {
+        return converter_.valid();
+    }
+
+    const std::string& error_msg() const {
+        return converter_.error_msg();
+    }
+
+    const ss::error_info& error_info() const {
+        return converter_.error_info();
+    }
+
+    // line of the input, the last one of the record if it spans multiple
+    // lines
+    size_t line() const {
+        return line_number_;
+    }
+
+    // sets the function invoked with every record converted into 'T' and
+    // 'Ts', the function can accept the values as separate arguments or
+    // as a tuple, as with the iterators of the parser, the record was
+    // converted only if 'valid' returns true, views into the record are
+    // valid only during the invocation
+    template <typename T, typename... Ts, typename Fun>
+    void on_row(Fun&& fun) {
+        using Value = no_void_validator_tup_t<T, Ts...>;
+        row_handler_ = [fun = std::forward<Fun>(fun)](
+                           push_parser& p) mutable {
+            Value value{};
+            if (p.converter_.valid()) {
+                value = p.converter_.template convert<T, Ts...>();
+            }
+
+            if constexpr (std::is_invocable_v<std::decay_t<Fun>&, Value&>) {
+                fun(value);
+            } else {
+                std::apply(fun, value);
+            }
+        };
+    }
+
+    // passes the next fragment of the input, the records completed by it
+    // are handled before returning, if an exception is thrown the rest of
+    // the fragment is discarded
+    void feed(const char* data, size_t size) {
+        const char* end = data + size;
+        while (data != end) {
+            auto eol = static_cast<const char*>(
+                std::memchr(data, '\n', end - data));
+            if (eol == nullptr) {
+                record_.append(data, end);
+                return;
+            }
+
+            record_.append(data, eol);
+            data = eol + 1;
+            read_line_and_reset_on_error();
+        }
+    }
+
+    void feed(const std::string& data) {
+        feed(data.data(), data.size());
+    }
+
+    // handles the last line if it is not terminated by a new line, a
+    // record which is still incomplete is passed as invalid, the parser
+    // can be used for the next input afterwards
+    void finish() {
+        finish_input();
+        line_number_ = 0;
+        header_ignored_ = false;
+    }
+
+private:
+    ////////////////
+    // reading
+    ////////////////
+
+    void finish_input() {
+        if (record_.size() > line_begin_) {
+            read_line_and_reset_on_error();
+        }
+
+        if (pending_) {
+            bool escaped = pending_escape_;
+            if constexpr (throw_on_error) {
+                reset_record();
+            }
+
+            if (escaped) {
+                converter_.handle_error_unterminated_escape();
+            } else {
+                converter_.handle_error_unterminated_quote();
+            }
+            handle_record();
+        }
+    }
+
+    void read_line_and_reset_on_error() {
+        if constexpr (throw_on_error) {
+            try {
+                read_line();
+            } catch (...) {
+                reset_record();
+                throw;
+            }
+        } else {
+            read_line();
+        }
+    }
+
+    // the same steps as done by the reader of the parser, but the next
+    // line of a multiline record is waited for instead of read
+    void read_line() {
+        ++line_number_;
+        remove_eol();
+
+        if (!pending_) {
+            converter_.clear_error();
+            if constexpr (ignore_header) {
+                if (!header_ignored_) {
+                    header_ignored_ = true;
+                    reset_record();
+                    return;
+                }
+            }
+
+            if constexpr (ignore_empty) {
+                if (record_.empty()) {
+                    return;
+                }
+            }
+        }
+
+        if constexpr (escaped_multiline_enabled) {
+            if (escaped_eol()) {
+                if (!multiline_limit_reached()) {
+                    wait_for_next_line(true);
+                }
+                return;
+            }
+        }
+
+        if (!split_) {
+            converter_.split(record_.data(), delim_);
+            split_ = true;
+        } else {
+            converter_.resplit(record_.data(), record_.size(), delim_);
+        }
+
+        if constexpr (quoted_multiline_enabled) {
+            if (converter_.unterminated_quote()) {
+                record_.resize(record_.size() - converter_.size_shifted());
+                if (!multiline_limit_reached()) {
+                    wait_for_next_line(false);
+                }
+                return;
+            }
+        }
+
+        handle_record();
+    }
+
+    void handle_record() {
+        if (row_handler_) {
+            row_handler_(*this);
+        }
+        reset_record();
+    }
+
+    void reset_record() {
+        record_.clear();
+        line_begin_ = 0;
+        multiline_count_ = 0;
+        pending_ = false;
+        pending_escape_ = false;
+        split_ = false;
+    }
+
+    void wait_for_next_line(bool escaped) {
+        record_.append(crlf_ ? "\r\n" : "\n");
+        line_begin_ = record_.size();
+        pending_ = true;
+        pending_escape_ = escaped;
+    }
+
+    // passes the record as invalid if the limit is reached
+    bool multiline_limit_reached() {
+        if constexpr (multiline::size > 0) {
+            if (multiline_count_++ >= multiline::size) {
+                converter_.handle_error_multiline_limit_reached();
+                handle_record();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool escaped_eol() const {
+        size_t escapes = 0;
+        for (auto it = record_.rbegin();
+             it != record_.rend() && setup<Options...>::escape::match(*it);
+             ++it) {
+            ++escapes;
+        }
+        return escapes % 2 == 1;
+    }
+
+    void remove_eol() {
+        crlf_ = record_.size() > line_begin_ && record_.back() == '\r';
+        if (crlf_) {
+            record_.pop_back();
+        }
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    std::string delim_;
+    converter<Options...> converter_;
+    std::function<void(push_parser&)> row_handler_;
+
+    // the current record, the last line of which starts at 'line_begin_'
+    std::string record_;
+    size_t line_begin_{0};
+
+    size_t line_number_{0};
+    size_t multiline_count_{0};
+    bool crlf_{false};
+    bool pending_{false};
+    bool pending_escape_{false};
+    bool split_{false};
+    bool header_ignored_{false};
+};
+
+} /* ss */
@@ -0,0 +1,100 @@
+#pragma once
+#include "error.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace ss {
+
+////////////////
+// rejected record
+////////////////
+
+// record passed to the reject sink of the parser, the raw view is valid
+// only during the invocation of the sink
+struct rejected_record {
+    // line of the file, the last one if the record spans multiple lines
+    size_t line;
+
+    // content of the record as it was read, without the end of line
+    std::string_view raw;
+
+    // detailed only if 'structured_error' is enabled, 'invalid_conversion'
+    // otherwise
+    error_code code;
+};
+
+////////////////
+// reject file
+////////////////
+
+// reject sink which writes the raw records verbatim into a file, one per
+// line, if a log file name is given the line number and the error of each
+// record is additionally written into it
+class reject_file {
+public:
+    constexpr static size_t default_buffer_size = 64 * 1024;
+
+    reject_file(const std::string& file_name,
+                const std::string& log_file_name = "",
+                size_t buffer_size = default_buffer_size)
+        : file_{open(file_name, buffer_size)} {
+        if (!log_file_name.empty()) {
+            log_ = open(log_file_name, buffer_size);
+        }
+    }
+
+    bool valid() const {
+        return file_ != nullptr;
+    }
+
+    void operator()(const rejected_record& record) const {
+        if (!file_) {
+            return;
+        }
+
+        fwrite(record.raw.data(), 1, record.raw.size(), file_.get());
+        fputc('\n', file_.get());
+
+        if (log_) {
+            std::string line = std::to_string(record.line);
+            fwrite(line.data(), 1, line.size(), log_.get());
+            fputc(' ', log_.get());
+            fputs(error_code_name(record.code), log_.get());
+            fputc('\n', log_.get());
+        }
+    }
+
+    // writes the buffered records, also done once the last copy of the
+    // sink is destroyed
+    void flush() const {
+        if (file_) {
+            fflush(file_.get());
+        }
+        if (log_) {
+            fflush(log_.get());
+        }
+    }
+
+private:
+    static std::shared_ptr<FILE> open(const std::string& file_name,
+                                      size_t buffer_size) {
+        FILE* file = fopen(file_name.c_str(), "wb");
+        if (!file) {
+            return nullptr;
+        }
+
+        setvbuf(file, nullptr, _IOFBF, buffer_size);
+        return std::shared_ptr<FILE>{file, [](FILE* f) { fclose(f); }};
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    std::shared_ptr<FILE> file_;
+    std::shared_ptr<FILE> log_;
+};
+
+} /* ss */
@@ -1,6 +1,10 @@
 #pragma once
+#include "memory.hpp"
 #include "type_traits.hpp"
 #include <array>
+#include <cstring>
+#include <string>
+#include <utility>
 
 namespace ss {
 
@@ -161,12 +165,126 @@ struct get_multiline<> {
 template <typename... Ts>
 using get_multiline_t = typename get_multiline<Ts...>::type;
 
+////////////////
+// null values
+////////////////
+
+// tokens which are converted to std::nullopt when extracting std::optional
+// values, they are given as pointers to null terminated constant arrays
+// with static storage duration, eg:
+//     constexpr char na[] = "NA";
+//     ss::null_values<na>
+template <auto... Tokens>
+struct null_values {
+private:
+    constexpr static std::array<size_t, sizeof...(Tokens)> sizes{
+        std::char_traits<char>::length(Tokens)...};
+
+    template <size_t... Is>
+    static bool match_impl(const char* const begin, size_t size,
+                           std::index_sequence<Is...>) {
+        return ((size == sizes[Is] &&
+                 std::memcmp(begin, Tokens, sizes[Is]) == 0) ||
+                ...);
+    }
+
+public:
+    static bool match(const char* const begin, const char* const end) {
+        return match_impl(begin, end - begin,
+                          std::make_index_sequence<sizeof...(Tokens)>{});
+    }
+
+    constexpr static bool enabled = (sizeof...(Tokens) > 0);
+    constexpr static bool strict = false;
+
+    static_assert((std::is_same_v<decltype(Tokens), const char*> && ...),
+                  "null values need to be given as constant char arrays");
+};
+
+// same as null_values, but values which are not null and cannot be
+// converted result in an error instead of std::nullopt
+template <auto... Tokens>
+struct null_values_strict : null_values<Tokens...> {
+    constexpr static bool strict = true;
+};
+
+template <typename T>
+struct is_instance_of_null_values : std::false_type {};
+
+template <auto... Tokens>
+struct is_instance_of_null_values<null_values<Tokens...>> : std::true_type {};
+
+template <auto... Tokens>
+struct is_instance_of_null_values<null_values_strict<Tokens...>>
+    : std::true_type {};
+
+template <typename... Ts>
+struct get_null_values;
+
+template <typename T, typename... Ts>
+struct get_null_values<T, Ts...> {
+    using type = std::conditional_t<is_instance_of_null_values<T>::value, T,
+                                    typename get_null_values<Ts...>::type>;
+};
+
+template <>
+struct get_null_values<> {
+    using type = null_values<>;
+};
+
+template <typename... Ts>
+using get_null_values_t = typename get_null_values<Ts...>::type;
+
 ////////////////
 // string_error
 ////////////////
 
 class string_error;
 
+////////////////
+// structured_error
+////////////////
+
+// errors are stored as ss::error_info objects, additionally every
+// 'SampleRate'-th error can be recorded into a log, up to 'MaxRecorded'
+// errors (0 for no limit), if 'Record' is enabled
+template <size_t MaxRecorded, size_t SampleRate = 1, bool Record = true>
+struct structured_error_log {
+    constexpr static auto max_recorded = MaxRecorded;
+    constexpr static auto sample_rate = SampleRate;
+    constexpr static auto record = Record;
+
+    static_assert(SampleRate > 0, "sample rate needs to be greater than 0");
+};
+
+using structured_error = structured_error_log<0, 1, false>;
+
+template <typename T>
+struct is_instance_of_structured_error_log : std::false_type {};
+
+template <size_t M, size_t S, bool R>
+struct is_instance_of_structured_error_log<structured_error_log<M, S, R>>
+    : std::true_type {};
+
+template <typename... Ts>
+struct get_structured_error_log;
+
+template <typename T, typename... Ts>
+struct get_structured_error_log<T, Ts...> {
+    using type = std::conditional_t<
+        is_instance_of_structured_error_log<T>::value, T,
+        typename get_structured_error_log<Ts...>::type>;
+};
+
+template <>
+struct get_structured_error_log<> {
+    using type = structured_error;
+};
+
+template <typename... Ts>
+using get_structured_error_log_t =
+    typename get_structured_error_log<Ts...>::type;
+
 ////////////////
 // ignore_header
 ////////////////
@@ -185,6 +303,141 @@ class ignore_empty;
 
 class throw_on_error;
 
+////////////////
+// max_record_size
+////////////////
+
+// records longer than 'Size' bytes, including the new lines of multiline
+// records, result in an error, 0 for no limit
+template <size_t Size>
+struct max_record_size {
+    constexpr static auto size = Size;
+    constexpr static auto enabled = (Size > 0);
+};
+
+template <typename T>
+struct is_instance_of_max_record_size : std::false_type {};
+
+template <size_t S>
+struct is_instance_of_max_record_size<max_record_size<S>> : std::true_type {};
+
+template <typename... Ts>
+struct get_max_record_size;
+
+template <typename T, typename... Ts>
+struct get_max_record_size<T, Ts...> {
+    using type =
+        std::conditional_t<is_instance_of_max_record_size<T>::value, T,
+                           typename get_max_record_size<Ts...>::type>;
+};
+
+template <>
+struct get_max_record_size<> {
+    using type = max_record_size<0>;
+};
+
+template <typename... Ts>
+using get_max_record_size_t = typename get_max_record_size<Ts...>::type;
+
+////////////////
+// max_columns
+////////////////
+
+// rows are split into a fixed size array of 'Size' elements instead of a
+// vector, rows with more columns result in an error
+template <size_t Size>
+struct max_columns {
+    static_assert(Size > 0, "max_columns needs to be greater than 0");
+    constexpr static auto size = Size;
+    constexpr static auto enabled = true;
+};
+
+template <typename T>
+struct is_instance_of_max_columns : std::false_type {};
+
+template <size_t S>
+struct is_instance_of_max_columns<max_columns<S>> : std::true_type {};
+
+template <typename... Ts>
+struct get_max_columns;
+
+template <typename T, typename... Ts>
+struct get_max_columns<T, Ts...> {
+    using type =
+        std::conditional_t<is_instance_of_max_columns<T>::value, T,
+                           typename get_max_columns<Ts...>::type>;
+};
+
+template <>
+struct get_max_columns<> {
+    struct type {
+        constexpr static size_t size = 0;
+        constexpr static bool enabled = false;
+    };
+};
+
+template <typename... Ts>
+using get_max_columns_t = typename get_max_columns<Ts...>::type;
+
+////////////////
+// shrink_buffers
+////////////////
+
+class shrink_buffers;
+
+////////////////
+// use_pmr
+////////////////
+
+class use_pmr;
+
+////////////////
+// table_driven
+////////////////
+
+// lines split using a single character delimiter are split by a state
+// machine which uses tables generated from the setup
+class table_driven;
+
+////////////////
+// collect_stats
+////////////////
+
+// the parser collects ss::parser_stats, additionally the time spent in each
+// phase is measured for every 'TimingSampleRate'-th record, if not 0
+template <size_t TimingSampleRate, bool B = true>
+struct collect_stats_timed {
+    constexpr static auto timing_sample_rate = TimingSampleRate;
+    constexpr static auto enabled = B;
+};
+
+using collect_stats = collect_stats_timed<0>;
+
+template <typename T>
+struct is_instance_of_collect_stats : std::false_type {};
+
+template <size_t S, bool B>
+struct is_instance_of_collect_stats<collect_stats_timed<S, B>>
+    : std::true_type {};
+
+template <typename... Ts>
+struct get_collect_stats;
+
+template <typename T, typename... Ts>
+struct get_collect_stats<T, Ts...> {
+    using type =
+        std::conditional_t<is_instance_of_collect_stats<T>::value, T,
+                           typename get_collect_stats<Ts...>::type>;
+};
+
+template <>
+struct get_collect_stats<> {
+    using type = collect_stats_timed<0, false>;
+};
+
+template <typename... Ts>
+using get_collect_stats_t = typename get_collect_stats<Ts...>::type;
+
 ////////////////
 // setup implementation
 ////////////////
@@ -212,11 +465,26 @@ private:
     template <typename T>
     struct is_throw_on_error : std::is_same<T, throw_on_error> {};
 
+    template <typename T>
+    struct is_shrink_buffers : std::is_same<T, shrink_buffers> {};
+
+    template <typename T>
+    struct is_use_pmr : std::is_same<T, use_pmr> {};
+
+    template <typename T>
+    struct is_table_driven : std::is_same<T, table_driven> {};
+
     constexpr static auto count_matcher = count_v<is_matcher, Options...>;
 
     constexpr static auto count_multiline =
         count_v<is_instance_of_multiline, Options...>;
 
+    constexpr static auto count_null_values =
+        count_v<is_instance_of_null_values, Options...>;
+
+    constexpr static auto count_structured_error =
+        count_v<is_instance_of_structured_error_log, Options...>;
+
     constexpr static auto count_string_error =
         count_v<is_string_error, Options...>;
 
@@ -229,9 +497,29 @@ private:
     constexpr static auto count_ignore_empty =
         count_v<is_ignore_empty, Options...>;
 
+    constexpr static auto count_collect_stats =
+        count_v<is_instance_of_collect_stats, Options...>;
+
+    constexpr static auto count_max_record_size =
+        count_v<is_instance_of_max_record_size, Options...>;
+
+    constexpr static auto count_shrink_buffers =
+        count_v<is_shrink_buffers, Options...>;
+
+    constexpr static auto count_use_pmr = count_v<is_use_pmr, Options...>;
+
+    constexpr static auto count_table_driven =
+        count_v<is_table_driven, Options...>;
+
+    constexpr static auto count_max_columns =
+        count_v<is_instance_of_max_columns, Options...>;
+
     constexpr static auto number_of_valid_setup_types =
         count_matcher + count_multiline + count_string_error +
-        count_ignore_header + count_ignore_empty + count_throw_on_error;
+        count_ignore_header + count_ignore_empty + count_throw_on_error +
+        count_null_values + count_structured_error + count_collect_stats +
+        count_max_record_size + count_shrink_buffers + count_use_pmr +
+        count_max_columns + count_table_driven;
 
     using trim_left_only = get_matcher_t<trim_left, Options...>;
     using trim_right_only = get_matcher_t<trim_right, Options...>;
@@ -247,11 +535,25 @@ public:
         std::conditional_t<trim_all::enabled, trim_all, trim_right_only>;
 
     using multiline = get_multiline_t<Options...>;
+    using null_values = get_null_values_t<Options...>;
     constexpr static bool string_error = (count_string_error == 1);
     constexpr static bool ignore_header = (count_ignore_header == 1);
     constexpr static bool ignore_empty = (count_ignore_empty == 1);
     constexpr static bool throw_on_error = (count_throw_on_error == 1);
 
+    using error_log = get_structured_error_log_t<Options...>;
+    constexpr static bool structured_error = (count_structured_error == 1);
+
+    using stats = get_collect_stats_t<Options...>;
+    constexpr static bool collect_stats = stats::enabled;
+
+    using max_record_size = get_max_record_size_t<Options...>;
+    constexpr static bool shrink_buffers = (count_shrink_buffers == 1);
+    constexpr static bool use_pmr = (count_use_pmr == 1);
+
+    using max_columns = get_max_columns_t<Options...>;
+    constexpr static bool table_driven = (count_table_driven == 1);
+
 private:
 #define ASSERT_MSG "cannot have the same match character in multiple matchers"
     static_assert(!matches_intersect<escape, quote>(), ASSERT_MSG);
@@ -277,15 +579,49 @@ private:
 
     static_assert(count_multiline <= 1, "mutliline defined multiple times");
 
+    static_assert(count_null_values <= 1,
+                  "null values defined multiple times");
+
     static_assert(count_string_error <= 1,
                   "string_error defined multiple times");
 
     static_assert(count_throw_on_error <= 1,
                   "throw_on_error defined multiple times");
 
+    static_assert(count_structured_error <= 1,
+                  "structured_error defined multiple times");
+
+    static_assert(count_collect_stats <= 1,
+                  "collect_stats defined multiple times");
+
+    static_assert(count_max_record_size <= 1,
+                  "max_record_size defined multiple times");
+
+    static_assert(count_shrink_buffers <= 1,
+                  "shrink_buffers defined multiple times");
+
+    static_assert(count_use_pmr <= 1, "use_pmr defined multiple times");
+
+    static_assert(count_max_columns <= 1,
+                  "max_columns defined multiple times");
+
+    static_assert(count_table_driven <= 1,
+                  "table_driven defined multiple times");
+
+#ifndef SSP_HAS_PMR
+    static_assert(count_use_pmr == 0,
+                  "use_pmr requires the <memory_resource> header");
+#endif
+
     static_assert(count_throw_on_error + count_string_error <= 1,
                   "cannot define both throw_on_error and string_error");
 
+    static_assert(count_structured_error + count_string_error +
+                          count_throw_on_error <=
+                      1,
+                  "cannot define structured_error together with "
+                  "string_error or throw_on_error");
+
     static_assert(number_of_valid_setup_types == sizeof...(Options),
                   "one or multiple invalid setup parameters defined");
 };
@@ -0,0 +1,228 @@
+#pragma once
+#include "setup.hpp"
+#include <array>
+#include <cstdint>
+
+namespace ss {
+
+////////////////
+// split table
+////////////////
+
+// classes of the characters of a line, the delimiter is not a part of the
+// class table since it is only known at runtime
+enum class char_class : uint8_t {
+    normal,
+    quote,
+    escape,
+    trim_left,
+    trim_right,
+    trim,
+    eol,
+    delimiter,
+    count
+};
+
+// states of the splitter while reading a field
+enum class split_state : uint8_t {
+    field_start,
+    unquoted,
+    unquoted_escape,
+    quoted,
+    quoted_escape,
+    quote_end,
+    quote_end_trim,
+    count
+};
+
+// transitions which end a field or the line, handled outside of the main
+// loop of the splitter
+enum class split_action : uint8_t {
+    none,
+    push_delimiter,
+    push_eol,
+    unquoted_escape_eol,
+    quoted_escape_eol,
+    quoted_eol,
+    mismatched_quote
+};
+
+// the character read is written to the current position of the field,
+// which is advanced if 'advance' is set, the characters which are shifted
+// out are not written, 'skip' moves the beginning of the field, and
+// 'content' marks the written characters as a part of the field, the
+// trailing trim characters are not content, 'run' is set if the next state
+// reads normal characters as content without changing, so they can be
+// copied in a loop, aligned so that an entry of the table is found using
+// shifts only
+struct alignas(8) split_transition {
+    split_state next{split_state::field_start};
+    split_action action{split_action::none};
+    uint8_t advance{0};
+    uint8_t skip{0};
+    uint8_t content{0};
+    uint8_t shift{0};
+    uint8_t run{0};
+};
+
+template <typename... Options>
+struct split_table {
+    using class_table = std::array<char_class, 256>;
+
+private:
+    using quote = typename setup<Options...>::quote;
+    using trim_left = typename setup<Options...>::trim_left;
+    using trim_right = typename setup<Options...>::trim_right;
+    using escape = typename setup<Options...>::escape;
+
+    constexpr static size_t class_count =
+        static_cast<size_t>(char_class::count);
+    constexpr static size_t state_count =
+        static_cast<size_t>(split_state::count);
+
+    using transition_table =
+        std::array<split_transition, state_count * class_count>;
+
+    template <typename Matcher>
+    constexpr static void set_class(class_table& classes, char_class c) {
+        if constexpr (Matcher::enabled) {
+            for (const auto& match : Matcher::matches) {
+                auto& curr = classes[static_cast<unsigned char>(match)];
+                // characters in both trim sets are trimmed on both sides
+                curr = (c == char_class::trim_right &&
+                        curr == char_class::trim_left)
+                           ? char_class::trim
+                           : c;
+            }
+        }
+    }
+
+    constexpr static class_table make_classes() {
+        class_table classes{};
+        for (auto& c : classes) {
+            c = char_class::normal;
+        }
+        set_class<trim_left>(classes, char_class::trim_left);
+        set_class<trim_right>(classes, char_class::trim_right);
+        set_class<quote>(classes, char_class::quote);
+        set_class<escape>(classes, char_class::escape);
+        classes[0] = char_class::eol;
+        return classes;
+    }
+
+    constexpr static uint8_t runs(split_state next) {
+        return next == split_state::unquoted || next == split_state::quoted;
+    }
+
+    constexpr static split_transition write(split_state next) {
+        return {next, split_action::none, 1, 0, 1, 0, runs(next)};
+    }
+
+    constexpr static split_transition write_shifted(split_state next) {
+        return {next, split_action::none, 1, 0, 1, 1, runs(next)};
+    }
+
+    constexpr static split_transition write_trailing(split_state next) {
+        return {next, split_action::none, 1, 0, 0, 0, 0};
+    }
+
+    constexpr static split_transition skip(split_state next) {
+        return {next, split_action::none, 1, 1, 1, 0, runs(next)};
+    }
+
+    constexpr static split_transition drop(split_state next) {
+        return {next, split_action::none, 0, 0, 0, 0, 0};
+    }
+
+    constexpr static split_transition stop(split_action action) {
+        return {split_state::field_start, action, 0, 0, 0, 0, 0};
+    }
+
+    // the transitions of one state, given for each character class in
+    // the order of their declaration
+    constexpr static void set_row(
+        transition_table& transitions, split_state state,
+        const std::array<split_transition, class_count>& row) {
+        for (size_t i = 0; i < class_count; ++i) {
+            transitions[static_cast<size_t>(state) * class_count + i] = row[i];
+        }
+    }
+
+    constexpr static transition_table make_transitions() {
+        using s = split_state;
+        using a = split_action;
+
+        transition_table transitions{};
+
+        // eg: ..., "a"... or ...,  a...
+        set_row(transitions, s::field_start,
+                {write(s::unquoted), skip(s::quoted),
+                 drop(s::unquoted_escape), skip(s::field_start),
+                 write_trailing(s::unquoted), skip(s::field_start),
+                 stop(a::push_eol), stop(a::push_delimiter)});
+
+        // eg: ...,ab c  ,...
+        set_row(transitions, s::unquoted,
+                {write(s::unquoted), write(s::unquoted),
+                 drop(s::unquoted_escape), write(s::unquoted),
+                 write_trailing(s::unquoted), write_trailing(s::unquoted),
+                 stop(a::push_eol), stop(a::push_delimiter)});
+
+        // eg: ...,a\,b,...
+        set_row(transitions, s::unquoted_escape,
+                {write_shifted(s::unquoted), write_shifted(s::unquoted),
+                 write_shifted(s::unquoted), write_shifted(s::unquoted),
+                 write_shifted(s::unquoted), write_shifted(s::unquoted),
+                 stop(a::unquoted_escape_eol), write_shifted(s::unquoted)});
+
+        // eg: ...,"a, b",...
+        set_row(transitions, s::quoted,
+                {write(s::quoted), drop(s::quote_end),
+                 drop(s::quoted_escape), write(s::quoted), write(s::quoted),
+                 write(s::quoted), stop(a::quoted_eol), write(s::quoted)});
+
+        // eg: ...,"a\"b",...
+        set_row(transitions, s::quoted_escape,
+                {write_shifted(s::quoted), write_shifted(s::quoted),
+                 write_shifted(s::quoted), write_shifted(s::quoted),
+                 write_shifted(s::quoted), write_shifted(s::quoted),
+                 stop(a::quoted_escape_eol), write_shifted(s::quoted)});
+
+        // eg: ...,"a""b",... or ...,"a"  ,...
+        set_row(transitions, s::quote_end,
+                {stop(a::mismatched_quote), write_shifted(s::quoted),
+                 stop(a::mismatched_quote), stop(a::mismatched_quote),
+                 write_trailing(s::quote_end_trim),
+                 write_trailing(s::quote_end_trim), stop(a::push_eol),
+                 stop(a::push_delimiter)});
+
+        // eg: ...,"a"  ,... or ...,"a"  b,... -> error
+        set_row(transitions, s::quote_end_trim,
+                {stop(a::mismatched_quote), stop(a::mismatched_quote),
+                 stop(a::mismatched_quote), stop(a::mismatched_quote),
+                 write_trailing(s::quote_end_trim),
+                 write_trailing(s::quote_end_trim), stop(a::push_eol),
+                 stop(a::push_delimiter)});
+
+        return transitions;
+    }
+
+public:
+    constexpr static class_table classes = make_classes();
+    constexpr static transition_table transitions = make_transitions();
+
+    // the delimiter is compared before the class table is used, so it
+    // cannot be a character of any of the matchers
+    constexpr static bool valid_delimiter(char delim) {
+        return classes[static_cast<unsigned char>(delim)] ==
+               char_class::normal;
+    }
+
+    constexpr static const split_transition& transition(split_state state,
+                                                        char_class c) {
+        return transitions[static_cast<size_t>(state) * class_count +
+                           static_cast<size_t>(c)];
+    }
+};
+
+} /* ss */
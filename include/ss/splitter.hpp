@@ -1,7 +1,10 @@
 #pragma once
 #include "common.hpp"
+#include "error.hpp"
 #include "exception.hpp"
+#include "memory.hpp"
 #include "setup.hpp"
+#include "split_table.hpp"
 #include "type_traits.hpp"
 #include <algorithm>
 #include <cstdlib>
@@ -23,16 +26,41 @@ private:
 
     constexpr static auto string_error = setup<Options...>::string_error;
     constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
     constexpr static auto is_const_line = !quote::enabled && !escape::enabled;
+    constexpr static auto collect_stats = setup<Options...>::collect_stats;
+    constexpr static auto use_pmr = setup<Options...>::use_pmr;
+    using max_columns = typename setup<Options...>::max_columns;
+    constexpr static auto table_driven = setup<Options...>::table_driven;
+    using table = split_table<Options...>;
 
-    using error_type = std::conditional_t<string_error, std::string, bool>;
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
 
 public:
     using line_ptr_type = std::conditional_t<is_const_line, const char*, char*>;
+    using split_data =
+        std::conditional_t<max_columns::enabled,
+                           inline_split_data<max_columns::size>,
+                           vector_t<use_pmr, string_range>>;
+
+    splitter() = default;
+
+    // the split data is allocated using the memory resource, requires the
+    // 'use_pmr' setup option
+    explicit splitter(ss::memory_resource* resource)
+        : split_data_{make_split_data(resource)} {
+        static_assert(use_pmr, "use_pmr needs to be enabled to use a memory "
+                               "resource");
+    }
 
     bool valid() const {
         if constexpr (string_error) {
             return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
         } else if constexpr (throw_on_error) {
             return true;
         } else {
@@ -41,7 +69,17 @@ public:
     }
 
     const std::string& error_msg() const {
-        assert_string_error_defined<string_error>();
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = error_.message();
+            return error_msg_;
+        } else {
+            return error_;
+        }
+    }
+
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
         return error_;
     }
 
@@ -51,13 +89,20 @@ public:
 
     const split_data& split(line_ptr_type new_line,
                             const std::string& delimiter = default_delimiter) {
+        return split(new_line, delimiter, 0);
+    }
+
+private:
+    // stops splitting after the given number of columns, if not 0
+    const split_data& split(line_ptr_type new_line,
+                            const std::string& delimiter, size_t columns) {
         split_data_.clear();
         line_ = new_line;
         begin_ = line_;
+        columns_ = columns;
         return split_impl_select_delim(delimiter);
     }
 
-private:
     ////////////////
     // resplit
     ////////////////
@@ -113,9 +158,18 @@ private:
     // error
     ////////////////
 
+    // the code of the last error is kept for the stats of the converter
+    void set_stats_error(error_code code) {
+        if constexpr (collect_stats) {
+            error_code_ = code;
+        }
+    }
+
     void clear_error() {
         if constexpr (string_error) {
             error_.clear();
+        } else if constexpr (structured_error) {
+            error_.code = error_code::none;
         } else if constexpr (!throw_on_error) {
             error_ = false;
         }
@@ -125,9 +179,13 @@ private:
     void handle_error_empty_delimiter() {
         constexpr static auto error_msg = "empty delimiter";
 
+        set_stats_error(error_code::empty_delimiter);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::empty_delimiter);
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg};
         } else {
@@ -138,9 +196,15 @@ private:
     void handle_error_mismatched_quote(size_t n) {
         constexpr static auto error_msg = "mismatched quote at position: ";
 
+        set_stats_error(error_code::mismatched_quote);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg + std::to_string(n));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::mismatched_quote);
+            error_.column = split_data_.size();
+            error_.offset = n;
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg + std::to_string(n)};
         } else {
@@ -152,9 +216,14 @@ private:
         constexpr static auto error_msg =
             "unterminated escape at the end of the line";
 
+        set_stats_error(error_code::unterminated_escape);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::unterminated_escape);
+            error_.column = split_data_.size();
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg};
         } else {
@@ -165,9 +234,14 @@ private:
     void handle_error_unterminated_quote() {
         constexpr static auto error_msg = "unterminated quote";
 
+        set_stats_error(error_code::unterminated_quote);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::unterminated_quote);
+            error_.column = split_data_.size();
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg};
         } else {
@@ -180,9 +254,13 @@ private:
             "invalid resplit, new line must be longer"
             "than the end of the last slice";
 
+        set_stats_error(error_code::invalid_resplit);
+
         if constexpr (string_error) {
             error_.clear();
             error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::invalid_resplit);
         } else if constexpr (throw_on_error) {
             throw ss::exception{error_msg};
         } else {
@@ -190,6 +268,27 @@ private:
         }
     }
 
+    void handle_error_too_many_columns() {
+        constexpr static auto error_msg = "too many columns, limit: ";
+
+        set_stats_error(error_code::too_many_columns);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg).append(
+                std::to_string(max_columns::size));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::too_many_columns);
+            error_.column = split_data_.size();
+            error_.expected = max_columns::size;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg +
+                                std::to_string(max_columns::size)};
+        } else {
+            error_ = true;
+        }
+    }
+
     ////////////////
     // matching
     ////////////////
@@ -238,10 +337,10 @@ private:
             return {0, false};
         }
 
-        // not a delimiter
+        // not a delimiter, the trim characters are not trailing so they
+        // are read as a part of the field
         if (!match(end, delim)) {
-            shift_if_escaped(end);
-            return {1 + end - begin, false};
+            return {std::max<size_t>(end - begin, 1), false};
         }
 
         end += delimiter_size(delim);
@@ -274,6 +373,9 @@ private:
         shift_and_set_current();
         if constexpr (!is_const_line) {
             ++escaped_;
+            if constexpr (collect_stats) {
+                ++escapes_shifted_;
+            }
         }
         ++end_;
     }
@@ -319,15 +421,188 @@ private:
 
     template <typename Delim>
     const split_data& split_impl(const Delim& delim) {
+        if constexpr (table_driven && std::is_same_v<Delim, char>) {
+            if (table::valid_delimiter(delim)) {
+                return split_table_impl(delim);
+            }
+        }
 
         trim_left_if_enabled(begin_);
 
-        for (done_ = false; !done_; read(delim))
-            ;
+        done_ = false;
+        while (!done_ && columns_left()) {
+            read(delim);
+        }
 
         return split_data_;
     }
 
+    // the split data does not use the memory resource if it is an array
+    static split_data make_split_data(ss::memory_resource* resource) {
+        if constexpr (max_columns::enabled) {
+            (void)resource;
+            return split_data{};
+        } else {
+            return split_data(make_allocator<use_pmr>(resource));
+        }
+    }
+
+    bool columns_reached() const {
+        return columns_ != 0 && split_data_.size() == columns_;
+    }
+
+    bool columns_left() {
+        if (columns_reached()) {
+            return false;
+        }
+
+        // each read adds one column, so the array is full if a column is
+        // left to be read
+        if constexpr (max_columns::enabled) {
+            if (split_data_.size() == max_columns::size) {
+                handle_error_too_many_columns();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ////////////////
+    // table driven split
+    ////////////////
+
+    // the same as split_impl, but each character is read using a single
+    // lookup into the tables generated from the setup, the fields are
+    // shifted in place while reading
+    const split_data& split_table_impl(char delim) {
+        line_ptr_type read = begin_;
+        line_ptr_type write = begin_;
+        line_ptr_type content_end = begin_;
+        line_ptr_type field_begin = begin_;
+        auto state = split_state::field_start;
+        escaped_ = 0;
+
+        if constexpr (multiline::enabled) {
+            if (resplitting_) {
+                // continue reading the unterminated quoted field
+                resplitting_ = false;
+                field_begin = begin_ + 1;
+                read = write = content_end = end_;
+                state = split_state::quoted;
+            }
+        }
+
+        done_ = false;
+        if (!columns_left()) {
+            return split_data_;
+        }
+
+        while (true) {
+            const char c = *read;
+            const auto& transition =
+                table::transition(state, table_class(c, delim));
+
+            if (transition.action != split_action::none) {
+                if (transition.action == split_action::push_delimiter) {
+                    // copied so that the pointers can stay in registers
+                    split_data_.emplace_back(line_ptr_type{field_begin},
+                                             line_ptr_type{content_end});
+                    field_begin = write = content_end = ++read;
+                    state = split_state::field_start;
+                    if (!columns_left()) {
+                        return split_data_;
+                    }
+                    continue;
+                }
+
+                handle_table_eol(transition.action, read, write, content_end,
+                                 field_begin);
+                done_ = true;
+                return split_data_;
+            }
+
+            if constexpr (!is_const_line) {
+                *write = c;
+            }
+            write += transition.advance;
+            field_begin += transition.skip;
+            content_end = transition.content ? write : content_end;
+            if constexpr (collect_stats) {
+                escapes_shifted_ += transition.shift;
+            }
+            state = transition.next;
+            ++read;
+
+            if (transition.run) {
+                while (table_class(*read, delim) == char_class::normal) {
+                    if constexpr (!is_const_line) {
+                        *write = *read;
+                    }
+                    ++write;
+                    ++read;
+                }
+                content_end = write;
+            }
+        }
+    }
+
+    // the delimiter is not a part of the generated class table
+    static char_class table_class(char c, char delim) {
+        return c == delim ? char_class::delimiter
+                          : table::classes[static_cast<unsigned char>(c)];
+    }
+
+    // the actions which end the line, the same errors and elements as the
+    // ones of split_impl are produced
+    void handle_table_eol(split_action action, line_ptr_type read,
+                          line_ptr_type write, line_ptr_type content_end,
+                          line_ptr_type field_begin) {
+        switch (action) {
+        case split_action::push_eol:
+            split_data_.emplace_back(field_begin, content_end);
+            break;
+        case split_action::unquoted_escape_eol:
+            // eg: ...,hel\\0 -> error, the escape is a part of the field
+            if constexpr (!multiline::enabled) {
+                handle_error_unterminated_escape();
+            }
+            if constexpr (!is_const_line) {
+                *write = read[-1];
+            }
+            split_data_.emplace_back(field_begin, write + 1);
+            break;
+        case split_action::quoted_escape_eol:
+            // eg: ..."hel\\0
+            if constexpr (!multiline::enabled) {
+                handle_error_unterminated_escape();
+            }
+            break;
+        case split_action::quoted_eol:
+            // eg: ..."hell\0 -> quote not terminated
+            unterminated_quote_ = true;
+            if constexpr (!multiline::enabled) {
+                handle_error_unterminated_quote();
+            }
+            split_data_.emplace_back(line_, field_begin);
+            // the state used to continue if resplit
+            curr_ = write;
+            end_ = read;
+            escaped_ = read - write;
+            break;
+        case split_action::mismatched_quote: {
+            // eg: ...,"hel"lo,... -> error
+            // the closing quote may be followed by trim characters, they
+            // are written after the content of the field
+            auto closing_quote = read - 1 - (write - content_end);
+            handle_error_mismatched_quote(closing_quote - line_);
+            split_data_.emplace_back(line_, field_begin);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
     ////////////////
     // reading
     ////////////////
@@ -367,6 +642,7 @@ private:
                     done_ = true;
                     break;
                 } else {
+                    shift_if_escaped(end_);
                     end_ += width;
                     continue;
                 }
@@ -464,10 +740,15 @@ private:
 
 public:
     error_type error_{};
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
     bool unterminated_quote_{false};
     bool done_{true};
     bool resplitting_{false};
     size_t escaped_{0};
+    size_t columns_{0};
+
+    std::conditional_t<collect_stats, size_t, none> escapes_shifted_{};
+    std::conditional_t<collect_stats, error_code, none> error_code_{};
     split_data split_data_;
 
     line_ptr_type begin_;
@@ -0,0 +1,133 @@
+#pragma once
+#include "error.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SSP_HAS_RDTSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define SSP_HAS_RDTSC 1
+#endif
+
+namespace ss {
+
+////////////////
+// ticks
+////////////////
+
+// cycles of the time stamp counter where available, nanoseconds otherwise
+inline uint64_t ticks() {
+#ifdef SSP_HAS_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+// adds the ticks elapsed during its lifetime to the counter, if not null
+class tick_timer {
+public:
+    tick_timer(uint64_t* counter)
+        : counter_{counter}, begin_{counter ? ticks() : 0} {
+    }
+
+    ~tick_timer() {
+        if (counter_) {
+            *counter_ += ticks() - begin_;
+        }
+    }
+
+    tick_timer(const tick_timer& other) = delete;
+    tick_timer& operator=(const tick_timer& other) = delete;
+
+private:
+    uint64_t* counter_;
+    uint64_t begin_;
+};
+
+////////////////
+// parser stats
+////////////////
+
+// counters collected by the parser and the converter if the
+// 'collect_stats' setup option is used
+struct parser_stats {
+    // input read, including lines appended to multiline records
+    size_t bytes_read{0};
+    size_t lines{0};
+
+    // records read, and lines appended to them
+    size_t records{0};
+    size_t multiline_joins{0};
+
+    // characters removed by the splitter because of escapes and doubled
+    // quotes, and fields split
+    size_t escapes_shifted{0};
+    size_t fields_split{0};
+
+    // reallocations of the buffer while joining multiline records, and
+    // buffers released after oversized records if 'shrink_buffers' is used
+    size_t reallocs{0};
+    size_t buffer_shrinks{0};
+
+    // moving estimate of the 90th percentile of the record sizes in bytes
+    size_t record_size_percentile{0};
+
+    // successful conversions of fields by type, 'other' contains
+    // characters, booleans, optionals, variants and custom conversions
+    size_t integer_conversions{0};
+    size_t floating_point_conversions{0};
+    size_t string_conversions{0};
+    size_t other_conversions{0};
+
+    // failed conversions by error code
+    std::array<size_t, error_code_count> failures{};
+
+    // time spent in each phase of the sampled records, in ticks
+    size_t timed_records{0};
+    uint64_t read_ticks{0};
+    uint64_t split_ticks{0};
+    uint64_t convert_ticks{0};
+
+    size_t failure_count(error_code code) const {
+        return failures[static_cast<size_t>(code)];
+    }
+
+    size_t conversions() const {
+        return integer_conversions + floating_point_conversions +
+               string_conversions + other_conversions;
+    }
+
+    parser_stats& operator+=(const parser_stats& other) {
+        bytes_read += other.bytes_read;
+        lines += other.lines;
+        records += other.records;
+        multiline_joins += other.multiline_joins;
+        escapes_shifted += other.escapes_shifted;
+        fields_split += other.fields_split;
+        reallocs += other.reallocs;
+        buffer_shrinks += other.buffer_shrinks;
+        record_size_percentile =
+            std::max(record_size_percentile, other.record_size_percentile);
+        integer_conversions += other.integer_conversions;
+        floating_point_conversions += other.floating_point_conversions;
+        string_conversions += other.string_conversions;
+        other_conversions += other.other_conversions;
+        for (size_t i = 0; i < failures.size(); ++i) {
+            failures[i] += other.failures[i];
+        }
+        timed_records += other.timed_records;
+        read_ticks += other.read_ticks;
+        split_ticks += other.split_ticks;
+        convert_ticks += other.convert_ticks;
+        return *this;
+    }
+};
+
+} /* ss */
@@ -0,0 +1,544 @@
+#pragma once
+#include "common.hpp"
+#include "converter.hpp"
+#include "error.hpp"
+#include "exception.hpp"
+#include "setup.hpp"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+namespace ss {
+
+////////////////
+// special characters
+////////////////
+
+// checks if any of the characters of the range is one of the given
+// characters, eight characters are checked at once by comparing each of
+// the bytes of a word, the characters are expected to be few
+inline bool contains_any(const char* begin, size_t size,
+                         std::string_view chars) {
+    constexpr uint64_t ones = 0x0101010101010101ull;
+    constexpr uint64_t highs = 0x8080808080808080ull;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, begin + i, sizeof(uint64_t));
+
+        uint64_t found = 0;
+        for (char c : chars) {
+            // a zero byte remains where the character matches
+            uint64_t x = word ^ (ones * static_cast<unsigned char>(c));
+            found |= (x - ones) & ~x & highs;
+        }
+
+        if (found != 0) {
+            return true;
+        }
+    }
+
+    for (; i < size; ++i) {
+        if (chars.find(begin[i]) != std::string_view::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+////////////////
+// row block
+////////////////
+
+// rows formatted in memory using the rules of the writer, fields are
+// quoted or escaped only if they contain special characters, blocks can be
+// formatted on multiple threads and written using the parallel writer
+template <typename... Options>
+class row_block {
+    using quote = typename setup<Options...>::quote;
+    using escape = typename setup<Options...>::escape;
+    using trim_left = typename setup<Options...>::trim_left;
+    using trim_right = typename setup<Options...>::trim_right;
+
+    // enough for any number written using to_chars
+    constexpr static size_t max_number_size = 64;
+
+public:
+    row_block(const std::string& delim = ss::default_delimiter,
+              size_t capacity = 0)
+        : delim_{delim} {
+        special_ = delim_ + "\r\n";
+        if constexpr (quote::enabled) {
+            special_.append(quote::matches.begin(), quote::matches.end());
+        }
+        if constexpr (escape::enabled) {
+            special_.append(escape::matches.begin(), escape::matches.end());
+        }
+        reserve(capacity);
+    }
+
+    row_block(row_block&& other) = default;
+    row_block& operator=(row_block&& other) = default;
+
+    row_block(const row_block& other) = delete;
+    row_block& operator=(const row_block& other) = delete;
+
+    // appends one row, the values can be given separately, as a tuple or
+    // as a non const object with a 'tied' method, returns false and
+    // leaves the block unchanged if a field cannot be written
+    template <typename T, typename... Ts>
+    bool write(T&& value, Ts&&... values) {
+        using U = std::decay_t<T>;
+        if constexpr (sizeof...(Ts) == 0 && is_instance_of_v<std::tuple, U>) {
+            return std::apply(
+                [this](auto&&... vs) { return write_row(vs...); }, value);
+        } else if constexpr (tied_class_v<U>) {
+            auto refs = value.tied();
+            return std::apply(
+                [this](auto&&... vs) { return write_row(vs...); }, refs);
+        } else {
+            return write_row(value, values...);
+        }
+    }
+
+    const char* data() const {
+        return buffer_.get();
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    // removes the rows but keeps the memory
+    void clear() {
+        size_ = 0;
+    }
+
+    // index of the column which could not be written by the last 'write'
+    size_t invalid_column() const {
+        return invalid_column_;
+    }
+
+private:
+    template <typename... Ts>
+    bool write_row(const Ts&... values) {
+        size_t row_begin = size_;
+        size_t column = 0;
+        if (!(write_column(values, column) && ...)) {
+            size_ = row_begin;
+            invalid_column_ = column;
+            return false;
+        }
+
+        // replace the last delimiter
+        size_ -= delim_.size();
+        if constexpr (quote::enabled) {
+            // an empty line would be read as a row without columns
+            if (size_ == row_begin) {
+                write_plain({quote::matches.data(), 1});
+                write_plain({quote::matches.data(), 1});
+            }
+        }
+        write_plain("\n");
+        return true;
+    }
+
+    // writes the field followed by the delimiter
+    template <typename T>
+    bool write_column(const T& value, size_t& column) {
+        if (!write_field(value)) {
+            return false;
+        }
+
+        write_plain(delim_);
+        ++column;
+        return true;
+    }
+
+    ////////////////
+    // fields
+    ////////////////
+    template <typename T>
+    bool write_field(const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            return write_plain(value ? "true" : "false");
+        } else if constexpr (std::is_same_v<T, char>) {
+            return write_string(std::string_view{&value, 1});
+        } else if constexpr (std::is_integral_v<T>) {
+            reserve(max_number_size);
+            char* begin = buffer_.get() + size_;
+            auto result = std::to_chars(begin, begin + max_number_size, value);
+            size_ += result.ptr - begin;
+            return true;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            write_floating_point(value);
+            return true;
+        } else if constexpr (std::is_convertible_v<T, std::string_view>) {
+            return write_string(std::string_view{value});
+        } else if constexpr (is_instance_of_v<std::optional, T>) {
+            return !value.has_value() || write_field(*value);
+        } else if constexpr (is_instance_of_v<std::variant, T>) {
+            return std::visit([this](const auto& v) { return write_field(v); },
+                              value);
+        } else {
+            static_assert(!std::is_same_v<T, T>,
+                          "writing this type is not supported");
+        }
+    }
+
+    template <typename T>
+    void write_floating_point(T value) {
+        reserve(max_number_size);
+        char* begin = buffer_.get() + size_;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        // the shortest representation which is read back as the same value
+        auto result = std::to_chars(begin, begin + max_number_size, value);
+        size_ += result.ptr - begin;
+#else
+        constexpr int digits = std::numeric_limits<T>::max_digits10;
+        int size = std::snprintf(begin, max_number_size, "%.*Lg", digits,
+                                 static_cast<long double>(value));
+        size_ += static_cast<size_t>(size);
+#endif
+    }
+
+    bool write_plain(std::string_view value) {
+        reserve(value.size());
+        std::memcpy(buffer_.get() + size_, value.data(), value.size());
+        size_ += value.size();
+        return true;
+    }
+
+    bool write_string(std::string_view value) {
+        if (!contains_any(value.data(), value.size(), special_) &&
+            !trimmed(value)) {
+            return write_plain(value);
+        }
+
+        if constexpr (quote::enabled) {
+            write_quoted(value);
+            return true;
+        } else if constexpr (escape::enabled) {
+            if (trimmed(value)) {
+                return false;
+            }
+            write_escaped(value);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    // quotes within the field are doubled, escape characters are escaped
+    void write_quoted(std::string_view value) {
+        reserve(2 * value.size() + 2);
+        char* out = buffer_.get() + size_;
+        *out++ = quote::matches[0];
+        for (char c : value) {
+            if (quote::match(c)) {
+                *out++ = c;
+            } else if constexpr (escape::enabled) {
+                if (escape::match(c)) {
+                    *out++ = escape::matches[0];
+                }
+            }
+            *out++ = c;
+        }
+        *out++ = quote::matches[0];
+        size_ = out - buffer_.get();
+    }
+
+    void write_escaped(std::string_view value) {
+        reserve(2 * value.size());
+        char* out = buffer_.get() + size_;
+        for (char c : value) {
+            if (special_.find(c) != std::string::npos) {
+                *out++ = escape::matches[0];
+            }
+            *out++ = c;
+        }
+        size_ = out - buffer_.get();
+    }
+
+    // fields which start or end with characters removed by trimming
+    bool trimmed(std::string_view value) const {
+        if (value.empty()) {
+            return false;
+        }
+
+        if constexpr (trim_left::enabled) {
+            if (trim_left::match(value.front())) {
+                return true;
+            }
+        }
+
+        if constexpr (trim_right::enabled) {
+            if (trim_right::match(value.back())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ////////////////
+    // buffer
+    ////////////////
+
+    // makes space for 'size' more characters
+    void reserve(size_t size) {
+        if (size_ + size <= capacity_) {
+            return;
+        }
+
+        size_t capacity = std::max(2 * capacity_, size_ + size);
+        std::unique_ptr<char[]> buffer{new char[capacity]};
+        if (size_ > 0) {
+            std::memcpy(buffer.get(), buffer_.get(), size_);
+        }
+        buffer_ = std::move(buffer);
+        capacity_ = capacity;
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    std::string delim_;
+
+    // characters which need quoting or escaping
+    std::string special_;
+
+    std::unique_ptr<char[]> buffer_;
+    size_t capacity_{0};
+    size_t size_{0};
+    size_t invalid_column_{0};
+};
+
+////////////////
+// writer
+////////////////
+
+// writes rows into a file using the same setup as the parser, so the
+// written file can be read by a parser with the same setup, the rows are
+// formatted into a large buffer which is written once it is full, fields
+// which contain new lines need the 'multiline' setup option when read
+template <typename... Options>
+class writer {
+    constexpr static auto string_error = setup<Options...>::string_error;
+    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
+
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
+
+public:
+    constexpr static size_t default_buffer_size = 1024 * 1024;
+
+    writer(const std::string& file_name,
+           const std::string& delim = ss::default_delimiter,
+           size_t buffer_size = default_buffer_size)
+        : file_name_{file_name}, buffer_size_{buffer_size},
+          file_{fopen(file_name.c_str(), "wb")} {
+        if (!file_) {
+            handle_error_file_not_open();
+            return;
+        }
+
+        // the output is already buffered
+        setvbuf(file_.get(), nullptr, _IONBF, 0);
+
+        // some space is left for the last row before the buffer is written
+        block_ = row_block<Options...>{delim, buffer_size_ + buffer_size_ / 4};
+    }
+
+    writer(writer&& other) = default;
+
+    writer& operator=(writer&& other) {
+        if (this != &other) {
+            write_buffer();
+            file_name_ = std::move(other.file_name_);
+            error_ = std::move(other.error_);
+            buffer_size_ = other.buffer_size_;
+            block_ = std::move(other.block_);
+            file_ = std::move(other.file_);
+        }
+        return *this;
+    }
+
+    writer(const writer& other) = delete;
+    writer& operator=(const writer& other) = delete;
+
+    // the remaining rows are written, errors are ignored
+    ~writer() {
+        write_buffer();
+    }
+
+    bool valid() const {
+        if constexpr (string_error) {
+            return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
+        } else if constexpr (throw_on_error) {
+            return true;
+        } else {
+            return !error_;
+        }
+    }
+
+    const std::string& error_msg() const {
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = file_name_ + ": " + error_.message();
+            return error_msg_;
+        } else {
+            return error_;
+        }
+    }
+
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
+        return error_;
+    }
+
+    // writes one row, the values can be given separately, as a tuple or as
+    // a non const object with a 'tied' method, if a field cannot be written
+    // the whole row is discarded
+    template <typename T, typename... Ts>
+    void write(T&& value, Ts&&... values) {
+        clear_error();
+        if (!file_) {
+            handle_error_file_not_open();
+            return;
+        }
+
+        if (!block_.write(std::forward<T>(value),
+                          std::forward<Ts>(values)...)) {
+            handle_error_invalid_output_field(block_.invalid_column());
+            return;
+        }
+
+        if (block_.size() >= buffer_size_ && !write_buffer()) {
+            handle_error_write_failed();
+        }
+    }
+
+    // writes the buffered rows into the file
+    void flush() {
+        if (!write_buffer()) {
+            handle_error_write_failed();
+            return;
+        }
+
+        if (file_) {
+            fflush(file_.get());
+        }
+    }
+
+private:
+    struct file_closer {
+        void operator()(FILE* file) const {
+            fclose(file);
+        }
+    };
+
+    bool write_buffer() {
+        if (!file_ || block_.empty()) {
+            return true;
+        }
+
+        size_t size = block_.size();
+        size_t written = fwrite(block_.data(), 1, size, file_.get());
+        block_.clear();
+        return written == size;
+    }
+
+    ////////////////
+    // error
+    ////////////////
+    void clear_error() {
+        if constexpr (string_error) {
+            error_.clear();
+        } else if constexpr (structured_error) {
+            error_.code = error_code::none;
+        } else {
+            error_ = false;
+        }
+    }
+
+    void handle_error_file_not_open() {
+        constexpr static auto error_msg = " could not be opened";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::file_not_open);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_write_failed() {
+        constexpr static auto error_msg = " write failed";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::write_failed);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_invalid_output_field(size_t column) {
+        constexpr static auto error_msg =
+            "field cannot be written without quoting or escaping at column ";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg).append(std::to_string(column + 1));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::invalid_output_field);
+            error_.column = column;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg + std::to_string(column + 1)};
+        } else {
+            error_ = true;
+        }
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    std::string file_name_;
+    error_type error_{};
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
+
+    size_t buffer_size_;
+    row_block<Options...> block_;
+    std::unique_ptr<FILE, file_closer> file_;
+};
+
+} /* ss */
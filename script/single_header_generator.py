@@ -6,22 +6,40 @@ headers = ['type_traits.hpp',
            'function_traits.hpp',
            'restrictions.hpp',
            'common.hpp',
+           'memory.hpp',
+           'probe.hpp',
+           'generator.hpp',
+           'error.hpp',
+           'reject.hpp',
            'setup.hpp',
+           'split_table.hpp',
            'splitter.hpp',
            'extract.hpp',
+           'arena.hpp',
+           'stats.hpp',
            'converter.hpp',
-           'parser.hpp']
+           'parser.hpp',
+           'push_parser.hpp',
+           'writer.hpp',
+           'parallel_writer.hpp']
 
 combined_file = []
 includes = []
 
 for header in headers:
     with open(headers_dir + header) as f:
+        # includes within conditional blocks are kept in place
+        depth = 0
         for line in f.read().splitlines():
+            if line.startswith('#if'):
+                depth += 1
+            elif line.startswith('#endif'):
+                depth -= 1
+
             if '#include "' in line or '#include <fast_float' in line:
                 continue
 
-            if '#include <' in line:
+            if '#include <' in line and depth == 0:
                 includes.append(line)
                 continue
 
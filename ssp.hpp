@@ -1,18 +1,29 @@
 #include <algorithm>
 #include <array>
+#include <cassert>
+#include <cctype>
+#include <cerrno>
 #include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
 #include <functional>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 #define SSP_DISABLE_FAST_FLOAT
@@ -629,7 +640,15 @@ constexpr inline auto default_delimiter = ",";
 template <bool StringError>
 inline void assert_string_error_defined() {
     static_assert(StringError,
-                  "'string_error' needs to be enabled to use 'error_msg'");
+                  "'string_error' or 'structured_error' needs to be enabled "
+                  "to use 'error_msg'");
+}
+
+template <bool StructuredError>
+inline void assert_structured_error_defined() {
+    static_assert(StructuredError,
+                  "'structured_error' needs to be enabled to use "
+                  "'error_info'");
 }
 
 template <bool ThrowOnError>
@@ -696,1454 +715,5784 @@ inline ssize_t get_line(char** lineptr, size_t* n, FILE* stream) {
 
 } /* ss */
 
+// polymorphic memory resources are not available in older standard
+// libraries, eg. libstdc++ of gcc 8
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define SSP_HAS_PMR 1
+#endif
+#endif
+
 namespace ss {
 
 ////////////////
-// matcher
+// memory resource
 ////////////////
 
-template <char... Cs>
-struct matcher {
-private:
-    template <char X, char... Xs>
-    static bool match_impl(char c) {
-        if constexpr (sizeof...(Xs) != 0) {
-            return (c == X) || match_impl<Xs...>(c);
-        }
-        return (c == X);
-    }
+#ifdef SSP_HAS_PMR
+using memory_resource = std::pmr::memory_resource;
 
-    constexpr static bool contains_string_terminator() {
-        for (const auto& match : matches) {
-            if (match == '\0') {
-                return false;
-            }
-        }
-        return true;
-    }
+template <typename T>
+using resource_allocator = std::pmr::polymorphic_allocator<T>;
 
-public:
-    static bool match(char c) {
-        return match_impl<Cs...>(c);
-    }
+inline memory_resource* default_memory_resource() {
+    return std::pmr::get_default_resource();
+}
+#else
+// only declared, the 'use_pmr' setup option cannot be used
+class memory_resource;
 
-    constexpr static bool enabled = true;
-    constexpr static std::array<char, sizeof...(Cs)> matches{Cs...};
-    static_assert(contains_string_terminator(),
-                  "string terminator cannot be used as a match character");
-};
+template <typename T>
+using resource_allocator = std::allocator<T>;
 
-template <typename FirstMatcher, typename SecondMatcher>
-inline constexpr bool matches_intersect() {
-    for (const auto& first_match : FirstMatcher::matches) {
-        for (const auto& second_match : SecondMatcher::matches) {
-            if (first_match != '\0' && first_match == second_match) {
-                return true;
-            }
-        }
-    }
-    return false;
+inline memory_resource* default_memory_resource() {
+    return nullptr;
 }
+#endif
 
-template <typename FirstMatcher, typename SecondMatcher1,
-          typename SecondMatcher2>
-inline constexpr bool matches_intersect_union() {
-    return matches_intersect<FirstMatcher, SecondMatcher1>() ||
-           matches_intersect<FirstMatcher, SecondMatcher2>();
-}
+// containers which allocate using the memory resource given to the parser,
+// the converter or the splitter if 'Pmr' is true, the default allocator is
+// used otherwise
+template <bool Pmr, typename T>
+using allocator_t =
+    std::conditional_t<Pmr, resource_allocator<T>, std::allocator<T>>;
 
-template <>
-class matcher<'\0'> {
-public:
-    constexpr static bool enabled = false;
-    constexpr static std::array<char, 1> matches{'\0'};
-    static bool match(char c) = delete;
-};
+template <bool Pmr, typename T>
+using vector_t = std::vector<T, allocator_t<Pmr, T>>;
 
-////////////////
-// setup
-////////////////
+template <bool Pmr>
+using string_t =
+    std::basic_string<char, std::char_traits<char>, allocator_t<Pmr, char>>;
 
-////////////////
-// matcher
-////////////////
+// fixed size replacement of split_data used if the 'max_columns' setup
+// option is defined, the splitter stops before the capacity is exceeded
+template <size_t N>
+class inline_split_data {
+public:
+    using value_type = string_range;
+    using iterator = string_range*;
+    using const_iterator = const string_range*;
+
+    template <typename Begin, typename End>
+    void emplace_back(Begin begin, End end) {
+        assert(size_ < N);
+        data_[size_++] = string_range{begin, end};
+    }
 
-template <char C>
-struct quote : matcher<C> {};
+    void pop_back() {
+        --size_;
+    }
 
-template <char... Cs>
-struct trim : matcher<Cs...> {};
+    void clear() {
+        size_ = 0;
+    }
 
-template <char... Cs>
-struct trim_left : matcher<Cs...> {};
+    void reserve(size_t) {
+    }
 
-template <char... Cs>
-struct trim_right : matcher<Cs...> {};
+    size_t size() const {
+        return size_;
+    }
 
-template <char... Cs>
-struct escape : matcher<Cs...> {};
+    bool empty() const {
+        return size_ == 0;
+    }
 
-template <typename T, template <char...> class Template>
-struct is_instance_of_matcher : std::false_type {};
+    constexpr static size_t capacity() {
+        return N;
+    }
 
-template <char... Ts, template <char...> class Template>
-struct is_instance_of_matcher<Template<Ts...>, Template> : std::true_type {};
+    string_range& operator[](size_t i) {
+        return data_[i];
+    }
 
-template <typename T, template <char...> class Template>
-using is_instance_of_matcher_t =
-    typename is_instance_of_matcher<T, Template>::type;
+    const string_range& operator[](size_t i) const {
+        return data_[i];
+    }
 
-template <template <char...> class Matcher, typename... Ts>
-struct get_matcher;
+    iterator begin() {
+        return data_.data();
+    }
 
-template <template <char...> class Matcher, typename T, typename... Ts>
-struct get_matcher<Matcher, T, Ts...> {
+    iterator end() {
+        return data_.data() + size_;
+    }
 
-    template <typename U>
-    struct is_matcher : is_instance_of_matcher<U, Matcher> {};
+    const_iterator begin() const {
+        return data_.data();
+    }
 
-    static_assert(count_v<is_matcher, T, Ts...> <= 1,
-                  "the same matcher cannot"
-                  "be defined multiple times");
-    using type = std::conditional_t<is_matcher<T>::value, T,
-                                    typename get_matcher<Matcher, Ts...>::type>;
-};
+    const_iterator end() const {
+        return data_.data() + size_;
+    }
 
-template <template <char...> class Matcher>
-struct get_matcher<Matcher> {
-    using type = Matcher<'\0'>;
+private:
+    std::array<string_range, N> data_;
+    size_t size_{0};
 };
 
-template <template <char...> class Matcher, typename... Ts>
-using get_matcher_t = typename get_matcher<Matcher, Ts...>::type;
+template <bool Pmr>
+allocator_t<Pmr, char> make_allocator(memory_resource* resource) {
+    if constexpr (Pmr) {
+        return resource_allocator<char>{resource};
+    } else {
+        (void)resource;
+        return {};
+    }
+}
 
-////////////////
-// multiline
-////////////////
+#ifdef SSP_HAS_PMR
+// the same as get_line, but the buffer is allocated using the memory
+// resource, 'n' needs to be the exact size of the buffer since it is
+// needed to deallocate it
+inline ssize_t get_line(char** lineptr, size_t* n, FILE* stream,
+                        memory_resource* resource) {
+#if __unix__
+    // the stream is locked once per line instead of once per character,
+    // the allocation may throw
+    struct stream_lock {
+        stream_lock(FILE* stream) : stream_{stream} {
+            flockfile(stream_);
+        }
 
-template <size_t S, bool B = true>
-struct multiline_restricted {
-    constexpr static auto size = S;
-    constexpr static auto enabled = B;
-};
+        ~stream_lock() {
+            funlockfile(stream_);
+        }
 
-using multiline = multiline_restricted<0>;
+        FILE* stream_;
+    } lock{stream};
+    auto next_char = [stream] { return getc_unlocked(stream); };
+#else
+    auto next_char = [stream] { return getc(stream); };
+#endif
 
-template <typename T>
-struct is_instance_of_multiline : std::false_type {};
+    size_t pos = 0;
+    for (int c = next_char(); c != EOF; c = next_char()) {
+        if (pos + 1 >= *n) {
+            size_t new_size = std::max<size_t>(2 * *n, 128);
+            auto new_ptr = static_cast<char*>(resource->allocate(new_size, 1));
+            if (*lineptr != nullptr) {
+                std::copy_n(*lineptr, pos, new_ptr);
+                resource->deallocate(*lineptr, *n, 1);
+            }
+            *n = new_size;
+            *lineptr = new_ptr;
+        }
 
-template <size_t S, bool B>
-struct is_instance_of_multiline<multiline_restricted<S, B>> : std::true_type {};
+        (*lineptr)[pos++] = c;
+        if (c == '\n') {
+            break;
+        }
+    }
 
-template <typename T>
-using is_instance_of_multiline_t = typename is_instance_of_multiline<T>::type;
+    if (pos == 0) {
+        return -1;
+    }
 
-template <typename... Ts>
-struct get_multiline;
+    (*lineptr)[pos] = '\0';
+    return pos;
+}
+#else
+// only declared, called only if 'use_pmr' is enabled
+ssize_t get_line(char** lineptr, size_t* n, FILE* stream,
+                 memory_resource* resource);
+#endif
 
-template <typename T, typename... Ts>
-struct get_multiline<T, Ts...> {
-    using type = std::conditional_t<is_instance_of_multiline<T>::value, T,
-                                    typename get_multiline<Ts...>::type>;
-};
+} /* ss */
 
-template <>
-struct get_multiline<> {
-    using type = multiline_restricted<0, false>;
-};
+// static tracepoints for SystemTap, bpftrace or perf, enabled by defining
+// SSP_ENABLE_USDT if <sys/sdt.h> is available, each one is a single nop
+// instruction until a tracer is attached, eg:
+//     bpftrace -e 'usdt:./app:ssp:record_end { @[arg1] = count(); }'
+// the probes of the 'ssp' provider, with their arguments:
+//     file_open(const char* file_name, int opened)
+//     read_line(size_t line, size_t bytes)
+//     record_start(size_t line)
+//     multiline_join(size_t line, size_t bytes)
+//     conversion_error(size_t line, int error_code)
+//     record_end(size_t line, int valid)
+//     batch_complete(size_t rows)
+//     write_batch(size_t blocks, size_t bytes)
+#if defined(SSP_ENABLE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SSP_USDT_ENABLED 1
+#endif
+#endif
 
-template <typename... Ts>
-using get_multiline_t = typename get_multiline<Ts...>::type;
+#ifdef SSP_USDT_ENABLED
+#define SSP_PROBE1(name, a) DTRACE_PROBE1(ssp, name, a)
+#define SSP_PROBE2(name, a, b) DTRACE_PROBE2(ssp, name, a, b)
+#else
+#define SSP_PROBE1(name, a) ((void)0)
+#define SSP_PROBE2(name, a, b) ((void)0)
+#endif
 
-////////////////
-// string_error
-////////////////
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine) &&                \
+    defined(__has_include)
+#if __has_include(<coroutine>)
+#define SSP_HAS_COROUTINES
+#endif
+#endif
 
-class string_error;
+#ifdef SSP_HAS_COROUTINES
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace ss {
 
 ////////////////
-// ignore_header
+// generator
 ////////////////
 
-class ignore_header;
+// coroutine which yields references to values it owns, similar to
+// std::generator<T&>, available only if coroutines are supported, the
+// generator can be iterated over, or driven manually using 'next' and
+// 'value', eg. by a scheduler which interleaves multiple inputs
+template <typename T>
+class generator {
+public:
+    struct promise_type {
+        generator get_return_object() {
+            return generator{handle::from_promise(*this)};
+        }
 
-////////////////
-// ignore_empty
-////////////////
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
 
-class ignore_empty;
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
 
-////////////////
-// throw_on_error
-////////////////
+        std::suspend_always yield_value(T& value) noexcept {
+            value_ = std::addressof(value);
+            return {};
+        }
 
-class throw_on_error;
+        void return_void() noexcept {
+        }
 
-////////////////
-// setup implementation
-////////////////
+        void unhandled_exception() {
+            exception_ = std::current_exception();
+        }
 
-template <typename... Options>
-struct setup {
-private:
-    template <typename Option>
-    struct is_matcher
-        : std::disjunction<is_instance_of_matcher_t<Option, quote>,
-                           is_instance_of_matcher_t<Option, escape>,
-                           is_instance_of_matcher_t<Option, trim>,
-                           is_instance_of_matcher_t<Option, trim_left>,
-                           is_instance_of_matcher_t<Option, trim_right>> {};
+        T* value_{nullptr};
+        std::exception_ptr exception_;
+    };
 
-    template <typename T>
-    struct is_string_error : std::is_same<T, string_error> {};
+    using handle = std::coroutine_handle<promise_type>;
 
-    template <typename T>
-    struct is_ignore_header : std::is_same<T, ignore_header> {};
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
 
-    template <typename T>
-    struct is_ignore_empty : std::is_same<T, ignore_empty> {};
+        iterator() = default;
 
-    template <typename T>
-    struct is_throw_on_error : std::is_same<T, throw_on_error> {};
+        explicit iterator(generator* generator) : generator_{generator} {
+        }
 
-    constexpr static auto count_matcher = count_v<is_matcher, Options...>;
+        iterator& operator++() {
+            generator_->next();
+            return *this;
+        }
 
-    constexpr static auto count_multiline =
-        count_v<is_instance_of_multiline, Options...>;
+        void operator++(int) {
+            ++*this;
+        }
 
-    constexpr static auto count_string_error =
-        count_v<is_string_error, Options...>;
+        T& operator*() const {
+            return generator_->value();
+        }
 
-    constexpr static auto count_ignore_header =
-        count_v<is_ignore_header, Options...>;
+        T* operator->() const {
+            return &generator_->value();
+        }
 
-    constexpr static auto count_throw_on_error =
-        count_v<is_throw_on_error, Options...>;
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return it.generator_ == nullptr || it.generator_->done();
+        }
 
-    constexpr static auto count_ignore_empty =
-        count_v<is_ignore_empty, Options...>;
+    private:
+        generator* generator_{nullptr};
+    };
 
-    constexpr static auto number_of_valid_setup_types =
-        count_matcher + count_multiline + count_string_error +
-        count_ignore_header + count_ignore_empty + count_throw_on_error;
+    generator(generator&& other) noexcept
+        : handle_{std::exchange(other.handle_, nullptr)} {
+    }
 
-    using trim_left_only = get_matcher_t<trim_left, Options...>;
-    using trim_right_only = get_matcher_t<trim_right, Options...>;
-    using trim_all = get_matcher_t<trim, Options...>;
+    generator& operator=(generator&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
 
-public:
-    using quote = get_matcher_t<quote, Options...>;
-    using escape = get_matcher_t<escape, Options...>;
-
-    using trim_left =
-        std::conditional_t<trim_all::enabled, trim_all, trim_left_only>;
-    using trim_right =
-        std::conditional_t<trim_all::enabled, trim_all, trim_right_only>;
+    generator(const generator& other) = delete;
+    generator& operator=(const generator& other) = delete;
 
-    using multiline = get_multiline_t<Options...>;
-    constexpr static bool string_error = (count_string_error == 1);
-    constexpr static bool ignore_header = (count_ignore_header == 1);
-    constexpr static bool ignore_empty = (count_ignore_empty == 1);
-    constexpr static bool throw_on_error = (count_throw_on_error == 1);
-
-private:
-#define ASSERT_MSG "cannot have the same match character in multiple matchers"
-    static_assert(!matches_intersect<escape, quote>(), ASSERT_MSG);
+    ~generator() {
+        destroy();
+    }
 
-    constexpr static auto quote_trim_intersect =
-        matches_intersect_union<quote, trim_left, trim_right>();
-    static_assert(!quote_trim_intersect, ASSERT_MSG);
+    // resumes the coroutine until the next value is yielded, returns false
+    // if there are no more values, rethrows exceptions from the coroutine
+    bool next() {
+        if (done()) {
+            return false;
+        }
 
-    constexpr static auto escape_trim_intersect =
-        matches_intersect_union<escape, trim_left, trim_right>();
-    static_assert(!escape_trim_intersect, ASSERT_MSG);
+        handle_.resume();
+        if (auto exception = handle_.promise().exception_) {
+            handle_.promise().exception_ = nullptr;
+            std::rethrow_exception(exception);
+        }
+        return !handle_.done();
+    }
 
-#undef ASSERT_MSG
+    // the last yielded value, valid until 'next' is called
+    T& value() const {
+        return *handle_.promise().value_;
+    }
 
-    static_assert(
-        !multiline::enabled ||
-            (multiline::enabled && (quote::enabled || escape::enabled)),
-        "to enable multiline either quote or escape needs to be enabled");
+    bool done() const {
+        return !handle_ || handle_.done();
+    }
 
-    static_assert(!(trim_all::enabled && trim_left_only::enabled) &&
-                      !(trim_all::enabled && trim_right_only::enabled),
-                  "ambiguous trim setup");
+    iterator begin() {
+        next();
+        return iterator{this};
+    }
 
-    static_assert(count_multiline <= 1, "mutliline defined multiple times");
+    std::default_sentinel_t end() const {
+        return {};
+    }
 
-    static_assert(count_string_error <= 1,
-                  "string_error defined multiple times");
+private:
+    explicit generator(handle handle) : handle_{handle} {
+    }
 
-    static_assert(count_throw_on_error <= 1,
-                  "throw_on_error defined multiple times");
+    void destroy() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
 
-    static_assert(count_throw_on_error + count_string_error <= 1,
-                  "cannot define both throw_on_error and string_error");
+    ////////////////
+    // members
+    ////////////////
 
-    static_assert(number_of_valid_setup_types == sizeof...(Options),
-                  "one or multiple invalid setup parameters defined");
+    handle handle_{nullptr};
 };
 
-template <typename... Options>
-struct setup<setup<Options...>> : setup<Options...> {};
-
 } /* ss */
+#endif
 
 namespace ss {
 
-template <typename... Options>
-class splitter {
-private:
-    using quote = typename setup<Options...>::quote;
-    using trim_left = typename setup<Options...>::trim_left;
-    using trim_right = typename setup<Options...>::trim_right;
-    using escape = typename setup<Options...>::escape;
-    using multiline = typename setup<Options...>::multiline;
+////////////////
+// error code
+////////////////
 
-    constexpr static auto string_error = setup<Options...>::string_error;
-    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
-    constexpr static auto is_const_line = !quote::enabled && !escape::enabled;
+enum class error_code : uint8_t {
+    none,
+    file_not_open,
+    eof_reached,
+    empty_delimiter,
+    mismatched_quote,
+    unterminated_escape,
+    unterminated_quote,
+    invalid_resplit,
+    multiline_limit_reached,
+    invalid_conversion,
+    validation_failed,
+    number_of_columns,
+    incompatible_mapping,
+    failed_check,
+    header_ignored,
+    invalid_field,
+    field_used_multiple_times,
+    empty_mapping,
+    invalid_header,
+    write_failed,
+    invalid_output_field,
+    missing_block,
+    record_too_large,
+    too_many_columns
+};
 
-    using error_type = std::conditional_t<string_error, std::string, bool>;
+// number of error codes, needs to be updated if one is added after the last
+constexpr inline size_t error_code_count =
+    static_cast<size_t>(error_code::too_many_columns) + 1;
+
+inline const char* error_code_name(error_code code) {
+    switch (code) {
+    case error_code::none:
+        return "none";
+    case error_code::file_not_open:
+        return "file not open";
+    case error_code::eof_reached:
+        return "read on end of file";
+    case error_code::empty_delimiter:
+        return "empty delimiter";
+    case error_code::mismatched_quote:
+        return "mismatched quote";
+    case error_code::unterminated_escape:
+        return "unterminated escape";
+    case error_code::unterminated_quote:
+        return "unterminated quote";
+    case error_code::invalid_resplit:
+        return "invalid resplit";
+    case error_code::multiline_limit_reached:
+        return "multiline limit reached";
+    case error_code::invalid_conversion:
+        return "invalid conversion";
+    case error_code::validation_failed:
+        return "validation failed";
+    case error_code::number_of_columns:
+        return "invalid number of columns";
+    case error_code::incompatible_mapping:
+        return "number of arguments does not match mapping";
+    case error_code::failed_check:
+        return "failed check";
+    case error_code::header_ignored:
+        return "header ignored";
+    case error_code::invalid_field:
+        return "header does not contain given field";
+    case error_code::field_used_multiple_times:
+        return "given field used multiple times";
+    case error_code::empty_mapping:
+        return "received empty mapping";
+    case error_code::invalid_header:
+        return "header contains duplicates";
+    case error_code::write_failed:
+        return "write failed";
+    case error_code::invalid_output_field:
+        return "field cannot be written without quoting or escaping";
+    case error_code::missing_block:
+        return "missing block";
+    case error_code::record_too_large:
+        return "record too large";
+    case error_code::too_many_columns:
+        return "too many columns";
+    }
+    return "unknown";
+}
 
-public:
-    using line_ptr_type = std::conditional_t<is_const_line, const char*, char*>;
+////////////////
+// error info
+////////////////
 
-    bool valid() const {
-        if constexpr (string_error) {
-            return error_.empty();
-        } else if constexpr (throw_on_error) {
-            return true;
-        } else {
-            return !error_;
-        }
-    }
+// compact description of an error used by the 'structured_error' setup
+// option, no memory is allocated when it is set, the message is formatted
+// only if requested
+struct error_info {
+    error_code code{error_code::none};
 
-    const std::string& error_msg() const {
-        assert_string_error_defined<string_error>();
-        return error_;
-    }
+    // line of the file, 0 if not related to a line
+    size_t line{0};
 
-    bool unterminated_quote() const {
-        return unterminated_quote_;
-    }
+    // index of the column, if related to one
+    size_t column{0};
 
-    const split_data& split(line_ptr_type new_line,
-                            const std::string& delimiter = default_delimiter) {
-        split_data_.clear();
-        line_ = new_line;
-        begin_ = line_;
-        return split_impl_select_delim(delimiter);
-    }
+    // byte offset of the field within the file when set by the parser,
+    // or within the line when set by the converter or the splitter
+    size_t offset{0};
 
-private:
-    ////////////////
-    // resplit
-    ////////////////
+    // raw content of the field, valid only until the next line is read
+    string_range raw{nullptr, nullptr};
 
-    // number of characters the end of line is shifted backwards
-    size_t size_shifted() const {
-        return escaped_;
-    }
+    // static message of the failed restriction, if any
+    const char* detail{nullptr};
 
-    void adjust_ranges(const char* old_line) {
-        for (auto& [begin, end] : split_data_) {
-            begin = begin - old_line + line_;
-            end = end - old_line + line_;
-        }
+    // expected and received number of columns or arguments
+    size_t expected{0};
+    size_t got{0};
+
+    bool valid() const {
+        return code == error_code::none;
     }
 
-    const split_data& resplit(
-        line_ptr_type new_line, ssize_t new_size,
-        const std::string& delimiter = default_delimiter) {
+    void set(error_code new_code) {
+        *this = error_info{};
+        code = new_code;
+    }
 
-        // resplitting, continue from last slice
-        if (!quote::enabled || !multiline::enabled || split_data_.empty() ||
-            !unterminated_quote()) {
-            handle_error_invalid_resplit();
-            return split_data_;
+    std::string message() const {
+        std::string msg;
+        msg.reserve(64);
+        switch (code) {
+        case error_code::mismatched_quote:
+            msg.append("mismatched quote at position: ")
+                .append(std::to_string(offset));
+            break;
+        case error_code::invalid_conversion:
+            msg.append("invalid conversion for parameter ");
+            append_field(msg);
+            break;
+        case error_code::validation_failed:
+            msg.append(detail ? detail : "validation error").append(" ");
+            append_field(msg);
+            break;
+        case error_code::invalid_output_field:
+            msg.append(error_code_name(code)).append(" ");
+            append_field(msg);
+            break;
+        case error_code::number_of_columns:
+        case error_code::incompatible_mapping:
+            msg.append(error_code_name(code))
+                .append(", expected: ")
+                .append(std::to_string(expected))
+                .append(", got: ")
+                .append(std::to_string(got));
+            break;
+        case error_code::record_too_large:
+        case error_code::too_many_columns:
+            msg.append(error_code_name(code))
+                .append(", limit: ")
+                .append(std::to_string(expected));
+            break;
+        default:
+            msg.append(error_code_name(code));
+            break;
         }
+        return msg;
+    }
 
-        const auto [old_line, old_begin] = *std::prev(split_data_.end());
-        size_t begin = old_begin - old_line - 1;
-
-        // safety measure
-        if (new_size != -1 && static_cast<size_t>(new_size) < begin) {
-            handle_error_invalid_resplit();
-            return split_data_;
+private:
+    void append_field(std::string& msg) const {
+        msg.append("at column ").append(std::to_string(column + 1));
+        if (raw.first != nullptr) {
+            msg.append(": \'").append(raw.first, raw.second).append("\'");
         }
+    }
+};
 
-        // if unterminated quote, the last element is junk
-        split_data_.pop_back();
-
-        line_ = new_line;
-        adjust_ranges(old_line);
+} /* ss */
 
-        begin_ = line_ + begin;
-        end_ = line_ - old_line + end_ - escaped_;
-        curr_ = end_;
+namespace ss {
 
-        resplitting_ = true;
+////////////////
+// rejected record
+////////////////
 
-        return split_impl_select_delim(delimiter);
-    }
+// record passed to the reject sink of the parser, the raw view is valid
+// only during the invocation of the sink
+struct rejected_record {
+    // line of the file, the last one if the record spans multiple lines
+    size_t line;
 
-    ////////////////
-    // error
-    ////////////////
+    // content of the record as it was read, without the end of line
+    std::string_view raw;
 
-    void clear_error() {
-        if constexpr (string_error) {
-            error_.clear();
-        } else if constexpr (!throw_on_error) {
-            error_ = false;
-        }
-        unterminated_quote_ = false;
-    }
+    // detailed only if 'structured_error' is enabled, 'invalid_conversion'
+    // otherwise
+    error_code code;
+};
 
-    void handle_error_empty_delimiter() {
-        constexpr static auto error_msg = "empty delimiter";
+////////////////
+// reject file
+////////////////
 
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg);
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg};
-        } else {
-            error_ = true;
+// reject sink which writes the raw records verbatim into a file, one per
+// line, if a log file name is given the line number and the error of each
+// record is additionally written into it
+class reject_file {
+public:
+    constexpr static size_t default_buffer_size = 64 * 1024;
+
+    reject_file(const std::string& file_name,
+                const std::string& log_file_name = "",
+                size_t buffer_size = default_buffer_size)
+        : file_{open(file_name, buffer_size)} {
+        if (!log_file_name.empty()) {
+            log_ = open(log_file_name, buffer_size);
         }
     }
 
-    void handle_error_mismatched_quote(size_t n) {
-        constexpr static auto error_msg = "mismatched quote at position: ";
+    bool valid() const {
+        return file_ != nullptr;
+    }
 
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg + std::to_string(n));
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg + std::to_string(n)};
-        } else {
-            error_ = true;
+    void operator()(const rejected_record& record) const {
+        if (!file_) {
+            return;
         }
-    }
 
-    void handle_error_unterminated_escape() {
-        constexpr static auto error_msg =
-            "unterminated escape at the end of the line";
+        fwrite(record.raw.data(), 1, record.raw.size(), file_.get());
+        fputc('\n', file_.get());
 
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg);
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg};
-        } else {
-            error_ = true;
+        if (log_) {
+            std::string line = std::to_string(record.line);
+            fwrite(line.data(), 1, line.size(), log_.get());
+            fputc(' ', log_.get());
+            fputs(error_code_name(record.code), log_.get());
+            fputc('\n', log_.get());
         }
     }
 
-    void handle_error_unterminated_quote() {
-        constexpr static auto error_msg = "unterminated quote";
-
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg);
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg};
-        } else {
-            error_ = true;
+    // writes the buffered records, also done once the last copy of the
+    // sink is destroyed
+    void flush() const {
+        if (file_) {
+            fflush(file_.get());
+        }
+        if (log_) {
+            fflush(log_.get());
         }
     }
 
-    void handle_error_invalid_resplit() {
-        constexpr static auto error_msg =
-            "invalid resplit, new line must be longer"
-            "than the end of the last slice";
-
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg);
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg};
-        } else {
-            error_ = true;
+private:
+    static std::shared_ptr<FILE> open(const std::string& file_name,
+                                      size_t buffer_size) {
+        FILE* file = fopen(file_name.c_str(), "wb");
+        if (!file) {
+            return nullptr;
         }
+
+        setvbuf(file, nullptr, _IOFBF, buffer_size);
+        return std::shared_ptr<FILE>{file, [](FILE* f) { fclose(f); }};
     }
 
     ////////////////
-    // matching
+    // members
     ////////////////
 
-    bool match(const char* const curr, char delim) {
-        return *curr == delim;
-    };
+    std::shared_ptr<FILE> file_;
+    std::shared_ptr<FILE> log_;
+};
 
-    bool match(const char* const curr, const std::string& delim) {
-        return strncmp(curr, delim.c_str(), delim.size()) == 0;
-    };
+} /* ss */
 
-    size_t delimiter_size(char) {
-        return 1;
-    }
+namespace ss {
 
-    size_t delimiter_size(const std::string& delim) {
-        return delim.size();
-    }
+////////////////
+// matcher
+////////////////
 
-    void trim_left_if_enabled(line_ptr_type& curr) {
-        if constexpr (trim_left::enabled) {
-            while (trim_left::match(*curr)) {
-                ++curr;
-            }
+template <char... Cs>
+struct matcher {
+private:
+    template <char X, char... Xs>
+    static bool match_impl(char c) {
+        if constexpr (sizeof...(Xs) != 0) {
+            return (c == X) || match_impl<Xs...>(c);
         }
+        return (c == X);
     }
 
-    void trim_right_if_enabled(line_ptr_type& curr) {
-        if constexpr (trim_right::enabled) {
-            while (trim_right::match(*curr)) {
-                ++curr;
+    constexpr static bool contains_string_terminator() {
+        for (const auto& match : matches) {
+            if (match == '\0') {
+                return false;
             }
         }
+        return true;
     }
 
-    template <typename Delim>
-    std::tuple<size_t, bool> match_delimiter(line_ptr_type begin,
-                                             const Delim& delim) {
-        line_ptr_type end = begin;
-
-        trim_right_if_enabled(end);
-
-        // just spacing
-        if (*end == '\0') {
-            return {0, false};
-        }
-
-        // not a delimiter
-        if (!match(end, delim)) {
-            shift_if_escaped(end);
-            return {1 + end - begin, false};
-        }
-
-        end += delimiter_size(delim);
-        trim_left_if_enabled(end);
-
-        // delimiter
-        return {end - begin, true};
+public:
+    static bool match(char c) {
+        return match_impl<Cs...>(c);
     }
 
-    ////////////////
-    // shifting
-    ////////////////
+    constexpr static bool enabled = true;
+    constexpr static std::array<char, sizeof...(Cs)> matches{Cs...};
+    static_assert(contains_string_terminator(),
+                  "string terminator cannot be used as a match character");
+};
 
-    void shift_if_escaped(line_ptr_type& curr) {
-        if constexpr (escape::enabled) {
-            if (escape::match(*curr)) {
-                if (curr[1] == '\0') {
-                    if constexpr (!multiline::enabled) {
-                        handle_error_unterminated_escape();
-                    }
-                    done_ = true;
-                    return;
-                }
-                shift_and_jump_escape();
+template <typename FirstMatcher, typename SecondMatcher>
+inline constexpr bool matches_intersect() {
+    for (const auto& first_match : FirstMatcher::matches) {
+        for (const auto& second_match : SecondMatcher::matches) {
+            if (first_match != '\0' && first_match == second_match) {
+                return true;
             }
         }
     }
+    return false;
+}
 
-    void shift_and_jump_escape() {
-        shift_and_set_current();
-        if constexpr (!is_const_line) {
-            ++escaped_;
-        }
-        ++end_;
-    }
+template <typename FirstMatcher, typename SecondMatcher1,
+          typename SecondMatcher2>
+inline constexpr bool matches_intersect_union() {
+    return matches_intersect<FirstMatcher, SecondMatcher1>() ||
+           matches_intersect<FirstMatcher, SecondMatcher2>();
+}
 
-    void shift_push_and_start_next(size_t n) {
-        shift_and_push();
-        begin_ = end_ + n;
-    }
+template <>
+class matcher<'\0'> {
+public:
+    constexpr static bool enabled = false;
+    constexpr static std::array<char, 1> matches{'\0'};
+    static bool match(char c) = delete;
+};
 
-    void shift_and_push() {
-        shift_and_set_current();
-        split_data_.emplace_back(begin_, curr_);
-    }
+////////////////
+// setup
+////////////////
 
-    void shift_and_set_current() {
-        if constexpr (!is_const_line) {
-            if (escaped_ > 0) {
-                std::copy_n(curr_ + escaped_, end_ - curr_ - escaped_, curr_);
-                curr_ = end_ - escaped_;
-                return;
-            }
-        }
-        curr_ = end_;
-    }
+////////////////
+// matcher
+////////////////
 
-    ////////////////
-    // split impl
-    ////////////////
+template <char C>
+struct quote : matcher<C> {};
 
-    const split_data& split_impl_select_delim(
-        const std::string& delimiter = default_delimiter) {
-        clear_error();
-        switch (delimiter.size()) {
-        case 0:
-            handle_error_empty_delimiter();
-            return split_data_;
-        case 1:
-            return split_impl(delimiter[0]);
-        default:
-            return split_impl(delimiter);
-        }
-    }
+template <char... Cs>
+struct trim : matcher<Cs...> {};
 
-    template <typename Delim>
-    const split_data& split_impl(const Delim& delim) {
+template <char... Cs>
+struct trim_left : matcher<Cs...> {};
 
-        trim_left_if_enabled(begin_);
+template <char... Cs>
+struct trim_right : matcher<Cs...> {};
 
-        for (done_ = false; !done_; read(delim))
-            ;
+template <char... Cs>
+struct escape : matcher<Cs...> {};
 
-        return split_data_;
-    }
+template <typename T, template <char...> class Template>
+struct is_instance_of_matcher : std::false_type {};
 
-    ////////////////
-    // reading
-    ////////////////
+template <char... Ts, template <char...> class Template>
+struct is_instance_of_matcher<Template<Ts...>, Template> : std::true_type {};
 
-    template <typename Delim>
-    void read(const Delim& delim) {
-        escaped_ = 0;
-        if constexpr (quote::enabled) {
-            if constexpr (multiline::enabled) {
-                if (resplitting_) {
-                    resplitting_ = false;
-                    ++begin_;
-                    read_quoted(delim);
-                    return;
-                }
-            }
-            if (quote::match(*begin_)) {
-                curr_ = end_ = ++begin_;
-                read_quoted(delim);
-                return;
-            }
-        }
-        curr_ = end_ = begin_;
-        read_normal(delim);
-    }
+template <typename T, template <char...> class Template>
+using is_instance_of_matcher_t =
+    typename is_instance_of_matcher<T, Template>::type;
 
-    template <typename Delim>
-    void read_normal(const Delim& delim) {
-        while (true) {
-            auto [width, valid] = match_delimiter(end_, delim);
+template <template <char...> class Matcher, typename... Ts>
+struct get_matcher;
 
-            if (!valid) {
-                // not a delimiter
-                if (width == 0) {
-                    // eol
-                    shift_and_push();
-                    done_ = true;
-                    break;
-                } else {
-                    end_ += width;
-                    continue;
-                }
-            } else {
-                // found delimiter
-                shift_push_and_start_next(width);
-                break;
-            }
-        }
-    }
+template <template <char...> class Matcher, typename T, typename... Ts>
+struct get_matcher<Matcher, T, Ts...> {
 
-    template <typename Delim>
-    void read_quoted(const Delim& delim) {
-        if constexpr (quote::enabled) {
-            while (true) {
-                if (!quote::match(*end_)) {
-                    if constexpr (escape::enabled) {
-                        if (escape::match(*end_)) {
-                            if (end_[1] == '\0') {
-                                // eol, unterminated escape
-                                // eg: ... "hel\\0
-                                if constexpr (!multiline::enabled) {
-                                    handle_error_unterminated_escape();
-                                }
-                                done_ = true;
-                                break;
-                            }
-                            // not eol
+    template <typename U>
+    struct is_matcher : is_instance_of_matcher<U, Matcher> {};
 
-                            shift_and_jump_escape();
-                            ++end_;
-                            continue;
-                        }
-                    }
-                    // not escaped
+    static_assert(count_v<is_matcher, T, Ts...> <= 1,
+                  "the same matcher cannot"
+                  "be defined multiple times");
+    using type = std::conditional_t<is_matcher<T>::value, T,
+                                    typename get_matcher<Matcher, Ts...>::type>;
+};
 
-                    // eol, unterminated quote error
-                    // eg: ..."hell\0 -> quote not terminated
-                    if (*end_ == '\0') {
-                        shift_and_set_current();
-                        unterminated_quote_ = true;
-                        if constexpr (!multiline::enabled) {
-                            handle_error_unterminated_quote();
-                        }
-                        split_data_.emplace_back(line_, begin_);
-                        done_ = true;
-                        break;
-                    }
-                    // not eol
+template <template <char...> class Matcher>
+struct get_matcher<Matcher> {
+    using type = Matcher<'\0'>;
+};
 
-                    ++end_;
-                    continue;
-                }
-                // quote found
-                // ...
+template <template <char...> class Matcher, typename... Ts>
+using get_matcher_t = typename get_matcher<Matcher, Ts...>::type;
 
-                auto [width, valid] = match_delimiter(end_ + 1, delim);
+////////////////
+// multiline
+////////////////
 
-                // delimiter
-                if (valid) {
-                    shift_push_and_start_next(width + 1);
-                    break;
-                }
-                // not delimiter
+template <size_t S, bool B = true>
+struct multiline_restricted {
+    constexpr static auto size = S;
+    constexpr static auto enabled = B;
+};
 
-                // double quote
-                // eg: ...,"hel""lo",... -> hel"lo
-                if (quote::match(end_[1])) {
-                    shift_and_jump_escape();
-                    ++end_;
-                    continue;
-                }
-                // not double quote
+using multiline = multiline_restricted<0>;
 
-                if (width == 0) {
-                    // eol
-                    // eg: ...,"hello"   \0 -> hello
-                    // eg no trim: ...,"hello"\0 -> hello
-                    shift_and_push();
-                } else {
-                    // mismatched quote
-                    // eg: ...,"hel"lo,... -> error
-                    handle_error_mismatched_quote(end_ - line_);
-                    split_data_.emplace_back(line_, begin_);
-                }
-                done_ = true;
-                break;
-            }
-        }
-    }
+template <typename T>
+struct is_instance_of_multiline : std::false_type {};
 
-    ////////////////
-    // members
-    ////////////////
+template <size_t S, bool B>
+struct is_instance_of_multiline<multiline_restricted<S, B>> : std::true_type {};
 
-public:
-    error_type error_{};
-    bool unterminated_quote_{false};
-    bool done_{true};
-    bool resplitting_{false};
-    size_t escaped_{0};
-    split_data split_data_;
+template <typename T>
+using is_instance_of_multiline_t = typename is_instance_of_multiline<T>::type;
 
-    line_ptr_type begin_;
-    line_ptr_type curr_;
-    line_ptr_type end_;
-    line_ptr_type line_;
+template <typename... Ts>
+struct get_multiline;
 
-    template <typename...>
-    friend class converter;
+template <typename T, typename... Ts>
+struct get_multiline<T, Ts...> {
+    using type = std::conditional_t<is_instance_of_multiline<T>::value, T,
+                                    typename get_multiline<Ts...>::type>;
 };
 
-} /* ss */
-
-
-#ifndef SSP_DISABLE_FAST_FLOAT
-#else
-#endif
+template <>
+struct get_multiline<> {
+    using type = multiline_restricted<0, false>;
+};
 
-// TODO try from_chars for integer conversions
-namespace ss {
+template <typename... Ts>
+using get_multiline_t = typename get_multiline<Ts...>::type;
 
 ////////////////
-// number converters
+// null values
 ////////////////
 
-#ifndef SSP_DISABLE_FAST_FLOAT
-
-template <typename T>
-std::enable_if_t<std::is_floating_point_v<T>, std::optional<T>> to_num(
-    const char* const begin, const char* const end) {
-    T ret;
-    auto [ptr, ec] = fast_float::from_chars(begin, end, ret);
-
-    if (ec != std::errc() || ptr != end) {
-        return std::nullopt;
+// tokens which are converted to std::nullopt when extracting std::optional
+// values, they are given as pointers to null terminated constant arrays
+// with static storage duration, eg:
+//     constexpr char na[] = "NA";
+//     ss::null_values<na>
+template <auto... Tokens>
+struct null_values {
+private:
+    constexpr static std::array<size_t, sizeof...(Tokens)> sizes{
+        std::char_traits<char>::length(Tokens)...};
+
+    template <size_t... Is>
+    static bool match_impl(const char* const begin, size_t size,
+                           std::index_sequence<Is...>) {
+        return ((size == sizes[Is] &&
+                 std::memcmp(begin, Tokens, sizes[Is]) == 0) ||
+                ...);
     }
-    return ret;
-}
 
-#else
+public:
+    static bool match(const char* const begin, const char* const end) {
+        return match_impl(begin, end - begin,
+                          std::make_index_sequence<sizeof...(Tokens)>{});
+    }
 
-template <typename T>
-std::enable_if_t<std::is_floating_point_v<T>, std::optional<T>> to_num(
-    const char* const begin, const char* const end) {
-    constexpr static auto buff_max = 64;
-    char buff[buff_max];
-    size_t string_range = std::distance(begin, end);
+    constexpr static bool enabled = (sizeof...(Tokens) > 0);
+    constexpr static bool strict = false;
 
-    if (string_range > buff_max) {
-        return std::nullopt;
-    }
+    static_assert((std::is_same_v<decltype(Tokens), const char*> && ...),
+                  "null values need to be given as constant char arrays");
+};
 
-    std::copy_n(begin, string_range, buff);
-    buff[string_range] = '\0';
+// same as null_values, but values which are not null and cannot be
+// converted result in an error instead of std::nullopt
+template <auto... Tokens>
+struct null_values_strict : null_values<Tokens...> {
+    constexpr static bool strict = true;
+};
 
-    T ret;
-    char* parse_end = nullptr;
+template <typename T>
+struct is_instance_of_null_values : std::false_type {};
 
-    if constexpr (std::is_same_v<T, float>) {
-        ret = std::strtof(buff, &parse_end);
-    } else if constexpr (std::is_same_v<T, double>) {
-        ret = std::strtod(buff, &parse_end);
-    } else if constexpr (std::is_same_v<T, long double>) {
-        ret = std::strtold(buff, &parse_end);
-    }
+template <auto... Tokens>
+struct is_instance_of_null_values<null_values<Tokens...>> : std::true_type {};
 
-    if (parse_end != buff + string_range) {
-        return std::nullopt;
-    }
+template <auto... Tokens>
+struct is_instance_of_null_values<null_values_strict<Tokens...>>
+    : std::true_type {};
 
-    return ret;
-}
+template <typename... Ts>
+struct get_null_values;
 
-#endif
+template <typename T, typename... Ts>
+struct get_null_values<T, Ts...> {
+    using type = std::conditional_t<is_instance_of_null_values<T>::value, T,
+                                    typename get_null_values<Ts...>::type>;
+};
 
-template <typename T>
-std::enable_if_t<std::is_integral_v<T>, std::optional<T>> to_num(
-    const char* const begin, const char* const end) {
-    T ret;
-    auto [ptr, ec] = std::from_chars(begin, end, ret);
+template <>
+struct get_null_values<> {
+    using type = null_values<>;
+};
 
-    if (ec != std::errc() || ptr != end) {
-        return std::nullopt;
-    }
-    return ret;
-}
+template <typename... Ts>
+using get_null_values_t = typename get_null_values<Ts...>::type;
 
 ////////////////
-// extract
+// string_error
 ////////////////
 
-namespace error {
-template <typename T>
-struct unsupported_type {
-    constexpr static bool value = false;
-};
-} /* namespace */
+class string_error;
 
-template <typename T>
-std::enable_if_t<!std::is_integral_v<T> && !std::is_floating_point_v<T> &&
-                     !is_instance_of_v<std::optional, T> &&
-                     !is_instance_of_v<std::variant, T>,
-                 bool>
-extract(const char*, const char*, T&) {
-    static_assert(error::unsupported_type<T>::value,
-                  "Conversion for given type is not defined, an "
-                  "\'extract\' function needs to be defined!");
-}
+////////////////
+// structured_error
+////////////////
 
-template <typename T>
-std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool>
-extract(const char* begin, const char* end, T& value) {
-    auto optional_value = to_num<T>(begin, end);
-    if (!optional_value) {
-        return false;
-    }
-    value = optional_value.value();
-    return true;
-}
+// errors are stored as ss::error_info objects, additionally every
+// 'SampleRate'-th error can be recorded into a log, up to 'MaxRecorded'
+// errors (0 for no limit), if 'Record' is enabled
+template <size_t MaxRecorded, size_t SampleRate = 1, bool Record = true>
+struct structured_error_log {
+    constexpr static auto max_recorded = MaxRecorded;
+    constexpr static auto sample_rate = SampleRate;
+    constexpr static auto record = Record;
 
-template <typename T>
-std::enable_if_t<is_instance_of_v<std::optional, T>, bool> extract(
-    const char* begin, const char* end, T& value) {
-    typename T::value_type raw_value;
-    if (extract(begin, end, raw_value)) {
-        value = raw_value;
-    } else {
-        value = std::nullopt;
-    }
-    return true;
-}
+    static_assert(SampleRate > 0, "sample rate needs to be greater than 0");
+};
 
-template <typename T, size_t I>
-bool extract_variant(const char* begin, const char* end, T& value) {
-    using IthType = std::variant_alternative_t<I, std::decay_t<T>>;
-    IthType ithValue;
-    if (extract<IthType>(begin, end, ithValue)) {
-        value = ithValue;
-        return true;
-    } else if constexpr (I + 1 < std::variant_size_v<T>) {
-        return extract_variant<T, I + 1>(begin, end, value);
-    }
-    return false;
-}
+using structured_error = structured_error_log<0, 1, false>;
 
 template <typename T>
-std::enable_if_t<is_instance_of_v<std::variant, T>, bool> extract(
-    const char* begin, const char* end, T& value) {
-    return extract_variant<T, 0>(begin, end, value);
-}
+struct is_instance_of_structured_error_log : std::false_type {};
 
-////////////////
-// extract specialization
-////////////////
+template <size_t M, size_t S, bool R>
+struct is_instance_of_structured_error_log<structured_error_log<M, S, R>>
+    : std::true_type {};
 
-template <>
-inline bool extract(const char* begin, const char* end, bool& value) {
-    if (end == begin + 1) {
-        if (*begin == '1') {
-            value = true;
-        } else if (*begin == '0') {
-            value = false;
-        } else {
-            return false;
-        }
-    } else {
-        size_t size = end - begin;
-        if (size == 4 && strncmp(begin, "true", size) == 0) {
-            value = true;
-        } else if (size == 5 && strncmp(begin, "false", size) == 0) {
-            value = false;
-        } else {
-            return false;
-        }
-    }
+template <typename... Ts>
+struct get_structured_error_log;
 
-    return true;
-}
+template <typename T, typename... Ts>
+struct get_structured_error_log<T, Ts...> {
+    using type = std::conditional_t<
+        is_instance_of_structured_error_log<T>::value, T,
+        typename get_structured_error_log<Ts...>::type>;
+};
 
 template <>
-inline bool extract(const char* begin, const char* end, char& value) {
-    value = *begin;
-    return (end == begin + 1);
-}
+struct get_structured_error_log<> {
+    using type = structured_error;
+};
 
-template <>
-inline bool extract(const char* begin, const char* end, std::string& value) {
-    value = std::string{begin, end};
-    return true;
-}
+template <typename... Ts>
+using get_structured_error_log_t =
+    typename get_structured_error_log<Ts...>::type;
 
-template <>
-inline bool extract(const char* begin, const char* end,
-                    std::string_view& value) {
-    value = std::string_view{begin, static_cast<size_t>(end - begin)};
-    return true;
-}
+////////////////
+// ignore_header
+////////////////
 
-} /* ss */
+class ignore_header;
 
-namespace ss {
-INIT_HAS_METHOD(tied)
-INIT_HAS_METHOD(ss_valid)
-INIT_HAS_METHOD(error)
+////////////////
+// ignore_empty
+////////////////
+
+class ignore_empty;
 
 ////////////////
-// replace validator
+// throw_on_error
 ////////////////
 
-// replace 'validator' types with elements they operate on
-// eg. no_validator_tup_t<int, ss::nx<char, 'A', 'B'>> <=> std::tuple<int, char>
-// where ss::nx<char, 'A', 'B'> is a validator '(n)one e(x)cept' which
-// checks if the returned character is either 'A' or 'B', returns error if not
-// additionally if one element is left in the pack, it will be unwrapped from
-// the tuple eg. no_void_validator_tup_t<int> <=> int instead of std::tuple<int>
-template <typename T, typename U = void>
-struct no_validator;
+class throw_on_error;
 
-template <typename T>
-struct no_validator<T, typename std::enable_if_t<has_m_ss_valid_t<T>>> {
-    using type = typename member_wrapper<decltype(&T::ss_valid)>::arg_type;
-};
+////////////////
+// max_record_size
+////////////////
 
-template <typename T, typename U>
-struct no_validator {
-    using type = T;
+// records longer than 'Size' bytes, including the new lines of multiline
+// records, result in an error, 0 for no limit
+template <size_t Size>
+struct max_record_size {
+    constexpr static auto size = Size;
+    constexpr static auto enabled = (Size > 0);
 };
 
 template <typename T>
-using no_validator_t = typename no_validator<T>::type;
+struct is_instance_of_max_record_size : std::false_type {};
 
-template <typename... Ts>
-struct no_validator_tup : apply_trait<no_validator, std::tuple<Ts...>> {};
+template <size_t S>
+struct is_instance_of_max_record_size<max_record_size<S>> : std::true_type {};
 
 template <typename... Ts>
-struct no_validator_tup<std::tuple<Ts...>> : no_validator_tup<Ts...> {};
+struct get_max_record_size;
 
-template <typename T>
-struct no_validator_tup<std::tuple<T>> : no_validator<T> {};
+template <typename T, typename... Ts>
+struct get_max_record_size<T, Ts...> {
+    using type =
+        std::conditional_t<is_instance_of_max_record_size<T>::value, T,
+                           typename get_max_record_size<Ts...>::type>;
+};
+
+template <>
+struct get_max_record_size<> {
+    using type = max_record_size<0>;
+};
 
 template <typename... Ts>
-using no_validator_tup_t = typename no_validator_tup<Ts...>::type;
+using get_max_record_size_t = typename get_max_record_size<Ts...>::type;
 
 ////////////////
-// no void tuple
+// max_columns
 ////////////////
 
+// rows are split into a fixed size array of 'Size' elements instead of a
+// vector, rows with more columns result in an error
+template <size_t Size>
+struct max_columns {
+    static_assert(Size > 0, "max_columns needs to be greater than 0");
+    constexpr static auto size = Size;
+    constexpr static auto enabled = true;
+};
+
+template <typename T>
+struct is_instance_of_max_columns : std::false_type {};
+
+template <size_t S>
+struct is_instance_of_max_columns<max_columns<S>> : std::true_type {};
+
 template <typename... Ts>
-struct no_void_tup : filter_not<std::is_void, no_validator_tup_t<Ts...>> {};
+struct get_max_columns;
+
+template <typename T, typename... Ts>
+struct get_max_columns<T, Ts...> {
+    using type =
+        std::conditional_t<is_instance_of_max_columns<T>::value, T,
+                           typename get_max_columns<Ts...>::type>;
+};
+
+template <>
+struct get_max_columns<> {
+    struct type {
+        constexpr static size_t size = 0;
+        constexpr static bool enabled = false;
+    };
+};
 
 template <typename... Ts>
-using no_void_tup_t = filter_not_t<std::is_void, Ts...>;
+using get_max_columns_t = typename get_max_columns<Ts...>::type;
 
 ////////////////
-// no void or validator
+// shrink_buffers
 ////////////////
 
-// replace 'validators' and remove void from tuple
-template <typename... Ts>
-struct no_void_validator_tup : no_validator_tup<no_void_tup_t<Ts...>> {};
+class shrink_buffers;
 
-template <typename... Ts>
-struct no_void_validator_tup<std::tuple<Ts...>>
-    : no_validator_tup<no_void_tup_t<Ts...>> {};
+////////////////
+// use_pmr
+////////////////
 
-template <typename... Ts>
-using no_void_validator_tup_t = typename no_void_validator_tup<Ts...>::type;
+class use_pmr;
 
 ////////////////
-// tied class
+// table_driven
 ////////////////
 
-// check if the parameter pack is only one element which is a class and has
-// the 'tied' method which is to be used for type deduction when converting
+// lines split using a single character delimiter are split by a state
+// machine which uses tables generated from the setup
+class table_driven;
+
+////////////////
+// collect_stats
+////////////////
+
+// the parser collects ss::parser_stats, additionally the time spent in each
+// phase is measured for every 'TimingSampleRate'-th record, if not 0
+template <size_t TimingSampleRate, bool B = true>
+struct collect_stats_timed {
+    constexpr static auto timing_sample_rate = TimingSampleRate;
+    constexpr static auto enabled = B;
+};
+
+using collect_stats = collect_stats_timed<0>;
+
+template <typename T>
+struct is_instance_of_collect_stats : std::false_type {};
+
+template <size_t S, bool B>
+struct is_instance_of_collect_stats<collect_stats_timed<S, B>>
+    : std::true_type {};
+
+template <typename... Ts>
+struct get_collect_stats;
+
 template <typename T, typename... Ts>
-struct tied_class {
-    constexpr static bool value =
-        (sizeof...(Ts) == 0 && std::is_class_v<T> && has_m_tied<T>::value);
+struct get_collect_stats<T, Ts...> {
+    using type =
+        std::conditional_t<is_instance_of_collect_stats<T>::value, T,
+                           typename get_collect_stats<Ts...>::type>;
+};
+
+template <>
+struct get_collect_stats<> {
+    using type = collect_stats_timed<0, false>;
 };
 
 template <typename... Ts>
-constexpr bool tied_class_v = tied_class<Ts...>::value;
+using get_collect_stats_t = typename get_collect_stats<Ts...>::type;
 
 ////////////////
-// converter
+// setup implementation
 ////////////////
 
 template <typename... Options>
-class converter {
-    using line_ptr_type = typename splitter<Options...>::line_ptr_type;
+struct setup {
+private:
+    template <typename Option>
+    struct is_matcher
+        : std::disjunction<is_instance_of_matcher_t<Option, quote>,
+                           is_instance_of_matcher_t<Option, escape>,
+                           is_instance_of_matcher_t<Option, trim>,
+                           is_instance_of_matcher_t<Option, trim_left>,
+                           is_instance_of_matcher_t<Option, trim_right>> {};
 
-    constexpr static auto string_error = setup<Options...>::string_error;
-    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
-    constexpr static auto default_delimiter = ",";
+    template <typename T>
+    struct is_string_error : std::is_same<T, string_error> {};
+
+    template <typename T>
+    struct is_ignore_header : std::is_same<T, ignore_header> {};
+
+    template <typename T>
+    struct is_ignore_empty : std::is_same<T, ignore_empty> {};
+
+    template <typename T>
+    struct is_throw_on_error : std::is_same<T, throw_on_error> {};
+
+    template <typename T>
+    struct is_shrink_buffers : std::is_same<T, shrink_buffers> {};
+
+    template <typename T>
+    struct is_use_pmr : std::is_same<T, use_pmr> {};
+
+    template <typename T>
+    struct is_table_driven : std::is_same<T, table_driven> {};
+
+    constexpr static auto count_matcher = count_v<is_matcher, Options...>;
+
+    constexpr static auto count_multiline =
+        count_v<is_instance_of_multiline, Options...>;
+
+    constexpr static auto count_null_values =
+        count_v<is_instance_of_null_values, Options...>;
+
+    constexpr static auto count_structured_error =
+        count_v<is_instance_of_structured_error_log, Options...>;
+
+    constexpr static auto count_string_error =
+        count_v<is_string_error, Options...>;
+
+    constexpr static auto count_ignore_header =
+        count_v<is_ignore_header, Options...>;
+
+    constexpr static auto count_throw_on_error =
+        count_v<is_throw_on_error, Options...>;
+
+    constexpr static auto count_ignore_empty =
+        count_v<is_ignore_empty, Options...>;
+
+    constexpr static auto count_collect_stats =
+        count_v<is_instance_of_collect_stats, Options...>;
+
+    constexpr static auto count_max_record_size =
+        count_v<is_instance_of_max_record_size, Options...>;
+
+    constexpr static auto count_shrink_buffers =
+        count_v<is_shrink_buffers, Options...>;
 
-    using error_type = std::conditional_t<string_error, std::string, bool>;
+    constexpr static auto count_use_pmr = count_v<is_use_pmr, Options...>;
+
+    constexpr static auto count_table_driven =
+        count_v<is_table_driven, Options...>;
+
+    constexpr static auto count_max_columns =
+        count_v<is_instance_of_max_columns, Options...>;
+
+    constexpr static auto number_of_valid_setup_types =
+        count_matcher + count_multiline + count_string_error +
+        count_ignore_header + count_ignore_empty + count_throw_on_error +
+        count_null_values + count_structured_error + count_collect_stats +
+        count_max_record_size + count_shrink_buffers + count_use_pmr +
+        count_max_columns + count_table_driven;
+
+    using trim_left_only = get_matcher_t<trim_left, Options...>;
+    using trim_right_only = get_matcher_t<trim_right, Options...>;
+    using trim_all = get_matcher_t<trim, Options...>;
 
 public:
-    // parses line with given delimiter, returns a 'T' object created with
-    // extracted values of type 'Ts'
-    template <typename T, typename... Ts>
-    T convert_object(line_ptr_type line,
-                     const std::string& delim = default_delimiter) {
-        return to_object<T>(convert<Ts...>(line, delim));
+    using quote = get_matcher_t<quote, Options...>;
+    using escape = get_matcher_t<escape, Options...>;
+
+    using trim_left =
+        std::conditional_t<trim_all::enabled, trim_all, trim_left_only>;
+    using trim_right =
+        std::conditional_t<trim_all::enabled, trim_all, trim_right_only>;
+
+    using multiline = get_multiline_t<Options...>;
+    using null_values = get_null_values_t<Options...>;
+    constexpr static bool string_error = (count_string_error == 1);
+    constexpr static bool ignore_header = (count_ignore_header == 1);
+    constexpr static bool ignore_empty = (count_ignore_empty == 1);
+    constexpr static bool throw_on_error = (count_throw_on_error == 1);
+
+    using error_log = get_structured_error_log_t<Options...>;
+    constexpr static bool structured_error = (count_structured_error == 1);
+
+    using stats = get_collect_stats_t<Options...>;
+    constexpr static bool collect_stats = stats::enabled;
+
+    using max_record_size = get_max_record_size_t<Options...>;
+    constexpr static bool shrink_buffers = (count_shrink_buffers == 1);
+    constexpr static bool use_pmr = (count_use_pmr == 1);
+
+    using max_columns = get_max_columns_t<Options...>;
+    constexpr static bool table_driven = (count_table_driven == 1);
+
+private:
+#define ASSERT_MSG "cannot have the same match character in multiple matchers"
+    static_assert(!matches_intersect<escape, quote>(), ASSERT_MSG);
+
+    constexpr static auto quote_trim_intersect =
+        matches_intersect_union<quote, trim_left, trim_right>();
+    static_assert(!quote_trim_intersect, ASSERT_MSG);
+
+    constexpr static auto escape_trim_intersect =
+        matches_intersect_union<escape, trim_left, trim_right>();
+    static_assert(!escape_trim_intersect, ASSERT_MSG);
+
+#undef ASSERT_MSG
+
+    static_assert(
+        !multiline::enabled ||
+            (multiline::enabled && (quote::enabled || escape::enabled)),
+        "to enable multiline either quote or escape needs to be enabled");
+
+    static_assert(!(trim_all::enabled && trim_left_only::enabled) &&
+                      !(trim_all::enabled && trim_right_only::enabled),
+                  "ambiguous trim setup");
+
+    static_assert(count_multiline <= 1, "mutliline defined multiple times");
+
+    static_assert(count_null_values <= 1,
+                  "null values defined multiple times");
+
+    static_assert(count_string_error <= 1,
+                  "string_error defined multiple times");
+
+    static_assert(count_throw_on_error <= 1,
+                  "throw_on_error defined multiple times");
+
+    static_assert(count_structured_error <= 1,
+                  "structured_error defined multiple times");
+
+    static_assert(count_collect_stats <= 1,
+                  "collect_stats defined multiple times");
+
+    static_assert(count_max_record_size <= 1,
+                  "max_record_size defined multiple times");
+
+    static_assert(count_shrink_buffers <= 1,
+                  "shrink_buffers defined multiple times");
+
+    static_assert(count_use_pmr <= 1, "use_pmr defined multiple times");
+
+    static_assert(count_max_columns <= 1,
+                  "max_columns defined multiple times");
+
+    static_assert(count_table_driven <= 1,
+                  "table_driven defined multiple times");
+
+#ifndef SSP_HAS_PMR
+    static_assert(count_use_pmr == 0,
+                  "use_pmr requires the <memory_resource> header");
+#endif
+
+    static_assert(count_throw_on_error + count_string_error <= 1,
+                  "cannot define both throw_on_error and string_error");
+
+    static_assert(count_structured_error + count_string_error +
+                          count_throw_on_error <=
+                      1,
+                  "cannot define structured_error together with "
+                  "string_error or throw_on_error");
+
+    static_assert(number_of_valid_setup_types == sizeof...(Options),
+                  "one or multiple invalid setup parameters defined");
+};
+
+template <typename... Options>
+struct setup<setup<Options...>> : setup<Options...> {};
+
+} /* ss */
+
+namespace ss {
+
+////////////////
+// split table
+////////////////
+
+// classes of the characters of a line, the delimiter is not a part of the
+// class table since it is only known at runtime
+enum class char_class : uint8_t {
+    normal,
+    quote,
+    escape,
+    trim_left,
+    trim_right,
+    trim,
+    eol,
+    delimiter,
+    count
+};
+
+// states of the splitter while reading a field
+enum class split_state : uint8_t {
+    field_start,
+    unquoted,
+    unquoted_escape,
+    quoted,
+    quoted_escape,
+    quote_end,
+    quote_end_trim,
+    count
+};
+
+// transitions which end a field or the line, handled outside of the main
+// loop of the splitter
+enum class split_action : uint8_t {
+    none,
+    push_delimiter,
+    push_eol,
+    unquoted_escape_eol,
+    quoted_escape_eol,
+    quoted_eol,
+    mismatched_quote
+};
+
+// the character read is written to the current position of the field,
+// which is advanced if 'advance' is set, the characters which are shifted
+// out are not written, 'skip' moves the beginning of the field, and
+// 'content' marks the written characters as a part of the field, the
+// trailing trim characters are not content, 'run' is set if the next state
+// reads normal characters as content without changing, so they can be
+// copied in a loop, aligned so that an entry of the table is found using
+// shifts only
+struct alignas(8) split_transition {
+    split_state next{split_state::field_start};
+    split_action action{split_action::none};
+    uint8_t advance{0};
+    uint8_t skip{0};
+    uint8_t content{0};
+    uint8_t shift{0};
+    uint8_t run{0};
+};
+
+template <typename... Options>
+struct split_table {
+    using class_table = std::array<char_class, 256>;
+
+private:
+    using quote = typename setup<Options...>::quote;
+    using trim_left = typename setup<Options...>::trim_left;
+    using trim_right = typename setup<Options...>::trim_right;
+    using escape = typename setup<Options...>::escape;
+
+    constexpr static size_t class_count =
+        static_cast<size_t>(char_class::count);
+    constexpr static size_t state_count =
+        static_cast<size_t>(split_state::count);
+
+    using transition_table =
+        std::array<split_transition, state_count * class_count>;
+
+    template <typename Matcher>
+    constexpr static void set_class(class_table& classes, char_class c) {
+        if constexpr (Matcher::enabled) {
+            for (const auto& match : Matcher::matches) {
+                auto& curr = classes[static_cast<unsigned char>(match)];
+                // characters in both trim sets are trimmed on both sides
+                curr = (c == char_class::trim_right &&
+                        curr == char_class::trim_left)
+                           ? char_class::trim
+                           : c;
+            }
+        }
     }
 
-    // parses line with given delimiter, returns tuple of objects with
-    // extracted values of type 'Ts'
-    template <typename... Ts>
-    no_void_validator_tup_t<Ts...> convert(
-        line_ptr_type line, const std::string& delim = default_delimiter) {
-        split(line, delim);
-        if (splitter_.valid()) {
-            return convert<Ts...>(splitter_.split_data_);
-        } else {
-            handle_error_bad_split();
-            return {};
+    constexpr static class_table make_classes() {
+        class_table classes{};
+        for (auto& c : classes) {
+            c = char_class::normal;
         }
+        set_class<trim_left>(classes, char_class::trim_left);
+        set_class<trim_right>(classes, char_class::trim_right);
+        set_class<quote>(classes, char_class::quote);
+        set_class<escape>(classes, char_class::escape);
+        classes[0] = char_class::eol;
+        return classes;
     }
 
-    // parses already split line, returns 'T' object with extracted values
-    template <typename T, typename... Ts>
+    constexpr static uint8_t runs(split_state next) {
+        return next == split_state::unquoted || next == split_state::quoted;
+    }
+
+    constexpr static split_transition write(split_state next) {
+        return {next, split_action::none, 1, 0, 1, 0, runs(next)};
+    }
+
+    constexpr static split_transition write_shifted(split_state next) {
+        return {next, split_action::none, 1, 0, 1, 1, runs(next)};
+    }
+
+    constexpr static split_transition write_trailing(split_state next) {
+        return {next, split_action::none, 1, 0, 0, 0, 0};
+    }
+
+    constexpr static split_transition skip(split_state next) {
+        return {next, split_action::none, 1, 1, 1, 0, runs(next)};
+    }
+
+    constexpr static split_transition drop(split_state next) {
+        return {next, split_action::none, 0, 0, 0, 0, 0};
+    }
+
+    constexpr static split_transition stop(split_action action) {
+        return {split_state::field_start, action, 0, 0, 0, 0, 0};
+    }
+
+    // the transitions of one state, given for each character class in
+    // the order of their declaration
+    constexpr static void set_row(
+        transition_table& transitions, split_state state,
+        const std::array<split_transition, class_count>& row) {
+        for (size_t i = 0; i < class_count; ++i) {
+            transitions[static_cast<size_t>(state) * class_count + i] = row[i];
+        }
+    }
+
+    constexpr static transition_table make_transitions() {
+        using s = split_state;
+        using a = split_action;
+
+        transition_table transitions{};
+
+        // eg: ..., "a"... or ...,  a...
+        set_row(transitions, s::field_start,
+                {write(s::unquoted), skip(s::quoted),
+                 drop(s::unquoted_escape), skip(s::field_start),
+                 write_trailing(s::unquoted), skip(s::field_start),
+                 stop(a::push_eol), stop(a::push_delimiter)});
+
+        // eg: ...,ab c  ,...
+        set_row(transitions, s::unquoted,
+                {write(s::unquoted), write(s::unquoted),
+                 drop(s::unquoted_escape), write(s::unquoted),
+                 write_trailing(s::unquoted), write_trailing(s::unquoted),
+                 stop(a::push_eol), stop(a::push_delimiter)});
+
+        // eg: ...,a\,b,...
+        set_row(transitions, s::unquoted_escape,
+                {write_shifted(s::unquoted), write_shifted(s::unquoted),
+                 write_shifted(s::unquoted), write_shifted(s::unquoted),
+                 write_shifted(s::unquoted), write_shifted(s::unquoted),
+                 stop(a::unquoted_escape_eol), write_shifted(s::unquoted)});
+
+        // eg: ...,"a, b",...
+        set_row(transitions, s::quoted,
+                {write(s::quoted), drop(s::quote_end),
+                 drop(s::quoted_escape), write(s::quoted), write(s::quoted),
+                 write(s::quoted), stop(a::quoted_eol), write(s::quoted)});
+
+        // eg: ...,"a\"b",...
+        set_row(transitions, s::quoted_escape,
+                {write_shifted(s::quoted), write_shifted(s::quoted),
+                 write_shifted(s::quoted), write_shifted(s::quoted),
+                 write_shifted(s::quoted), write_shifted(s::quoted),
+                 stop(a::quoted_escape_eol), write_shifted(s::quoted)});
+
+        // eg: ...,"a""b",... or ...,"a"  ,...
+        set_row(transitions, s::quote_end,
+                {stop(a::mismatched_quote), write_shifted(s::quoted),
+                 stop(a::mismatched_quote), stop(a::mismatched_quote),
+                 write_trailing(s::quote_end_trim),
+                 write_trailing(s::quote_end_trim), stop(a::push_eol),
+                 stop(a::push_delimiter)});
+
+        // eg: ...,"a"  ,... or ...,"a"  b,... -> error
+        set_row(transitions, s::quote_end_trim,
+                {stop(a::mismatched_quote), stop(a::mismatched_quote),
+                 stop(a::mismatched_quote), stop(a::mismatched_quote),
+                 write_trailing(s::quote_end_trim),
+                 write_trailing(s::quote_end_trim), stop(a::push_eol),
+                 stop(a::push_delimiter)});
+
+        return transitions;
+    }
+
+public:
+    constexpr static class_table classes = make_classes();
+    constexpr static transition_table transitions = make_transitions();
+
+    // the delimiter is compared before the class table is used, so it
+    // cannot be a character of any of the matchers
+    constexpr static bool valid_delimiter(char delim) {
+        return classes[static_cast<unsigned char>(delim)] ==
+               char_class::normal;
+    }
+
+    constexpr static const split_transition& transition(split_state state,
+                                                        char_class c) {
+        return transitions[static_cast<size_t>(state) * class_count +
+                           static_cast<size_t>(c)];
+    }
+};
+
+} /* ss */
+
+namespace ss {
+
+template <typename... Options>
+class splitter {
+private:
+    using quote = typename setup<Options...>::quote;
+    using trim_left = typename setup<Options...>::trim_left;
+    using trim_right = typename setup<Options...>::trim_right;
+    using escape = typename setup<Options...>::escape;
+    using multiline = typename setup<Options...>::multiline;
+
+    constexpr static auto string_error = setup<Options...>::string_error;
+    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
+    constexpr static auto is_const_line = !quote::enabled && !escape::enabled;
+    constexpr static auto collect_stats = setup<Options...>::collect_stats;
+    constexpr static auto use_pmr = setup<Options...>::use_pmr;
+    using max_columns = typename setup<Options...>::max_columns;
+    constexpr static auto table_driven = setup<Options...>::table_driven;
+    using table = split_table<Options...>;
+
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
+
+public:
+    using line_ptr_type = std::conditional_t<is_const_line, const char*, char*>;
+    using split_data =
+        std::conditional_t<max_columns::enabled,
+                           inline_split_data<max_columns::size>,
+                           vector_t<use_pmr, string_range>>;
+
+    splitter() = default;
+
+    // the split data is allocated using the memory resource, requires the
+    // 'use_pmr' setup option
+    explicit splitter(ss::memory_resource* resource)
+        : split_data_{make_split_data(resource)} {
+        static_assert(use_pmr, "use_pmr needs to be enabled to use a memory "
+                               "resource");
+    }
+
+    bool valid() const {
+        if constexpr (string_error) {
+            return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
+        } else if constexpr (throw_on_error) {
+            return true;
+        } else {
+            return !error_;
+        }
+    }
+
+    const std::string& error_msg() const {
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = error_.message();
+            return error_msg_;
+        } else {
+            return error_;
+        }
+    }
+
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
+        return error_;
+    }
+
+    bool unterminated_quote() const {
+        return unterminated_quote_;
+    }
+
+    const split_data& split(line_ptr_type new_line,
+                            const std::string& delimiter = default_delimiter) {
+        return split(new_line, delimiter, 0);
+    }
+
+private:
+    // stops splitting after the given number of columns, if not 0
+    const split_data& split(line_ptr_type new_line,
+                            const std::string& delimiter, size_t columns) {
+        split_data_.clear();
+        line_ = new_line;
+        begin_ = line_;
+        columns_ = columns;
+        return split_impl_select_delim(delimiter);
+    }
+
+    ////////////////
+    // resplit
+    ////////////////
+
+    // number of characters the end of line is shifted backwards
+    size_t size_shifted() const {
+        return escaped_;
+    }
+
+    void adjust_ranges(const char* old_line) {
+        for (auto& [begin, end] : split_data_) {
+            begin = begin - old_line + line_;
+            end = end - old_line + line_;
+        }
+    }
+
+    const split_data& resplit(
+        line_ptr_type new_line, ssize_t new_size,
+        const std::string& delimiter = default_delimiter) {
+
+        // resplitting, continue from last slice
+        if (!quote::enabled || !multiline::enabled || split_data_.empty() ||
+            !unterminated_quote()) {
+            handle_error_invalid_resplit();
+            return split_data_;
+        }
+
+        const auto [old_line, old_begin] = *std::prev(split_data_.end());
+        size_t begin = old_begin - old_line - 1;
+
+        // safety measure
+        if (new_size != -1 && static_cast<size_t>(new_size) < begin) {
+            handle_error_invalid_resplit();
+            return split_data_;
+        }
+
+        // if unterminated quote, the last element is junk
+        split_data_.pop_back();
+
+        line_ = new_line;
+        adjust_ranges(old_line);
+
+        begin_ = line_ + begin;
+        end_ = line_ - old_line + end_ - escaped_;
+        curr_ = end_;
+
+        resplitting_ = true;
+
+        return split_impl_select_delim(delimiter);
+    }
+
+    ////////////////
+    // error
+    ////////////////
+
+    // the code of the last error is kept for the stats of the converter
+    void set_stats_error(error_code code) {
+        if constexpr (collect_stats) {
+            error_code_ = code;
+        }
+    }
+
+    void clear_error() {
+        if constexpr (string_error) {
+            error_.clear();
+        } else if constexpr (structured_error) {
+            error_.code = error_code::none;
+        } else if constexpr (!throw_on_error) {
+            error_ = false;
+        }
+        unterminated_quote_ = false;
+    }
+
+    void handle_error_empty_delimiter() {
+        constexpr static auto error_msg = "empty delimiter";
+
+        set_stats_error(error_code::empty_delimiter);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::empty_delimiter);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_mismatched_quote(size_t n) {
+        constexpr static auto error_msg = "mismatched quote at position: ";
+
+        set_stats_error(error_code::mismatched_quote);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg + std::to_string(n));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::mismatched_quote);
+            error_.column = split_data_.size();
+            error_.offset = n;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg + std::to_string(n)};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_unterminated_escape() {
+        constexpr static auto error_msg =
+            "unterminated escape at the end of the line";
+
+        set_stats_error(error_code::unterminated_escape);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::unterminated_escape);
+            error_.column = split_data_.size();
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_unterminated_quote() {
+        constexpr static auto error_msg = "unterminated quote";
+
+        set_stats_error(error_code::unterminated_quote);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::unterminated_quote);
+            error_.column = split_data_.size();
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_invalid_resplit() {
+        constexpr static auto error_msg =
+            "invalid resplit, new line must be longer"
+            "than the end of the last slice";
+
+        set_stats_error(error_code::invalid_resplit);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::invalid_resplit);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_too_many_columns() {
+        constexpr static auto error_msg = "too many columns, limit: ";
+
+        set_stats_error(error_code::too_many_columns);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg).append(
+                std::to_string(max_columns::size));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::too_many_columns);
+            error_.column = split_data_.size();
+            error_.expected = max_columns::size;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg +
+                                std::to_string(max_columns::size)};
+        } else {
+            error_ = true;
+        }
+    }
+
+    ////////////////
+    // matching
+    ////////////////
+
+    bool match(const char* const curr, char delim) {
+        return *curr == delim;
+    };
+
+    bool match(const char* const curr, const std::string& delim) {
+        return strncmp(curr, delim.c_str(), delim.size()) == 0;
+    };
+
+    size_t delimiter_size(char) {
+        return 1;
+    }
+
+    size_t delimiter_size(const std::string& delim) {
+        return delim.size();
+    }
+
+    void trim_left_if_enabled(line_ptr_type& curr) {
+        if constexpr (trim_left::enabled) {
+            while (trim_left::match(*curr)) {
+                ++curr;
+            }
+        }
+    }
+
+    void trim_right_if_enabled(line_ptr_type& curr) {
+        if constexpr (trim_right::enabled) {
+            while (trim_right::match(*curr)) {
+                ++curr;
+            }
+        }
+    }
+
+    template <typename Delim>
+    std::tuple<size_t, bool> match_delimiter(line_ptr_type begin,
+                                             const Delim& delim) {
+        line_ptr_type end = begin;
+
+        trim_right_if_enabled(end);
+
+        // just spacing
+        if (*end == '\0') {
+            return {0, false};
+        }
+
+        // not a delimiter, the trim characters are not trailing so they
+        // are read as a part of the field
+        if (!match(end, delim)) {
+            return {std::max<size_t>(end - begin, 1), false};
+        }
+
+        end += delimiter_size(delim);
+        trim_left_if_enabled(end);
+
+        // delimiter
+        return {end - begin, true};
+    }
+
+    ////////////////
+    // shifting
+    ////////////////
+
+    void shift_if_escaped(line_ptr_type& curr) {
+        if constexpr (escape::enabled) {
+            if (escape::match(*curr)) {
+                if (curr[1] == '\0') {
+                    if constexpr (!multiline::enabled) {
+                        handle_error_unterminated_escape();
+                    }
+                    done_ = true;
+                    return;
+                }
+                shift_and_jump_escape();
+            }
+        }
+    }
+
+    void shift_and_jump_escape() {
+        shift_and_set_current();
+        if constexpr (!is_const_line) {
+            ++escaped_;
+            if constexpr (collect_stats) {
+                ++escapes_shifted_;
+            }
+        }
+        ++end_;
+    }
+
+    void shift_push_and_start_next(size_t n) {
+        shift_and_push();
+        begin_ = end_ + n;
+    }
+
+    void shift_and_push() {
+        shift_and_set_current();
+        split_data_.emplace_back(begin_, curr_);
+    }
+
+    void shift_and_set_current() {
+        if constexpr (!is_const_line) {
+            if (escaped_ > 0) {
+                std::copy_n(curr_ + escaped_, end_ - curr_ - escaped_, curr_);
+                curr_ = end_ - escaped_;
+                return;
+            }
+        }
+        curr_ = end_;
+    }
+
+    ////////////////
+    // split impl
+    ////////////////
+
+    const split_data& split_impl_select_delim(
+        const std::string& delimiter = default_delimiter) {
+        clear_error();
+        switch (delimiter.size()) {
+        case 0:
+            handle_error_empty_delimiter();
+            return split_data_;
+        case 1:
+            return split_impl(delimiter[0]);
+        default:
+            return split_impl(delimiter);
+        }
+    }
+
+    template <typename Delim>
+    const split_data& split_impl(const Delim& delim) {
+        if constexpr (table_driven && std::is_same_v<Delim, char>) {
+            if (table::valid_delimiter(delim)) {
+                return split_table_impl(delim);
+            }
+        }
+
+        trim_left_if_enabled(begin_);
+
+        done_ = false;
+        while (!done_ && columns_left()) {
+            read(delim);
+        }
+
+        return split_data_;
+    }
+
+    // the split data does not use the memory resource if it is an array
+    static split_data make_split_data(ss::memory_resource* resource) {
+        if constexpr (max_columns::enabled) {
+            (void)resource;
+            return split_data{};
+        } else {
+            return split_data(make_allocator<use_pmr>(resource));
+        }
+    }
+
+    bool columns_reached() const {
+        return columns_ != 0 && split_data_.size() == columns_;
+    }
+
+    bool columns_left() {
+        if (columns_reached()) {
+            return false;
+        }
+
+        // each read adds one column, so the array is full if a column is
+        // left to be read
+        if constexpr (max_columns::enabled) {
+            if (split_data_.size() == max_columns::size) {
+                handle_error_too_many_columns();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ////////////////
+    // table driven split
+    ////////////////
+
+    // the same as split_impl, but each character is read using a single
+    // lookup into the tables generated from the setup, the fields are
+    // shifted in place while reading
+    const split_data& split_table_impl(char delim) {
+        line_ptr_type read = begin_;
+        line_ptr_type write = begin_;
+        line_ptr_type content_end = begin_;
+        line_ptr_type field_begin = begin_;
+        auto state = split_state::field_start;
+        escaped_ = 0;
+
+        if constexpr (multiline::enabled) {
+            if (resplitting_) {
+                // continue reading the unterminated quoted field
+                resplitting_ = false;
+                field_begin = begin_ + 1;
+                read = write = content_end = end_;
+                state = split_state::quoted;
+            }
+        }
+
+        done_ = false;
+        if (!columns_left()) {
+            return split_data_;
+        }
+
+        while (true) {
+            const char c = *read;
+            const auto& transition =
+                table::transition(state, table_class(c, delim));
+
+            if (transition.action != split_action::none) {
+                if (transition.action == split_action::push_delimiter) {
+                    // copied so that the pointers can stay in registers
+                    split_data_.emplace_back(line_ptr_type{field_begin},
+                                             line_ptr_type{content_end});
+                    field_begin = write = content_end = ++read;
+                    state = split_state::field_start;
+                    if (!columns_left()) {
+                        return split_data_;
+                    }
+                    continue;
+                }
+
+                handle_table_eol(transition.action, read, write, content_end,
+                                 field_begin);
+                done_ = true;
+                return split_data_;
+            }
+
+            if constexpr (!is_const_line) {
+                *write = c;
+            }
+            write += transition.advance;
+            field_begin += transition.skip;
+            content_end = transition.content ? write : content_end;
+            if constexpr (collect_stats) {
+                escapes_shifted_ += transition.shift;
+            }
+            state = transition.next;
+            ++read;
+
+            if (transition.run) {
+                while (table_class(*read, delim) == char_class::normal) {
+                    if constexpr (!is_const_line) {
+                        *write = *read;
+                    }
+                    ++write;
+                    ++read;
+                }
+                content_end = write;
+            }
+        }
+    }
+
+    // the delimiter is not a part of the generated class table
+    static char_class table_class(char c, char delim) {
+        return c == delim ? char_class::delimiter
+                          : table::classes[static_cast<unsigned char>(c)];
+    }
+
+    // the actions which end the line, the same errors and elements as the
+    // ones of split_impl are produced
+    void handle_table_eol(split_action action, line_ptr_type read,
+                          line_ptr_type write, line_ptr_type content_end,
+                          line_ptr_type field_begin) {
+        switch (action) {
+        case split_action::push_eol:
+            split_data_.emplace_back(field_begin, content_end);
+            break;
+        case split_action::unquoted_escape_eol:
+            // eg: ...,hel\\0 -> error, the escape is a part of the field
+            if constexpr (!multiline::enabled) {
+                handle_error_unterminated_escape();
+            }
+            if constexpr (!is_const_line) {
+                *write = read[-1];
+            }
+            split_data_.emplace_back(field_begin, write + 1);
+            break;
+        case split_action::quoted_escape_eol:
+            // eg: ..."hel\\0
+            if constexpr (!multiline::enabled) {
+                handle_error_unterminated_escape();
+            }
+            break;
+        case split_action::quoted_eol:
+            // eg: ..."hell\0 -> quote not terminated
+            unterminated_quote_ = true;
+            if constexpr (!multiline::enabled) {
+                handle_error_unterminated_quote();
+            }
+            split_data_.emplace_back(line_, field_begin);
+            // the state used to continue if resplit
+            curr_ = write;
+            end_ = read;
+            escaped_ = read - write;
+            break;
+        case split_action::mismatched_quote: {
+            // eg: ...,"hel"lo,... -> error
+            // the closing quote may be followed by trim characters, they
+            // are written after the content of the field
+            auto closing_quote = read - 1 - (write - content_end);
+            handle_error_mismatched_quote(closing_quote - line_);
+            split_data_.emplace_back(line_, field_begin);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    ////////////////
+    // reading
+    ////////////////
+
+    template <typename Delim>
+    void read(const Delim& delim) {
+        escaped_ = 0;
+        if constexpr (quote::enabled) {
+            if constexpr (multiline::enabled) {
+                if (resplitting_) {
+                    resplitting_ = false;
+                    ++begin_;
+                    read_quoted(delim);
+                    return;
+                }
+            }
+            if (quote::match(*begin_)) {
+                curr_ = end_ = ++begin_;
+                read_quoted(delim);
+                return;
+            }
+        }
+        curr_ = end_ = begin_;
+        read_normal(delim);
+    }
+
+    template <typename Delim>
+    void read_normal(const Delim& delim) {
+        while (true) {
+            auto [width, valid] = match_delimiter(end_, delim);
+
+            if (!valid) {
+                // not a delimiter
+                if (width == 0) {
+                    // eol
+                    shift_and_push();
+                    done_ = true;
+                    break;
+                } else {
+                    shift_if_escaped(end_);
+                    end_ += width;
+                    continue;
+                }
+            } else {
+                // found delimiter
+                shift_push_and_start_next(width);
+                break;
+            }
+        }
+    }
+
+    template <typename Delim>
+    void read_quoted(const Delim& delim) {
+        if constexpr (quote::enabled) {
+            while (true) {
+                if (!quote::match(*end_)) {
+                    if constexpr (escape::enabled) {
+                        if (escape::match(*end_)) {
+                            if (end_[1] == '\0') {
+                                // eol, unterminated escape
+                                // eg: ... "hel\\0
+                                if constexpr (!multiline::enabled) {
+                                    handle_error_unterminated_escape();
+                                }
+                                done_ = true;
+                                break;
+                            }
+                            // not eol
+
+                            shift_and_jump_escape();
+                            ++end_;
+                            continue;
+                        }
+                    }
+                    // not escaped
+
+                    // eol, unterminated quote error
+                    // eg: ..."hell\0 -> quote not terminated
+                    if (*end_ == '\0') {
+                        shift_and_set_current();
+                        unterminated_quote_ = true;
+                        if constexpr (!multiline::enabled) {
+                            handle_error_unterminated_quote();
+                        }
+                        split_data_.emplace_back(line_, begin_);
+                        done_ = true;
+                        break;
+                    }
+                    // not eol
+
+                    ++end_;
+                    continue;
+                }
+                // quote found
+                // ...
+
+                auto [width, valid] = match_delimiter(end_ + 1, delim);
+
+                // delimiter
+                if (valid) {
+                    shift_push_and_start_next(width + 1);
+                    break;
+                }
+                // not delimiter
+
+                // double quote
+                // eg: ...,"hel""lo",... -> hel"lo
+                if (quote::match(end_[1])) {
+                    shift_and_jump_escape();
+                    ++end_;
+                    continue;
+                }
+                // not double quote
+
+                if (width == 0) {
+                    // eol
+                    // eg: ...,"hello"   \0 -> hello
+                    // eg no trim: ...,"hello"\0 -> hello
+                    shift_and_push();
+                } else {
+                    // mismatched quote
+                    // eg: ...,"hel"lo,... -> error
+                    handle_error_mismatched_quote(end_ - line_);
+                    split_data_.emplace_back(line_, begin_);
+                }
+                done_ = true;
+                break;
+            }
+        }
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+public:
+    error_type error_{};
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
+    bool unterminated_quote_{false};
+    bool done_{true};
+    bool resplitting_{false};
+    size_t escaped_{0};
+    size_t columns_{0};
+
+    std::conditional_t<collect_stats, size_t, none> escapes_shifted_{};
+    std::conditional_t<collect_stats, error_code, none> error_code_{};
+    split_data split_data_;
+
+    line_ptr_type begin_;
+    line_ptr_type curr_;
+    line_ptr_type end_;
+    line_ptr_type line_;
+
+    template <typename...>
+    friend class converter;
+};
+
+} /* ss */
+
+
+#ifndef SSP_DISABLE_FAST_FLOAT
+#else
+#include <algorithm>
+#include <cstdlib>
+#endif
+
+// TODO try from_chars for integer conversions
+namespace ss {
+
+////////////////
+// number converters
+////////////////
+
+#ifndef SSP_DISABLE_FAST_FLOAT
+
+template <typename T>
+std::enable_if_t<std::is_floating_point_v<T>, std::optional<T>> to_num(
+    const char* const begin, const char* const end) {
+    T ret;
+    auto [ptr, ec] = fast_float::from_chars(begin, end, ret);
+
+    if (ec != std::errc() || ptr != end) {
+        return std::nullopt;
+    }
+    return ret;
+}
+
+#else
+
+template <typename T>
+std::enable_if_t<std::is_floating_point_v<T>, std::optional<T>> to_num(
+    const char* const begin, const char* const end) {
+    constexpr static auto buff_max = 64;
+    char buff[buff_max];
+    size_t string_range = std::distance(begin, end);
+
+    if (string_range > buff_max) {
+        return std::nullopt;
+    }
+
+    std::copy_n(begin, string_range, buff);
+    buff[string_range] = '\0';
+
+    T ret;
+    char* parse_end = nullptr;
+
+    if constexpr (std::is_same_v<T, float>) {
+        ret = std::strtof(buff, &parse_end);
+    } else if constexpr (std::is_same_v<T, double>) {
+        ret = std::strtod(buff, &parse_end);
+    } else if constexpr (std::is_same_v<T, long double>) {
+        ret = std::strtold(buff, &parse_end);
+    }
+
+    if (parse_end != buff + string_range) {
+        return std::nullopt;
+    }
+
+    return ret;
+}
+
+#endif
+
+template <typename T>
+std::enable_if_t<std::is_integral_v<T>, std::optional<T>> to_num(
+    const char* const begin, const char* const end) {
+    T ret;
+    auto [ptr, ec] = std::from_chars(begin, end, ret);
+
+    if (ec != std::errc() || ptr != end) {
+        return std::nullopt;
+    }
+    return ret;
+}
+
+////////////////
+// extract
+////////////////
+
+namespace error {
+template <typename T>
+struct unsupported_type {
+    constexpr static bool value = false;
+};
+} /* namespace */
+
+template <typename T>
+std::enable_if_t<!std::is_integral_v<T> && !std::is_floating_point_v<T> &&
+                     !is_instance_of_v<std::optional, T> &&
+                     !is_instance_of_v<std::variant, T>,
+                 bool>
+extract(const char*, const char*, T&) {
+    static_assert(error::unsupported_type<T>::value,
+                  "Conversion for given type is not defined, an "
+                  "\'extract\' function needs to be defined!");
+}
+
+template <typename T>
+std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool>
+extract(const char* begin, const char* end, T& value) {
+    auto optional_value = to_num<T>(begin, end);
+    if (!optional_value) {
+        return false;
+    }
+    value = optional_value.value();
+    return true;
+}
+
+template <typename T>
+std::enable_if_t<is_instance_of_v<std::optional, T>, bool> extract(
+    const char* begin, const char* end, T& value) {
+    typename T::value_type raw_value;
+    if (extract(begin, end, raw_value)) {
+        value = raw_value;
+    } else {
+        value = std::nullopt;
+    }
+    return true;
+}
+
+////////////////
+// lexical classification
+////////////////
+
+// bitmask of the kinds of values a field could possibly be converted to,
+// it is conservative, if a bit is set the conversion may still fail, but
+// if it is not set the conversion is certain to fail
+struct lexical_class {
+    constexpr static uint8_t none = 0;
+    constexpr static uint8_t integer = 1 << 0;
+    constexpr static uint8_t floating_point = 1 << 1;
+    constexpr static uint8_t boolean = 1 << 2;
+    constexpr static uint8_t character = 1 << 3;
+    constexpr static uint8_t any = 0xff;
+};
+
+// classifies the field in a single pass over the raw characters
+inline uint8_t lexical_classify(const char* const begin,
+                                const char* const end) {
+    size_t size = end - begin;
+    if (size == 0) {
+#ifdef SSP_DISABLE_FAST_FLOAT
+        // strtod accepts empty input
+        return lexical_class::floating_point;
+#else
+        return lexical_class::none;
+#endif
+    }
+
+    uint8_t ret = lexical_class::none;
+
+    if (size == 1) {
+        ret |= lexical_class::character;
+        if (*begin == '0' || *begin == '1') {
+            ret |= lexical_class::boolean;
+        }
+    } else if ((size == 4 && strncmp(begin, "true", size) == 0) ||
+               (size == 5 && strncmp(begin, "false", size) == 0)) {
+        ret |= lexical_class::boolean;
+    }
+
+    const char* curr = (*begin == '-') ? begin + 1 : begin;
+    if (curr != end) {
+        const char* digit = curr;
+        while (digit != end && *digit >= '0' && *digit <= '9') {
+            ++digit;
+        }
+
+        if (digit == end) {
+            return ret | lexical_class::integer | lexical_class::floating_point;
+        }
+    }
+
+    // the floating point conversions also accept a sign, a leading dot,
+    // exponents and special values like 'inf' and 'nan'
+    curr = (*begin == '-' || *begin == '+') ? begin + 1 : begin;
+    if (curr != end) {
+        switch (*curr) {
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case '.':
+        case 'i':
+        case 'I':
+        case 'n':
+        case 'N':
+            ret |= lexical_class::floating_point;
+            break;
+        default:
+            break;
+        }
+    }
+
+#ifdef SSP_DISABLE_FAST_FLOAT
+    // strtod skips leading whitespace
+    if (std::isspace(static_cast<unsigned char>(*begin))) {
+        ret |= lexical_class::floating_point;
+    }
+#endif
+
+    return ret;
+}
+
+// the kinds of fields the conversion for the given type may accept
+template <typename T>
+constexpr uint8_t lexical_mask() {
+    if constexpr (std::is_same_v<T, bool>) {
+        return lexical_class::boolean;
+    } else if constexpr (std::is_same_v<T, char>) {
+        return lexical_class::character;
+    } else if constexpr (std::is_integral_v<T>) {
+        return lexical_class::integer;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return lexical_class::floating_point;
+    } else {
+        return lexical_class::any;
+    }
+}
+
+template <typename T, size_t... Is>
+constexpr bool variant_needs_classification(std::index_sequence<Is...>) {
+    return ((lexical_mask<std::variant_alternative_t<Is, T>>() !=
+             lexical_class::any) ||
+            ...);
+}
+
+// the alternatives are tried in order, but the ones which cannot accept
+// the classified field are skipped without being constructed
+template <typename T, size_t I>
+bool extract_variant(const char* begin, const char* end, T& value,
+                     uint8_t lexical = lexical_class::any) {
+    using IthType = std::variant_alternative_t<I, std::decay_t<T>>;
+    constexpr auto mask = lexical_mask<IthType>();
+    if (mask == lexical_class::any || (mask & lexical)) {
+        IthType ithValue;
+        if (extract<IthType>(begin, end, ithValue)) {
+            value.template emplace<I>(std::move(ithValue));
+            return true;
+        }
+    }
+
+    if constexpr (I + 1 < std::variant_size_v<T>) {
+        return extract_variant<T, I + 1>(begin, end, value, lexical);
+    }
+    return false;
+}
+
+template <typename T>
+std::enable_if_t<is_instance_of_v<std::variant, T>, bool> extract(
+    const char* begin, const char* end, T& value) {
+    constexpr auto size = std::variant_size_v<T>;
+    if constexpr (variant_needs_classification<T>(
+                      std::make_index_sequence<size>{})) {
+        return extract_variant<T, 0>(begin, end, value,
+                                     lexical_classify(begin, end));
+    } else {
+        return extract_variant<T, 0>(begin, end, value);
+    }
+}
+
+////////////////
+// enum map
+////////////////
+
+// maps a token to an enum value, the token is given as a pointer to a
+// null terminated constant array with static storage duration
+template <auto Token, auto Value>
+struct enum_code {
+    constexpr static const char* token = Token;
+    constexpr static auto value = Value;
+
+    static_assert(std::is_same_v<decltype(Token), const char*>,
+                  "enum code tokens need to be given as constant char arrays");
+};
+
+// conversion type which converts tokens directly into enum values, the
+// lookup is done using a perfect hash table generated at compile time, eg:
+//     constexpr char circle[] = "circle";
+//     constexpr char square[] = "square";
+//     using shape_map = ss::enum_map<shape, ss::enum_code<circle,
+//     shape::circle>, ss::enum_code<square, shape::square>>;
+//     auto [s, x] = c.convert<shape_map, double>("circle,10");
+template <typename E, typename... Codes>
+class enum_map {
+    static_assert(std::is_enum_v<E>, "enum map needs to be used with an enum");
+    static_assert(sizeof...(Codes) > 0, "enum map needs at least one code");
+    static_assert(
+        (std::is_same_v<std::decay_t<decltype(Codes::value)>, E> && ...),
+        "enum code values need to be of the mapped enum type");
+
+    constexpr static size_t codes_size = sizeof...(Codes);
+
+    constexpr static size_t make_table_size() {
+        size_t size = 1;
+        while (size < 2 * codes_size) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    constexpr static size_t table_size = make_table_size();
+
+    constexpr static std::array<const char*, codes_size> tokens{
+        Codes::token...};
+    constexpr static std::array<size_t, codes_size> sizes{
+        std::char_traits<char>::length(Codes::token)...};
+    constexpr static std::array<E, codes_size> values{Codes::value...};
+
+    constexpr static uint64_t hash(const char* const begin, size_t size,
+                                   uint64_t seed) {
+        uint64_t h = seed ^ size;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= static_cast<unsigned char>(begin[i]);
+            h *= 1099511628211ull;
+        }
+        return h ^ (h >> 29);
+    }
+
+    constexpr static bool has_duplicates() {
+        for (size_t i = 0; i < codes_size; ++i) {
+            for (size_t j = i + 1; j < codes_size; ++j) {
+                if (sizes[i] != sizes[j]) {
+                    continue;
+                }
+
+                size_t k = 0;
+                while (k < sizes[i] && tokens[i][k] == tokens[j][k]) {
+                    ++k;
+                }
+
+                if (k == sizes[i]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // searches for a seed which maps all tokens into different slots,
+    // zero is returned if no seed was found
+    constexpr static uint64_t find_seed() {
+        for (uint64_t seed = 14695981039346656037ull, i = 0; i < 4096;
+             ++i, seed += 0x9e3779b97f4a7c15ull) {
+            std::array<bool, table_size> used{};
+            bool collision = false;
+            for (size_t j = 0; j < codes_size && !collision; ++j) {
+                auto slot = hash(tokens[j], sizes[j], seed) & (table_size - 1);
+                collision = used[slot];
+                used[slot] = true;
+            }
+
+            if (!collision) {
+                return seed;
+            }
+        }
+        return 0;
+    }
+
+    static_assert(!has_duplicates(), "enum map contains duplicate tokens");
+
+    constexpr static uint64_t seed = find_seed();
+    static_assert(seed != 0, "could not generate enum map hash table");
+
+    // slot values are indexes of the codes increased by one, zero if empty
+    constexpr static std::array<size_t, table_size> make_slots() {
+        std::array<size_t, table_size> slots{};
+        for (size_t i = 0; i < codes_size; ++i) {
+            slots[hash(tokens[i], sizes[i], seed) & (table_size - 1)] = i + 1;
+        }
+        return slots;
+    }
+
+    constexpr static std::array<size_t, table_size> slots = make_slots();
+
+public:
+    using value_type = E;
+
+    enum_map() = default;
+
+    // allows the map to be used within restrictions, eg:
+    // ss::nx<shape_map, shape::circle>
+    enum_map(E value) : value_{value} {
+    }
+
+    operator E() const {
+        return value_;
+    }
+
+    friend bool operator==(const enum_map& lhs, E rhs) {
+        return lhs.value_ == rhs;
+    }
+
+    friend bool operator!=(const enum_map& lhs, E rhs) {
+        return lhs.value_ != rhs;
+    }
+
+    static bool ss_extract(const char* begin, const char* end, E& value) {
+        size_t size = end - begin;
+        auto slot = slots[hash(begin, size, seed) & (table_size - 1)];
+        if (slot == 0) {
+            return false;
+        }
+
+        --slot;
+        if (sizes[slot] != size ||
+            std::memcmp(begin, tokens[slot], size) != 0) {
+            return false;
+        }
+
+        value = values[slot];
+        return true;
+    }
+
+private:
+    E value_{};
+};
+
+////////////////
+// extract specialization
+////////////////
+
+template <>
+inline bool extract(const char* begin, const char* end, bool& value) {
+    if (end == begin + 1) {
+        if (*begin == '1') {
+            value = true;
+        } else if (*begin == '0') {
+            value = false;
+        } else {
+            return false;
+        }
+    } else {
+        size_t size = end - begin;
+        if (size == 4 && strncmp(begin, "true", size) == 0) {
+            value = true;
+        } else if (size == 5 && strncmp(begin, "false", size) == 0) {
+            value = false;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <>
+inline bool extract(const char* begin, const char* end, char& value) {
+    value = *begin;
+    return (end == begin + 1);
+}
+
+template <>
+inline bool extract(const char* begin, const char* end, std::string& value) {
+    value.assign(begin, end);
+    return true;
+}
+
+template <>
+inline bool extract(const char* begin, const char* end,
+                    std::string_view& value) {
+    value = std::string_view{begin, static_cast<size_t>(end - begin)};
+    return true;
+}
+
+} /* ss */
+
+namespace ss {
+
+////////////////
+// arena
+////////////////
+
+// monotonic storage used to keep extracted std::string_view values valid
+// after the line they were read from is discarded, the memory is handed out
+// from large blocks and is released all at once
+class arena {
+public:
+    constexpr static size_t default_block_size = 64 * 1024;
+
+    arena(size_t block_size = default_block_size)
+        : block_size_{std::max<size_t>(block_size, 1)} {
+    }
+
+    // the moved from arena is left empty, its position would otherwise
+    // point into the blocks which were moved
+    arena(arena&& other)
+        : block_size_{other.block_size_},
+          blocks_{std::move(other.blocks_)},
+          block_index_{std::exchange(other.block_index_, 0)},
+          curr_{std::exchange(other.curr_, nullptr)},
+          available_{std::exchange(other.available_, 0)},
+          used_{std::exchange(other.used_, 0)} {
+        other.blocks_.clear();
+    }
+
+    arena& operator=(arena&& other) {
+        if (this != &other) {
+            block_size_ = other.block_size_;
+            blocks_ = std::move(other.blocks_);
+            block_index_ = std::exchange(other.block_index_, 0);
+            curr_ = std::exchange(other.curr_, nullptr);
+            available_ = std::exchange(other.available_, 0);
+            used_ = std::exchange(other.used_, 0);
+            other.blocks_.clear();
+        }
+        return *this;
+    }
+
+    arena(const arena& other) = delete;
+    arena& operator=(const arena& other) = delete;
+
+    // copies the given range into the arena, the returned view stays valid
+    // until the arena is cleared, released or destroyed
+    std::string_view store(const char* begin, const char* end) {
+        size_t size = end - begin;
+        if (size == 0) {
+            return std::string_view{};
+        }
+
+        char* dst = allocate(size);
+        std::memcpy(dst, begin, size);
+        return std::string_view{dst, size};
+    }
+
+    std::string_view store(std::string_view value) {
+        return store(value.data(), value.data() + value.size());
+    }
+
+    char* allocate(size_t size) {
+        if (size > available_) {
+            next_block(size);
+        }
+
+        char* ret = curr_;
+        curr_ += size;
+        available_ -= size;
+        used_ += size;
+        return ret;
+    }
+
+    // invalidates all stored values but keeps the allocated blocks so
+    // they can be reused
+    void clear() {
+        block_index_ = 0;
+        used_ = 0;
+        if (blocks_.empty()) {
+            curr_ = nullptr;
+            available_ = 0;
+        } else {
+            curr_ = blocks_.front().data.get();
+            available_ = blocks_.front().size;
+        }
+    }
+
+    // invalidates all stored values and frees all of the memory
+    void release() {
+        blocks_.clear();
+        clear();
+    }
+
+    // number of bytes handed out since the last clear
+    size_t used() const {
+        return used_;
+    }
+
+    // number of bytes allocated by the arena
+    size_t capacity() const {
+        size_t capacity = 0;
+        for (const auto& block : blocks_) {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+private:
+    struct block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void next_block(size_t min_size) {
+        // try to reuse the blocks left over from before the last clear
+        while (block_index_ + 1 < blocks_.size()) {
+            auto& next = blocks_[++block_index_];
+            if (next.size >= min_size) {
+                curr_ = next.data.get();
+                available_ = next.size;
+                return;
+            }
+        }
+
+        size_t size = std::max(block_size_, min_size);
+        blocks_.push_back(
+            block{std::unique_ptr<char[]>{new char[size]}, size});
+        block_index_ = blocks_.size() - 1;
+        curr_ = blocks_.back().data.get();
+        available_ = size;
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    size_t block_size_;
+    std::vector<block> blocks_;
+    size_t block_index_{0};
+    char* curr_{nullptr};
+    size_t available_{0};
+    size_t used_{0};
+};
+
+} /* ss */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SSP_HAS_RDTSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define SSP_HAS_RDTSC 1
+#endif
+
+namespace ss {
+
+////////////////
+// ticks
+////////////////
+
+// cycles of the time stamp counter where available, nanoseconds otherwise
+inline uint64_t ticks() {
+#ifdef SSP_HAS_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+// adds the ticks elapsed during its lifetime to the counter, if not null
+class tick_timer {
+public:
+    tick_timer(uint64_t* counter)
+        : counter_{counter}, begin_{counter ? ticks() : 0} {
+    }
+
+    ~tick_timer() {
+        if (counter_) {
+            *counter_ += ticks() - begin_;
+        }
+    }
+
+    tick_timer(const tick_timer& other) = delete;
+    tick_timer& operator=(const tick_timer& other) = delete;
+
+private:
+    uint64_t* counter_;
+    uint64_t begin_;
+};
+
+////////////////
+// parser stats
+////////////////
+
+// counters collected by the parser and the converter if the
+// 'collect_stats' setup option is used
+struct parser_stats {
+    // input read, including lines appended to multiline records
+    size_t bytes_read{0};
+    size_t lines{0};
+
+    // records read, and lines appended to them
+    size_t records{0};
+    size_t multiline_joins{0};
+
+    // characters removed by the splitter because of escapes and doubled
+    // quotes, and fields split
+    size_t escapes_shifted{0};
+    size_t fields_split{0};
+
+    // reallocations of the buffer while joining multiline records, and
+    // buffers released after oversized records if 'shrink_buffers' is used
+    size_t reallocs{0};
+    size_t buffer_shrinks{0};
+
+    // moving estimate of the 90th percentile of the record sizes in bytes
+    size_t record_size_percentile{0};
+
+    // successful conversions of fields by type, 'other' contains
+    // characters, booleans, optionals, variants and custom conversions
+    size_t integer_conversions{0};
+    size_t floating_point_conversions{0};
+    size_t string_conversions{0};
+    size_t other_conversions{0};
+
+    // failed conversions by error code
+    std::array<size_t, error_code_count> failures{};
+
+    // time spent in each phase of the sampled records, in ticks
+    size_t timed_records{0};
+    uint64_t read_ticks{0};
+    uint64_t split_ticks{0};
+    uint64_t convert_ticks{0};
+
+    size_t failure_count(error_code code) const {
+        return failures[static_cast<size_t>(code)];
+    }
+
+    size_t conversions() const {
+        return integer_conversions + floating_point_conversions +
+               string_conversions + other_conversions;
+    }
+
+    parser_stats& operator+=(const parser_stats& other) {
+        bytes_read += other.bytes_read;
+        lines += other.lines;
+        records += other.records;
+        multiline_joins += other.multiline_joins;
+        escapes_shifted += other.escapes_shifted;
+        fields_split += other.fields_split;
+        reallocs += other.reallocs;
+        buffer_shrinks += other.buffer_shrinks;
+        record_size_percentile =
+            std::max(record_size_percentile, other.record_size_percentile);
+        integer_conversions += other.integer_conversions;
+        floating_point_conversions += other.floating_point_conversions;
+        string_conversions += other.string_conversions;
+        other_conversions += other.other_conversions;
+        for (size_t i = 0; i < failures.size(); ++i) {
+            failures[i] += other.failures[i];
+        }
+        timed_records += other.timed_records;
+        read_ticks += other.read_ticks;
+        split_ticks += other.split_ticks;
+        convert_ticks += other.convert_ticks;
+        return *this;
+    }
+};
+
+} /* ss */
+
+namespace ss {
+INIT_HAS_METHOD(tied)
+INIT_HAS_METHOD(ss_valid)
+INIT_HAS_METHOD(ss_extract)
+INIT_HAS_METHOD(error)
+
+////////////////
+// column selection
+////////////////
+
+// selects the column at index 'N' to be converted into 'T',
+// eg. convert<ss::col<3, int>, ss::col<1, std::string>> converts only the
+// columns at index 3 and 1 into a tuple<int, std::string>
+template <size_t N, typename T>
+struct col {
+    static_assert(!std::is_void_v<T>, "selected column cannot be void");
+
+    constexpr static size_t index = N;
+    using type = T;
+};
+
+template <typename T>
+struct is_col : std::false_type {};
+
+template <size_t N, typename T>
+struct is_col<col<N, T>> : std::true_type {};
+
+template <typename T>
+struct column_type {
+    using type = T;
+};
+
+template <size_t N, typename T>
+struct column_type<col<N, T>> {
+    using type = T;
+};
+
+template <typename T>
+using column_type_t = typename column_type<T>::type;
+
+// number of columns needed to convert the selected columns, 0 if no
+// columns are selected
+template <typename... Ts>
+struct selected_columns {
+    constexpr static size_t value = 0;
+};
+
+template <size_t N, typename T, typename... Ts>
+struct selected_columns<col<N, T>, Ts...> {
+    constexpr static size_t value = (N + 1 > selected_columns<Ts...>::value)
+                                        ? N + 1
+                                        : selected_columns<Ts...>::value;
+};
+
+template <typename... Ts>
+constexpr size_t selected_columns_v = selected_columns<Ts...>::value;
+
+////////////////
+// replace validator
+////////////////
+
+// replace 'validator' types with elements they operate on
+// eg. no_validator_tup_t<int, ss::nx<char, 'A', 'B'>> <=> std::tuple<int, char>
+// where ss::nx<char, 'A', 'B'> is a validator '(n)one e(x)cept' which
+// checks if the returned character is either 'A' or 'B', returns error if not
+// additionally if one element is left in the pack, it will be unwrapped from
+// the tuple eg. no_void_validator_tup_t<int> <=> int instead of std::tuple<int>
+template <typename T, typename U = void>
+struct no_validator;
+
+template <typename T>
+struct no_validator<T, typename std::enable_if_t<has_m_ss_valid_t<T>>> {
+    using type = typename no_validator<
+        typename member_wrapper<decltype(&T::ss_valid)>::arg_type>::type;
+};
+
+// conversion types (eg. ss::enum_map) are replaced with the type they
+// convert to
+template <typename T>
+struct no_validator<T, typename std::enable_if_t<!has_m_ss_valid_t<T> &&
+                                                 has_m_ss_extract_t<T>>> {
+    using type = typename T::value_type;
+};
+
+template <size_t N, typename T>
+struct no_validator<col<N, T>, void> {
+    using type = typename no_validator<T>::type;
+};
+
+template <typename T, typename U>
+struct no_validator {
+    using type = T;
+};
+
+template <typename T>
+using no_validator_t = typename no_validator<T>::type;
+
+template <typename... Ts>
+struct no_validator_tup : apply_trait<no_validator, std::tuple<Ts...>> {};
+
+template <typename... Ts>
+struct no_validator_tup<std::tuple<Ts...>> : no_validator_tup<Ts...> {};
+
+template <typename T>
+struct no_validator_tup<std::tuple<T>> : no_validator<T> {};
+
+template <typename... Ts>
+using no_validator_tup_t = typename no_validator_tup<Ts...>::type;
+
+////////////////
+// extractor
+////////////////
+
+// the conversion type which is used to extract the value, if any, eg.
+// extractor_t<ss::nx<shape_map, shape::circle>> <=> shape_map
+template <typename T, typename U = void>
+struct extractor {
+    using type = none;
+};
+
+template <typename T>
+struct extractor<T, typename std::enable_if_t<has_m_ss_valid_t<T>>> {
+    using type = typename extractor<
+        typename member_wrapper<decltype(&T::ss_valid)>::arg_type>::type;
+};
+
+template <typename T>
+struct extractor<T, typename std::enable_if_t<!has_m_ss_valid_t<T> &&
+                                              has_m_ss_extract_t<T>>> {
+    using type = T;
+};
+
+template <typename T>
+using extractor_t = typename extractor<T>::type;
+
+////////////////
+// no void tuple
+////////////////
+
+template <typename... Ts>
+struct no_void_tup : filter_not<std::is_void, no_validator_tup_t<Ts...>> {};
+
+template <typename... Ts>
+using no_void_tup_t = filter_not_t<std::is_void, Ts...>;
+
+////////////////
+// no void or validator
+////////////////
+
+// replace 'validators' and remove void from tuple
+template <typename... Ts>
+struct no_void_validator_tup : no_validator_tup<no_void_tup_t<Ts...>> {};
+
+template <typename... Ts>
+struct no_void_validator_tup<std::tuple<Ts...>>
+    : no_validator_tup<no_void_tup_t<Ts...>> {};
+
+template <typename... Ts>
+using no_void_validator_tup_t = typename no_void_validator_tup<Ts...>::type;
+
+////////////////
+// tied class
+////////////////
+
+// check if the parameter pack is only one element which is a class and has
+// the 'tied' method which is to be used for type deduction when converting
+template <typename T, typename... Ts>
+struct tied_class {
+    constexpr static bool value =
+        (sizeof...(Ts) == 0 && std::is_class_v<T> && has_m_tied<T>::value);
+};
+
+template <typename... Ts>
+constexpr bool tied_class_v = tied_class<Ts...>::value;
+
+// check if the 'tied' method of a non const object returns non const
+// references, in which case the object can be filled in place
+template <typename T, typename U = void>
+struct tied_in_place : std::false_type {};
+
+template <typename T>
+struct tied_in_place<T, std::void_t<decltype(std::declval<T&>().tied())>> {
+    template <typename U>
+    struct is_mutable_ref
+        : std::bool_constant<std::is_lvalue_reference_v<U> &&
+                             !std::is_const_v<std::remove_reference_t<U>>> {
+    };
+
+    constexpr static bool value =
+        std::is_default_constructible_v<T> &&
+        all_of<is_mutable_ref,
+               decltype(std::declval<T&>().tied())>::value;
+};
+
+template <typename T>
+constexpr bool tied_in_place_v = tied_in_place<T>::value;
+
+////////////////
+// direct construction
+////////////////
+
+// check if 'Ts' is a single tuple or tied class
+template <typename... Ts>
+struct compound_argument : std::false_type {};
+
+template <typename T>
+struct compound_argument<T>
+    : std::bool_constant<tied_class_v<T> || is_instance_of_v<std::tuple, T>> {
+};
+
+// converts into any type, used to check if 'T' takes more values
+struct any_value {
+    template <typename U>
+    operator U() const;
+};
+
+// check if 'T' can be initialized using braces from values of 'Us...'
+template <typename T, typename Tuple, typename = void>
+struct brace_constructible : std::false_type {};
+
+template <typename T, typename... Us>
+struct brace_constructible<T, std::tuple<Us...>,
+                           std::void_t<decltype(T{std::declval<Us>()...})>>
+    : std::true_type {};
+
+// check if 'T' is constructed from exactly the values of 'Ts', aggregates
+// with more members would leave them without an initializer
+template <typename T, typename... Ts>
+struct exact_construction {
+    using values = std::tuple<no_validator_t<column_type_t<Ts>>...>;
+    using more_values =
+        std::tuple<no_validator_t<column_type_t<Ts>>..., any_value>;
+
+    constexpr static bool value = brace_constructible<T, values>::value &&
+                                  !brace_constructible<T, more_values>::value;
+};
+
+// check if the values of 'Ts' can be extracted one by one
+template <typename... Ts>
+struct separate_arguments
+    : std::bool_constant<(sizeof...(Ts) > 0) &&
+                         count_v<std::is_void, Ts...> == 0 &&
+                         !compound_argument<Ts...>::value> {};
+
+// check if 'T' can be constructed directly from the values extracted as
+// 'Ts' without a tuple in between
+template <typename T, typename... Ts>
+struct direct_construction
+    : std::conjunction<separate_arguments<Ts...>,
+                       exact_construction<T, Ts...>> {};
+
+template <typename T, typename... Ts>
+constexpr bool direct_construction_v = direct_construction<T, Ts...>::value;
+
+////////////////
+// memoization
+////////////////
+
+// unique address for each type, used as a key
+template <typename... Ts>
+struct type_tag {
+    constexpr static char id{};
+};
+
+constexpr static size_t memo_value_size = 16;
+
+// values which can be stored in a memo entry
+template <typename T>
+struct memoizable {
+    constexpr static bool value = std::is_trivially_copyable_v<T> &&
+                                  sizeof(T) <= memo_value_size &&
+                                  alignof(T) <= alignof(std::max_align_t);
+};
+
+template <typename T>
+constexpr bool memoizable_v = memoizable<T>::value;
+
+// result of the extraction of a column into a type, the type is null if
+// the column was not extracted
+struct memo_entry {
+    const void* type;
+    bool valid;
+    alignas(std::max_align_t) unsigned char value[memo_value_size];
+};
+
+////////////////
+// plan
+////////////////
+
+// precomputed column positions used to convert lines into 'Ts', usually
+// made by parser::make_plan from the names of the header fields, it can
+// be reused for any input with the same header
+template <typename... Ts>
+class plan {
+    static_assert(sizeof...(Ts) > 0, "plan needs at least one type");
+    static_assert(count_v<std::is_void, Ts...> == 0,
+                  "plan types cannot be void");
+
+public:
+    plan() = default;
+
+    // 'columns' are the positions of the values within a line which has
+    // 'number_of_columns' columns
+    plan(const std::array<size_t, sizeof...(Ts)>& columns,
+         size_t number_of_columns)
+        : columns_{columns}, number_of_columns_{number_of_columns},
+          valid_{true} {
+    }
+
+    bool valid() const {
+        return valid_;
+    }
+
+    const std::array<size_t, sizeof...(Ts)>& columns() const {
+        return columns_;
+    }
+
+    size_t number_of_columns() const {
+        return number_of_columns_;
+    }
+
+private:
+    std::array<size_t, sizeof...(Ts)> columns_{};
+    size_t number_of_columns_{0};
+    bool valid_{false};
+};
+
+////////////////
+// converter
+////////////////
+
+template <typename... Options>
+class converter {
+    using line_ptr_type = typename splitter<Options...>::line_ptr_type;
+
+    constexpr static auto string_error = setup<Options...>::string_error;
+    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
+    constexpr static auto default_delimiter = ",";
+    constexpr static auto collect_stats = setup<Options...>::collect_stats;
+
+    using null_values = typename setup<Options...>::null_values;
+
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
+
+public:
+    using split_data = typename splitter<Options...>::split_data;
+
+    converter() = default;
+
+    // the split data is allocated using the memory resource, requires the
+    // 'use_pmr' setup option
+    explicit converter(ss::memory_resource* resource) : splitter_{resource} {
+    }
+
+    // parses line with given delimiter, returns a 'T' object created with
+    // extracted values of type 'Ts'
+    template <typename T, typename... Ts>
+    T convert_object(line_ptr_type line,
+                     const std::string& delim = default_delimiter) {
+        split(line, delim, selected_columns_v<Ts...>);
+        return convert_object<T, Ts...>(splitter_.split_data_);
+    }
+
+    // parses line with given delimiter, returns tuple of objects with
+    // extracted values of type 'Ts'
+    template <typename... Ts>
+    no_void_validator_tup_t<Ts...> convert(
+        line_ptr_type line, const std::string& delim = default_delimiter) {
+        split(line, delim, selected_columns_v<Ts...>);
+        if (splitter_.valid()) {
+            return convert<Ts...>(splitter_.split_data_);
+        } else {
+            handle_error_bad_split();
+            return {};
+        }
+    }
+
+    // parses already split line, returns 'T' object with extracted values,
+    // the object is constructed directly from the extracted values
+    // without a tuple in between if possible
+    template <typename T, typename... Ts>
     T convert_object(const split_data& elems) {
-        return to_object<T>(convert<Ts...>(elems));
+        if constexpr (direct_construction_v<T, Ts...>) {
+            if (!check_columns<Ts...>(elems)) {
+                return T{no_validator_t<column_type_t<Ts>>{}...};
+            }
+            return construct_object<T, Ts...>(elems,
+                                              std::index_sequence_for<Ts...>{});
+        } else {
+            return to_object<T>(convert<Ts...>(elems));
+        }
+    }
+
+    // same as above, but uses cached split line
+    template <typename T, typename... Ts>
+    T convert_object() {
+        return convert_object<T, Ts...>(splitter_.split_data_);
+    }
+
+    // parses already split line, returns either a tuple of objects with
+    // parsed values (returns raw element (no tuple) if Ts is empty), or if
+    // one argument is given which is a class which has a tied
+    // method which returns a tuple, returns that type
+    template <typename T, typename... Ts>
+    no_void_validator_tup_t<T, Ts...> convert(const split_data& elems) {
+        if constexpr (sizeof...(Ts) == 0 && is_instance_of_v<std::tuple, T>) {
+            return convert_impl(elems, static_cast<T*>(nullptr));
+        } else if constexpr (tied_class_v<T, Ts...> && tied_in_place_v<T>) {
+            using arg_ref_tuple = decltype(std::declval<T&>().tied());
+            using arg_tuple = apply_trait_t<std::decay, arg_ref_tuple>;
+
+            T value{};
+            if (check_columns(elems, static_cast<arg_tuple*>(nullptr))) {
+                auto refs = value.tied();
+                fill_tied(refs, elems,
+                          std::make_index_sequence<
+                              std::tuple_size_v<arg_ref_tuple>>{});
+            }
+            return value;
+        } else if constexpr (tied_class_v<T, Ts...>) {
+            using arg_ref_tuple = std::result_of_t<decltype (&T::tied)(T)>;
+            using arg_tuple = apply_trait_t<std::decay, arg_ref_tuple>;
+
+            return to_object<T>(
+                convert_impl(elems, static_cast<arg_tuple*>(nullptr)));
+        } else {
+            return convert_impl<T, Ts...>(elems);
+        }
+    }
+
+    // same as above, but uses cached split line
+    template <typename T, typename... Ts>
+    no_void_validator_tup_t<T, Ts...> convert() {
+        return convert<T, Ts...>(splitter_.split_data_);
+    }
+
+    // converts the cached split line into an existing tuple, reusing the
+    // storage of its elements, on error the elements after the invalid
+    // one keep their previous values
+    template <typename... Ts>
+    void convert_into(no_void_validator_tup_t<Ts...>& dst) {
+        static_assert(!compound_argument<Ts...>::value,
+                      "tuples and tied classes cannot be converted into");
+        if (check_columns<Ts...>(splitter_.split_data_)) {
+            extract_multiple<0, 0, Ts...>(dst, splitter_.split_data_);
+        }
+    }
+
+    // same as above, but converts into an existing object, which is
+    // filled in place if it is a tied class
+    template <typename T, typename... Ts>
+    void convert_object_into(T& dst) {
+        if constexpr (sizeof...(Ts) == 0 && tied_in_place_v<T>) {
+            using arg_ref_tuple = decltype(std::declval<T&>().tied());
+            using arg_tuple = apply_trait_t<std::decay, arg_ref_tuple>;
+
+            if (check_columns(splitter_.split_data_,
+                              static_cast<arg_tuple*>(nullptr))) {
+                auto refs = dst.tied();
+                fill_tied(refs, splitter_.split_data_,
+                          std::make_index_sequence<
+                              std::tuple_size_v<arg_ref_tuple>>{});
+            }
+        } else if constexpr (sizeof...(Ts) == 0) {
+            dst = convert<T>();
+        } else {
+            dst = convert_object<T, Ts...>(splitter_.split_data_);
+        }
+    }
+
+    // parses already split line using the column positions of the plan,
+    // the column mapping is ignored
+    template <typename... Ts>
+    no_void_validator_tup_t<Ts...> convert(const ss::plan<Ts...>& plan,
+                                           const split_data& elems) {
+        clear_error();
+
+        if (!splitter_.valid()) {
+            handle_error_bad_split();
+            return {};
+        }
+
+        if (!plan.valid()) {
+            handle_error_incompatible_mapping(sizeof...(Ts), 0);
+            return {};
+        }
+
+        if (elems.size() != plan.number_of_columns()) {
+            handle_error_number_of_columns(plan.number_of_columns(),
+                                           elems.size());
+            return {};
+        }
+
+        no_void_validator_tup_t<Ts...> ret{};
+        extract_planned(plan, ret, elems, std::index_sequence_for<Ts...>{});
+        return ret;
+    }
+
+    // same as above, but uses cached split line
+    template <typename... Ts>
+    no_void_validator_tup_t<Ts...> convert(const ss::plan<Ts...>& plan) {
+        return convert(plan, splitter_.split_data_);
+    }
+
+    bool valid() const {
+        if constexpr (string_error) {
+            return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
+        } else if constexpr (throw_on_error) {
+            return true;
+        } else {
+            return !error_;
+        }
+    }
+
+    const std::string& error_msg() const {
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = error_.message();
+            return error_msg_;
+        } else {
+            return error_;
+        }
+    }
+
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
+        return error_;
+    }
+
+    // conversions, failures and shifted escapes counted since the
+    // converter was created, the counters of the reader are not set
+    ss::parser_stats stats() const {
+        static_assert(collect_stats,
+                      "collect_stats needs to be enabled to use this method");
+        ss::parser_stats ret = stats_;
+        ret.escapes_shifted = splitter_.escapes_shifted_;
+        return ret;
+    }
+
+    bool unterminated_quote() const {
+        return splitter_.unterminated_quote();
+    }
+
+    // 'splits' string by given delimiter, returns vector of pairs which
+    // contain the beginnings and the ends of each column of the string
+    const split_data& split(line_ptr_type line,
+                            const std::string& delim = default_delimiter) {
+        return split(line, delim, 0);
+    }
+
+    // extracted std::string_view values will be copied into the given
+    // arena, and will stay valid as long as the arena does, passing
+    // nullptr makes the values point into the line again
+    void use_arena(ss::arena* arena) {
+        arena_ = arena;
+    }
+
+private:
+    // splits only the first 'columns' columns of the line if not 0, the
+    // rest of the line is ignored, not used with quoted multiline since
+    // the whole line is needed to find unterminated quotes
+    const split_data& split(line_ptr_type line, const std::string& delim,
+                            size_t columns) {
+        splitter_.split_data_.clear();
+        if (line[0] == '\0') {
+            return splitter_.split_data_;
+        }
+
+        if constexpr (setup<Options...>::multiline::enabled &&
+                      setup<Options...>::quote::enabled) {
+            columns = 0;
+        }
+
+        return splitter_.split(line, delim, columns);
+    }
+
+    ////////////////
+    // memoization
+    ////////////////
+
+    // clears the stored extraction results, and enables or disables
+    // storing them for the current line, one result is stored per column
+    void memoize(bool enabled) {
+        memo_.assign(enabled ? splitter_.split_data_.size() : 0,
+                     memo_entry{});
+        memo_enabled_ = enabled;
+    }
+
+    ////////////////
+    // resplit
+    ////////////////
+
+    const split_data& resplit(line_ptr_type new_line, ssize_t new_size,
+                              const std::string& delim) {
+        return splitter_.resplit(new_line, new_size, delim);
+    }
+
+    size_t size_shifted() {
+        return splitter_.size_shifted();
+    }
+
+    ////////////////
+    // error
+    ////////////////
+
+    void clear_error() {
+        if constexpr (string_error) {
+            error_.clear();
+        } else if constexpr (structured_error) {
+            error_.code = error_code::none;
+        } else {
+            error_ = false;
+        }
+    }
+
+    std::string error_sufix(const string_range msg, size_t pos) const {
+        std::string error;
+        error.reserve(32);
+        error.append("at column ")
+            .append(std::to_string(pos + 1))
+            .append(": \'")
+            .append(msg.first, msg.second)
+            .append("\'");
+        return error;
+    }
+
+    void count_failure(error_code code) {
+        if constexpr (collect_stats) {
+            ++stats_.failures[static_cast<size_t>(code)];
+        }
+    }
+
+    void set_field_error(error_code code, const string_range msg,
+                         size_t pos) {
+        error_.set(code);
+        error_.column = pos;
+        error_.raw = msg;
+        error_.offset = msg.first - splitter_.line_;
+    }
+
+    void handle_error_bad_split() {
+        if constexpr (collect_stats) {
+            count_failure(splitter_.error_code_);
+        }
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(splitter_.error_msg());
+        } else if constexpr (structured_error) {
+            error_ = splitter_.error_;
+        } else if constexpr (!throw_on_error) {
+            error_ = true;
+        }
+    }
+
+    void handle_error_unterminated_escape() {
+        count_failure(error_code::unterminated_escape);
+
+        if constexpr (string_error) {
+            error_.clear();
+            splitter_.handle_error_unterminated_escape();
+            error_.append(splitter_.error_msg());
+        } else if constexpr (structured_error) {
+            splitter_.handle_error_unterminated_escape();
+            error_ = splitter_.error_;
+        } else if constexpr (throw_on_error) {
+            splitter_.handle_error_unterminated_escape();
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_unterminated_quote() {
+        count_failure(error_code::unterminated_quote);
+
+        if constexpr (string_error) {
+            error_.clear();
+            splitter_.handle_error_unterminated_quote();
+            error_.append(splitter_.error_msg());
+        } else if constexpr (structured_error) {
+            splitter_.handle_error_unterminated_quote();
+            error_ = splitter_.error_;
+        } else if constexpr (throw_on_error) {
+            splitter_.handle_error_unterminated_quote();
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_multiline_limit_reached() {
+        constexpr static auto error_msg = "multiline limit reached";
+
+        count_failure(error_code::multiline_limit_reached);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::multiline_limit_reached);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_record_too_large(size_t limit) {
+        constexpr static auto error_msg = "record too large, limit: ";
+
+        count_failure(error_code::record_too_large);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg).append(std::to_string(limit));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::record_too_large);
+            error_.expected = limit;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg + std::to_string(limit)};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_invalid_conversion(const string_range msg, size_t pos) {
+        constexpr static auto error_msg = "invalid conversion for parameter ";
+
+        count_failure(error_code::invalid_conversion);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg).append(error_sufix(msg, pos));
+        } else if constexpr (structured_error) {
+            set_field_error(error_code::invalid_conversion, msg, pos);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg + error_sufix(msg, pos)};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_validation_failed(const char* const error,
+                                        const string_range msg, size_t pos) {
+        count_failure(error_code::validation_failed);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error).append(" ").append(error_sufix(msg, pos));
+        } else if constexpr (structured_error) {
+            set_field_error(error_code::validation_failed, msg, pos);
+            error_.detail = error;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error + (" " + error_sufix(msg, pos))};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_number_of_columns(size_t expected_pos, size_t pos) {
+        constexpr static auto error_msg1 =
+            "invalid number of columns, expected: ";
+        constexpr static auto error_msg2 = ", got: ";
+
+        count_failure(error_code::number_of_columns);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg1)
+                .append(std::to_string(expected_pos))
+                .append(error_msg2)
+                .append(std::to_string(pos));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::number_of_columns);
+            error_.expected = expected_pos;
+            error_.got = pos;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg1 + std::to_string(expected_pos) +
+                                error_msg2 + std::to_string(pos)};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_incompatible_mapping(size_t argument_size,
+                                           size_t mapping_size) {
+        constexpr static auto error_msg1 =
+            "number of arguments does not match mapping, expected: ";
+        constexpr static auto error_msg2 = ", got: ";
+
+        count_failure(error_code::incompatible_mapping);
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg1)
+                .append(std::to_string(mapping_size))
+                .append(error_msg2)
+                .append(std::to_string(argument_size));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::incompatible_mapping);
+            error_.expected = mapping_size;
+            error_.got = argument_size;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg1 + std::to_string(mapping_size) +
+                                error_msg2 + std::to_string(argument_size)};
+        } else {
+            error_ = true;
+        }
+    }
+
+    ////////////////
+    // convert implementation
+    ////////////////
+
+    template <typename... Ts>
+    no_void_validator_tup_t<Ts...> convert_impl(const split_data& elems) {
+        if (!check_columns<Ts...>(elems)) {
+            return {};
+        }
+
+        return extract_tuple<Ts...>(elems);
+    }
+
+    // do not know how to specialize by return type :(
+    template <typename... Ts>
+    no_void_validator_tup_t<std::tuple<Ts...>> convert_impl(
+        const split_data& elems, const std::tuple<Ts...>*) {
+        return convert_impl<Ts...>(elems);
+    }
+
+    // clears the error and checks if the split line can be converted
+    // into 'Ts', sets the error if not
+    template <typename... Ts>
+    bool check_columns(const split_data& elems) {
+        clear_error();
+
+        if (!splitter_.valid()) {
+            handle_error_bad_split();
+            return false;
+        }
+
+        if constexpr (count_v<is_col, Ts...> > 0) {
+            static_assert(count_v<is_col, Ts...> == sizeof...(Ts),
+                          "either all or none of the columns need to be "
+                          "selected using ss::col");
+
+            // the column mapping is ignored if columns are selected
+            constexpr size_t columns = selected_columns_v<Ts...>;
+            if (elems.size() < columns) {
+                handle_error_number_of_columns(columns, elems.size());
+                return false;
+            }
+        } else if (!columns_mapped()) {
+            if (sizeof...(Ts) != elems.size()) {
+                handle_error_number_of_columns(sizeof...(Ts), elems.size());
+                return false;
+            }
+        } else {
+            if (sizeof...(Ts) != column_mappings_.size()) {
+                handle_error_incompatible_mapping(sizeof...(Ts),
+                                                  column_mappings_.size());
+                return false;
+            }
+
+            if (elems.size() != number_of_columns_) {
+                handle_error_number_of_columns(number_of_columns_,
+                                               elems.size());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename... Ts>
+    bool check_columns(const split_data& elems, const std::tuple<Ts...>*) {
+        return check_columns<Ts...>(elems);
+    }
+
+    ////////////////
+    // column mapping
+    ////////////////
+
+    bool columns_mapped() const {
+        return column_mappings_.size() != 0;
+    }
+
+    size_t column_position(size_t tuple_position) const {
+        if (!columns_mapped()) {
+            return tuple_position;
+        }
+        return column_mappings_[tuple_position];
+    }
+
+    // assumes positions are valid and the vector is not empty
+    void set_column_mapping(std::vector<size_t> positions,
+                            size_t number_of_columns) {
+        column_mappings_ = positions;
+        number_of_columns_ = number_of_columns;
+    }
+
+    void clear_column_positions() {
+        column_mappings_.clear();
+        number_of_columns_ = 0;
+    }
+
+    ////////////////
+    // conversion
+    ////////////////
+
+    template <typename T>
+    bool extract_value(const char* begin, const char* end,
+                       no_validator_t<T>& dst) {
+        using value_type = no_validator_t<T>;
+
+        if constexpr (!std::is_same_v<extractor_t<T>, none>) {
+            return extractor_t<T>::ss_extract(begin, end, dst);
+        } else {
+            if constexpr (null_values::enabled &&
+                          is_instance_of_v<std::optional, value_type>) {
+                if (null_values::match(begin, end)) {
+                    dst = std::nullopt;
+                    return true;
+                }
+
+                if constexpr (null_values::strict) {
+                    typename value_type::value_type value;
+                    if (!extract(begin, end, value)) {
+                        return false;
+                    }
+                    dst = std::move(value);
+                    return true;
+                }
+            }
+
+            return extract(begin, end, dst);
+        }
+    }
+
+    // if enabled, the results of the extractions of small trivially
+    // copyable types are stored, indexed by the column and checked against
+    // the type, so other conversions of the same line can reuse them
+    template <typename T>
+    bool extract_value_memoized(const string_range msg, size_t column,
+                                no_validator_t<T>& dst) {
+        using value_type = no_validator_t<T>;
+
+        if constexpr (memoizable_v<value_type>) {
+            if (memo_enabled_ && column < memo_.size()) {
+                const void* type = &type_tag<value_type, extractor_t<T>>::id;
+                auto& entry = memo_[column];
+                if (entry.type == type) {
+                    if (entry.valid) {
+                        std::memcpy(&dst, entry.value, sizeof(value_type));
+                    }
+                    return entry.valid;
+                }
+
+                entry.type = type;
+                entry.valid = extract_value<T>(msg.first, msg.second, dst);
+                if (entry.valid) {
+                    std::memcpy(entry.value, &dst, sizeof(value_type));
+                }
+                return entry.valid;
+            }
+        }
+
+        return extract_value<T>(msg.first, msg.second, dst);
+    }
+
+    // extracts the given column of the split data, 'pos' is the reported
+    // position of the parameter
+    template <typename T>
+    void extract_one(no_validator_t<T>& dst, const split_data& elems,
+                     size_t column, size_t pos) {
+        if (!valid()) {
+            return;
+        }
+
+        const string_range msg = elems[column];
+
+        if constexpr (std::is_same_v<T, std::string>) {
+            extract(msg.first, msg.second, dst);
+            count_conversion<T>();
+            return;
+        }
+
+        if (!extract_value_memoized<T>(msg, column, dst)) {
+            handle_error_invalid_conversion(msg, pos);
+            return;
+        }
+
+        if constexpr (has_m_ss_valid_t<T>) {
+            if (T validator; !validator.ss_valid(dst)) {
+                if constexpr (has_m_error_t<T>) {
+                    handle_error_validation_failed(validator.error(), msg, pos);
+                } else {
+                    handle_error_validation_failed("validation error", msg,
+                                                   pos);
+                }
+                return;
+            }
+        }
+
+        store_if_arena_used(dst);
+        count_conversion<no_validator_t<T>>();
+    }
+
+    template <typename T>
+    void count_conversion() {
+        if constexpr (collect_stats) {
+            if constexpr (std::is_same_v<T, bool> ||
+                          std::is_same_v<T, char>) {
+                ++stats_.other_conversions;
+            } else if constexpr (std::is_integral_v<T>) {
+                ++stats_.integer_conversions;
+            } else if constexpr (std::is_floating_point_v<T>) {
+                ++stats_.floating_point_conversions;
+            } else if constexpr (std::is_same_v<T, std::string> ||
+                                 std::is_same_v<T, std::string_view>) {
+                ++stats_.string_conversions;
+            } else {
+                ++stats_.other_conversions;
+            }
+        }
+    }
+
+    template <typename T>
+    void store_if_arena_used(T& dst) {
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            if (arena_) {
+                dst = arena_->store(dst);
+            }
+        } else if constexpr (std::is_same_v<T,
+                                            std::optional<std::string_view>>) {
+            if (arena_ && dst) {
+                dst = arena_->store(*dst);
+            }
+        }
+    }
+
+    template <size_t ArgN, size_t TupN, typename... Ts>
+    void extract_multiple(no_void_validator_tup_t<Ts...>& tup,
+                          const split_data& elems) {
+        using elem_t = std::tuple_element_t<ArgN, std::tuple<Ts...>>;
+
+        constexpr bool not_void = !std::is_void_v<elem_t>;
+        constexpr bool one_element = count_not_v<std::is_void, Ts...> == 1;
+
+        if constexpr (is_col<elem_t>::value) {
+            using col_t = column_type_t<elem_t>;
+            constexpr size_t pos = elem_t::index;
+
+            if constexpr (one_element) {
+                extract_one<col_t>(tup, elems, pos, pos);
+            } else {
+                auto& el = std::get<TupN>(tup);
+                extract_one<col_t>(el, elems, pos, pos);
+            }
+        } else if constexpr (not_void) {
+            if constexpr (one_element) {
+                extract_one<elem_t>(tup, elems, column_position(ArgN), ArgN);
+            } else {
+                auto& el = std::get<TupN>(tup);
+                extract_one<elem_t>(el, elems, column_position(ArgN), ArgN);
+            }
+        }
+
+        if constexpr (sizeof...(Ts) > ArgN + 1) {
+            constexpr size_t NewTupN = (not_void) ? TupN + 1 : TupN;
+            extract_multiple<ArgN + 1, NewTupN, Ts...>(tup, elems);
+        }
+    }
+
+    template <typename Tuple, size_t... Is>
+    void fill_tied(Tuple& refs, const split_data& elems,
+                   std::index_sequence<Is...>) {
+        using arg_tuple = apply_trait_t<std::decay, Tuple>;
+        (extract_one<std::tuple_element_t<Is, arg_tuple>>(
+             std::get<Is>(refs), elems, column_position(Is), Is),
+         ...);
+    }
+
+    // extracts the value of the argument 'I', 'T' can be ss::col
+    template <typename T, size_t I>
+    no_validator_t<column_type_t<T>> extract_argument(const split_data& elems) {
+        no_validator_t<column_type_t<T>> value{};
+        if constexpr (is_col<T>::value) {
+            extract_one<column_type_t<T>>(value, elems, T::index, T::index);
+        } else {
+            extract_one<T>(value, elems, column_position(I), I);
+        }
+        return value;
+    }
+
+    // braced initialization guarantees left to right evaluation, so the
+    // error semantics are the same as when extracting into a tuple
+    template <typename T, typename... Ts, size_t... Is>
+    T construct_object(const split_data& elems, std::index_sequence<Is...>) {
+        return T{extract_argument<Ts, Is>(elems)...};
+    }
+
+    template <typename... Ts, size_t... Is>
+    void extract_planned(const ss::plan<Ts...>& plan,
+                         no_void_validator_tup_t<Ts...>& tup,
+                         const split_data& elems, std::index_sequence<Is...>) {
+        const auto& columns = plan.columns();
+        if constexpr (sizeof...(Ts) == 1) {
+            extract_one<Ts...>(tup, elems, columns[0], columns[0]);
+        } else {
+            (extract_one<Ts>(std::get<Is>(tup), elems, columns[Is],
+                             columns[Is]),
+             ...);
+        }
+    }
+
+    template <typename... Ts>
+    no_void_validator_tup_t<Ts...> extract_tuple(const split_data& elems) {
+        static_assert(!all_of_v<std::is_void, Ts...>,
+                      "at least one parameter must be non void");
+        no_void_validator_tup_t<Ts...> ret{};
+        extract_multiple<0, 0, Ts...>(ret, elems);
+        return ret;
+    }
+
+    ////////////////
+    // members
+    ////////////////
+
+    error_type error_{};
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
+    splitter<Options...> splitter_;
+
+    template <typename...>
+    friend class parser;
+
+    template <typename...>
+    friend class push_parser;
+
+    std::vector<size_t> column_mappings_;
+    size_t number_of_columns_;
+
+    ss::arena* arena_{nullptr};
+
+    std::vector<memo_entry> memo_;
+    bool memo_enabled_{false};
+
+    std::conditional_t<collect_stats, ss::parser_stats, none> stats_{};
+};
+
+} /* ss */
+
+// TODO add single header tests
+
+namespace ss {
+
+template <typename... Options>
+class parser {
+    constexpr static auto string_error = setup<Options...>::string_error;
+    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
+
+    using multiline = typename setup<Options...>::multiline;
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
+
+    using error_log = typename setup<Options...>::error_log;
+    constexpr static bool record_errors =
+        structured_error && error_log::record;
+
+    constexpr static bool escaped_multiline_enabled =
+        multiline::enabled && setup<Options...>::escape::enabled;
+
+    constexpr static bool quoted_multiline_enabled =
+        multiline::enabled && setup<Options...>::quote::enabled;
+
+    constexpr static bool ignore_header = setup<Options...>::ignore_header;
+
+    constexpr static bool ignore_empty = setup<Options...>::ignore_empty;
+
+    constexpr static bool is_const_line =
+        !setup<Options...>::quote::enabled &&
+        !setup<Options...>::escape::enabled;
+
+    constexpr static bool collect_stats = setup<Options...>::collect_stats;
+    constexpr static size_t timing_sample_rate =
+        setup<Options...>::stats::timing_sample_rate;
+
+    using max_record_size = typename setup<Options...>::max_record_size;
+    using max_columns = typename setup<Options...>::max_columns;
+    constexpr static bool shrink_buffers = setup<Options...>::shrink_buffers;
+    constexpr static bool estimate_record_size =
+        shrink_buffers || collect_stats;
+
+    constexpr static bool use_pmr = setup<Options...>::use_pmr;
+
+public:
+    using reject_sink = std::function<void(const ss::rejected_record&)>;
+
+    parser(const std::string& file_name,
+           const std::string& delim = ss::default_delimiter)
+        : file_name_{file_name},
+          reader_{file_name_, delim, ss::default_memory_resource()} {
+        open();
+    }
+
+    // the line buffers, the split data, the raw records and the header are
+    // allocated using the memory resource, requires the 'use_pmr' setup
+    // option
+    parser(const std::string& file_name, const std::string& delim,
+           ss::memory_resource* resource)
+        : file_name_{file_name}, reader_{file_name_, delim, resource},
+          header_(make_allocator<use_pmr>(resource)),
+          header_slots_(make_allocator<use_pmr>(resource)),
+          raw_header_(make_allocator<use_pmr>(resource)) {
+        static_assert(use_pmr, "use_pmr needs to be enabled to use a memory "
+                               "resource");
+        open();
+    }
+
+    parser(parser&& other) = default;
+    parser& operator=(parser&& other) = default;
+
+    parser() = delete;
+    parser(const parser& other) = delete;
+    parser& operator=(const parser& other) = delete;
+
+    bool valid() const {
+        if constexpr (string_error) {
+            return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
+        } else if constexpr (throw_on_error) {
+            return true;
+        } else {
+            return !error_;
+        }
+    }
+
+    const std::string& error_msg() const {
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = file_name_;
+            if (error_.line != 0) {
+                error_msg_.append(" ").append(std::to_string(error_.line));
+            }
+            error_msg_.append(": ").append(error_.message());
+            return error_msg_;
+        } else {
+            return error_;
+        }
+    }
+
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
+        return error_;
+    }
+
+    // errors recorded according to the 'structured_error_log' setup option,
+    // the raw ranges of the recorded errors are not kept
+    const std::vector<ss::error_info>& recorded_errors() const {
+        static_assert(record_errors,
+                      "structured_error_log needs to be enabled to use this "
+                      "method");
+        return recorded_errors_;
+    }
+
+    // number of errors which occurred, including the ones not recorded
+    size_t error_count() const {
+        assert_structured_error_defined<structured_error>();
+        return error_count_;
+    }
+
+    // counters collected since the parser was created, enabled using the
+    // 'collect_stats' setup option
+    ss::parser_stats stats() const {
+        static_assert(collect_stats,
+                      "collect_stats needs to be enabled to use this method");
+        ss::parser_stats ret = reader_.stats_;
+        ret.bytes_read = reader_.bytes_read_;
+        ret.record_size_percentile = reader_.record_size_estimate_;
+        ret += reader_.converter_->stats();
+        ret += reader_.next_line_converter_->stats();
+        return ret;
+    }
+
+    bool eof() const {
+        return eof_;
+    }
+
+    bool ignore_next() {
+        return reader_.read_next();
+    }
+
+    template <typename T, typename... Ts>
+    T get_object() {
+        if constexpr (std::is_default_constructible_v<T>) {
+            return read_and_convert<false>(selected_columns_v<Ts...>, [this] {
+                return reader_.converter_->template convert_object<T, Ts...>();
+            });
+        } else {
+            return to_object<T>(get_next_impl<false, Ts...>());
+        }
+    }
+
+    size_t line() const {
+        return reader_.line_number_ > 1 ? reader_.line_number_ - 1
+                                        : reader_.line_number_;
+    }
+
+    template <typename T, typename... Ts>
+    no_void_validator_tup_t<T, Ts...> get_next() {
+        return get_next_impl<false, T, Ts...>();
+    }
+
+    // converts up to 'n' lines into 'out', reusing its storage, the
+    // validity of each line is stored into 'valid', returns the number of
+    // lines read, both vectors are resized to that number
+    template <typename T, typename... Ts>
+    size_t get_batch(std::vector<no_void_validator_tup_t<T, Ts...>>& out,
+                     std::vector<bool>& valid, size_t n) {
+        constexpr size_t columns = selected_columns_v<T, Ts...>;
+        return get_batch_impl(out, valid, n, columns, [this](auto& dst) {
+            reader_.converter_->template convert_into<T, Ts...>(dst);
+        });
+    }
+
+    // same as get_batch, but converts into 'T' objects, tied classes are
+    // filled in place
+    template <typename T, typename... Ts>
+    size_t get_object_batch(std::vector<T>& out, std::vector<bool>& valid,
+                            size_t n) {
+        constexpr size_t columns = selected_columns_v<Ts...>;
+        return get_batch_impl(out, valid, n, columns, [this](auto& dst) {
+            reader_.converter_->template convert_object_into<T, Ts...>(dst);
+        });
+    }
+
+    bool field_exists(const std::string& field) {
+        if (header_.empty()) {
+            split_header_data();
+        }
+
+        return header_index(field).has_value();
+    }
+
+    template <typename... Ts>
+    void use_fields(const Ts&... fields_args) {
+        auto column_mappings =
+            header_columns(std::vector<std::string>{fields_args...});
+        if (!column_mappings) {
+            return;
+        }
+
+        reader_.converter_->set_column_mapping(*column_mappings,
+                                               header_.size());
+        reader_.next_line_converter_->set_column_mapping(*column_mappings,
+                                                         header_.size());
+
+        if (line() == 1) {
+            ignore_next();
+        }
+    }
+
+    // resolves the given fields into a plan which can be used to convert
+    // the lines of this parser, or of any other file with the same header,
+    // the plan is invalid if the fields could not be resolved
+    template <typename... Ts, typename... Fields>
+    ss::plan<Ts...> make_plan(const Fields&... fields_args) {
+        static_assert(sizeof...(Ts) == sizeof...(Fields),
+                      "number of fields does not match the number of types");
+
+        auto column_mappings =
+            header_columns(std::vector<std::string>{fields_args...});
+        if (!column_mappings) {
+            return {};
+        }
+
+        std::array<size_t, sizeof...(Ts)> columns;
+        std::copy(column_mappings->begin(), column_mappings->end(),
+                  columns.begin());
+
+        if (line() == 1) {
+            ignore_next();
+        }
+
+        return ss::plan<Ts...>{columns, header_.size()};
+    }
+
+    // converts the next line using the given plan, ignoring the mapping
+    // set by use_fields
+    template <typename... Ts>
+    no_void_validator_tup_t<Ts...> get_next(const ss::plan<Ts...>& plan) {
+        return read_and_convert<false>(0, [this, &plan] {
+            return reader_.converter_->convert(plan);
+        });
+    }
+
+    template <typename T, typename... Ts>
+    T get_object(const ss::plan<Ts...>& plan) {
+        return to_object<T>(get_next(plan));
+    }
+
+    // records which fail to be read or converted by get_next, get_object or
+    // the iterators are passed to the sink before the next line is read,
+    // passing an empty sink disables it
+    void set_reject_sink(reject_sink sink) {
+        reject_sink_ = std::move(sink);
+        reader_.capture_raw_ = static_cast<bool>(reject_sink_);
+    }
+
+    // extracted std::string_view values will be copied into the given
+    // arena, so they stay valid after the next line is read, as long
+    // as the arena is not cleared, passing nullptr disables the copying
+    void use_arena(ss::arena* arena) {
+        reader_.converter_->use_arena(arena);
+        reader_.next_line_converter_->use_arena(arena);
+    }
+
+    ////////////////
+    // iterator
+    ////////////////
+
+    template <bool get_object, typename T, typename... Ts>
+    struct iterable {
+        struct iterator {
+            using value = std::conditional_t<get_object, T,
+                                             no_void_validator_tup_t<T, Ts...>>;
+
+            iterator() : parser_{nullptr}, value_{} {
+            }
+
+            iterator(parser<Options...>* parser) : parser_{parser}, value_{} {
+            }
+
+            iterator(const iterator& other) = default;
+            iterator(iterator&& other) = default;
+
+            value& operator*() {
+                return value_;
+            }
+
+            value* operator->() {
+                return &value_;
+            }
+
+            iterator& operator++() {
+                if (!parser_ || parser_->eof()) {
+                    parser_ = nullptr;
+                } else {
+                    if constexpr (get_object) {
+                        value_ =
+                            std::move(parser_->template get_object<T, Ts...>());
+                    } else {
+                        value_ =
+                            std::move(parser_->template get_next<T, Ts...>());
+                    }
+                }
+                return *this;
+            }
+
+            iterator& operator++(int) {
+                return ++*this;
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs) {
+                return (lhs.parser_ == nullptr && rhs.parser_ == nullptr) ||
+                       (lhs.parser_ == rhs.parser_ &&
+                        &lhs.value_ == &rhs.value_);
+            }
+
+            friend bool operator!=(const iterator& lhs, const iterator& rhs) {
+                return !(lhs == rhs);
+            }
+
+        private:
+            parser<Options...>* parser_;
+            value value_;
+        };
+
+        iterable(parser<Options...>* parser) : parser_{parser} {
+        }
+
+        iterator begin() {
+            return ++iterator{parser_};
+        }
+
+        iterator end() {
+            return iterator{};
+        }
+
+    private:
+        parser<Options...>* parser_;
+    };
+
+    template <typename... Ts>
+    auto iterate() {
+        return iterable<false, Ts...>{this};
+    }
+
+    template <typename... Ts>
+    auto iterate_object() {
+        return iterable<true, Ts...>{this};
+    }
+
+#ifdef SSP_HAS_COROUTINES
+    ////////////////
+    // generator
+    ////////////////
+
+    // yields a reference to the same row object for each line, which is
+    // converted in place, the validity of the row can be checked using
+    // the valid method, the parser needs to outlive the generator
+    template <typename T, typename... Ts>
+    ss::generator<no_void_validator_tup_t<T, Ts...>> rows() {
+        no_void_validator_tup_t<T, Ts...> row{};
+        while (!eof_) {
+            read_and_convert<false>(selected_columns_v<T, Ts...>, [&] {
+                reader_.converter_->template convert_into<T, Ts...>(row);
+                return true;
+            });
+            co_yield row;
+        }
+    }
+
+    // same as rows, but yields a 'T' object
+    template <typename T, typename... Ts>
+    ss::generator<T> object_rows() {
+        T row{};
+        while (!eof_) {
+            read_and_convert<false>(selected_columns_v<Ts...>, [&] {
+                reader_.converter_->template convert_object_into<T, Ts...>(row);
+                return true;
+            });
+            co_yield row;
+        }
+    }
+#endif
+
+    ////////////////
+    // composite conversion
+    ////////////////
+    template <typename... Ts>
+    class composite {
+    public:
+        composite(std::tuple<Ts...>&& values, parser& parser)
+            : values_{std::move(values)}, parser_{parser} {
+        }
+
+        // tries to convert the same line with a different output type
+        // only if the previous conversion was not successful,
+        // returns composite containing itself and the new output
+        // as optional, additionally, if a parameter is passed, and
+        // that parameter can be invoked using the converted value,
+        // than it will be invoked in the case of a valid conversion
+        template <typename... Us, typename Fun = none>
+        composite<Ts..., std::optional<no_void_validator_tup_t<Us...>>> or_else(
+            Fun&& fun = none{}) {
+            using Value = no_void_validator_tup_t<Us...>;
+            std::optional<Value> value;
+            try_convert_and_invoke<Value, Us...>(value, fun);
+            return composite_with(std::move(value));
+        }
+
+        // same as or_else, but saves the result into a 'U' object
+        // instead of a tuple
+        template <typename U, typename... Us, typename Fun = none>
+        composite<Ts..., std::optional<U>> or_object(Fun&& fun = none{}) {
+            std::optional<U> value;
+            try_convert_and_invoke<U, Us...>(value, fun);
+            return composite_with(std::move(value));
+        }
+
+        std::tuple<Ts...> values() {
+            return values_;
+        }
+
+        template <typename Fun>
+        auto on_error(Fun&& fun) {
+            assert_throw_on_error_not_defined<throw_on_error>();
+            if (!parser_.valid()) {
+                if constexpr (std::is_invocable_v<Fun>) {
+                    fun();
+                } else {
+                    static_assert(string_error || structured_error,
+                                  "to enable error messages within the "
+                                  "on_error method "
+                                  "callback string_error needs to be enabled");
+                    std::invoke(std::forward<Fun>(fun), parser_.error_msg());
+                }
+            }
+            return *this;
+        }
+
+    private:
+        template <typename T>
+        composite<Ts..., T> composite_with(T&& new_value) {
+            auto merged_values =
+                std::tuple_cat(std::move(values_),
+                               std::tuple<T>{parser_.valid()
+                                                 ? std::forward<T>(new_value)
+                                                 : std::nullopt});
+            return {std::move(merged_values), parser_};
+        }
+
+        template <typename U, typename... Us, typename Fun = none>
+        void try_convert_and_invoke(std::optional<U>& value, Fun&& fun) {
+            if (!parser_.valid()) {
+                auto tuple_output = try_same<Us...>();
+                if (!parser_.valid()) {
+                    return;
+                }
+
+                if constexpr (!std::is_same_v<U, decltype(tuple_output)>) {
+                    value = to_object<U>(std::move(tuple_output));
+                } else {
+                    value = std::move(tuple_output);
+                }
+
+                parser_.try_invoke(*value, std::forward<Fun>(fun));
+            }
+        }
+
+        template <typename U, typename... Us>
+        no_void_validator_tup_t<U, Us...> try_same() {
+            parser_.clear_error();
+            auto value =
+                parser_.reader_.converter_->template convert<U, Us...>();
+            if (!parser_.reader_.converter_->valid()) {
+                parser_.handle_error_invalid_conversion();
+            }
+            return value;
+        }
+
+        ////////////////
+        // members
+        ////////////////
+
+        std::tuple<Ts...> values_;
+        parser& parser_;
+    };
+
+    // tries to convert a line and returns a composite which is
+    // able to try additional conversions in case of failure
+    template <typename... Ts, typename Fun = none>
+    composite<std::optional<no_void_validator_tup_t<Ts...>>> try_next(
+        Fun&& fun = none{}) {
+        assert_throw_on_error_not_defined<throw_on_error>();
+        using Ret = no_void_validator_tup_t<Ts...>;
+        return try_invoke_and_make_composite<std::optional<Ret>>(
+            get_next_impl<true, Ts...>(), std::forward<Fun>(fun));
+    }
+
+    // identical to try_next but returns composite with object instead of a
+    // tuple
+    template <typename T, typename... Ts, typename Fun = none>
+    composite<std::optional<T>> try_object(Fun&& fun = none{}) {
+        assert_throw_on_error_not_defined<throw_on_error>();
+        return try_invoke_and_make_composite<std::optional<T>>(
+            to_object<T>(get_next_impl<true, Ts...>()),
+            std::forward<Fun>(fun));
+    }
+
+private:
+    // composite conversions do not use the reject sink since the record
+    // may still be converted by one of the alternatives, for the same
+    // reason the whole line is split even if columns are selected
+    template <bool Composite, typename T, typename... Ts>
+    no_void_validator_tup_t<T, Ts...> get_next_impl() {
+        constexpr size_t columns =
+            Composite ? 0 : selected_columns_v<T, Ts...>;
+
+        return read_and_convert<Composite>(columns, [this] {
+            return reader_.converter_->template convert<T, Ts...>();
+        });
+    }
+
+    // reads the next line splitting up to 'columns' columns (all if 0) and
+    // converts it using the given function
+    template <bool Composite, typename Convert>
+    auto read_and_convert(size_t columns, Convert&& convert)
+        -> decltype(convert()) {
+        constexpr bool Reject = !Composite;
+
+        if (!eof_) {
+            SSP_PROBE1(record_start, reader_.line_number_);
+            if constexpr (throw_on_error) {
+                try {
+                    reader_.parse(columns);
+                } catch (const ss::exception& e) {
+                    reader_.update();
+                    reject_if_enabled<Reject>();
+                    finish_record(false);
+                    decorate_rethrow(e);
+                }
+            } else {
+                reader_.parse(columns);
+            }
+        }
+
+        reader_.update();
+        if (!reader_.converter_->valid()) {
+            handle_error_invalid_conversion();
+            reject_if_enabled<Reject>();
+            finish_record(false);
+            return {};
+        }
+
+        clear_error();
+
+        if (eof_) {
+            handle_error_eof_reached();
+            return {};
+        }
+
+        // the alternatives of a composite reuse the extracted values
+        reader_.converter_->memoize(Composite);
+
+        if constexpr (throw_on_error) {
+            try {
+                auto value = reader_.timed(&parser_stats::convert_ticks,
+                                           convert);
+                finish_record(true);
+                return value;
+            } catch (const ss::exception& e) {
+                reject_if_enabled<Reject>();
+                finish_record(false);
+                decorate_rethrow(e);
+            }
+        }
+
+        auto value = reader_.timed(&parser_stats::convert_ticks, convert);
+
+        if (!reader_.converter_->valid()) {
+            handle_error_invalid_conversion();
+            reject_if_enabled<Reject>();
+        }
+
+        finish_record(reader_.converter_->valid());
+        return value;
+    }
+
+    // the next line is read once the current record is done
+    void finish_record(bool valid) {
+        if (!valid) {
+            SSP_PROBE2(conversion_error, reader_.line_number_,
+                       static_cast<int>(probed_error_code()));
+        }
+        SSP_PROBE2(record_end, reader_.line_number_, valid);
+        read_line();
+    }
+
+    error_code probed_error_code() const {
+        if constexpr (structured_error) {
+            return error_.code;
+        } else {
+            return error_code::invalid_conversion;
+        }
+    }
+
+    template <typename T, typename ConvertInto>
+    size_t get_batch_impl(std::vector<T>& out, std::vector<bool>& valid,
+                          size_t n, size_t columns,
+                          ConvertInto&& convert_into) {
+        if (out.size() < n) {
+            out.resize(n);
+        }
+        valid.resize(n);
+
+        size_t size = 0;
+        for (; size < n && !eof_; ++size) {
+            auto& dst = out[size];
+            // the returned value only tells if the line was converted
+            read_and_convert<false>(columns, [&] {
+                convert_into(dst);
+                return true;
+            });
+            valid[size] = this->valid();
+        }
+
+        out.resize(size);
+        valid.resize(size);
+        SSP_PROBE1(batch_complete, size);
+        return size;
+    }
+
+    template <bool Reject>
+    void reject_if_enabled() {
+        if constexpr (Reject) {
+            if (reject_sink_) {
+                error_code code = error_code::invalid_conversion;
+                if constexpr (structured_error) {
+                    code = error_.code;
+                }
+                reject_sink_(rejected_record{reader_.line_number_,
+                                             reader_.get_raw(), code});
+            }
+        }
+    }
+
+    // tries to invoke the given function (see below), if the function
+    // returns a value which can be used as a conditional, and it returns
+    // false, the function sets an error, and allows the invoke of the
+    // next possible conversion as if the validation of the current one
+    // failed
+    template <typename Arg, typename Fun = none>
+    void try_invoke(Arg&& arg, Fun&& fun) {
+        constexpr bool is_none = std::is_same_v<std::decay_t<Fun>, none>;
+        if constexpr (!is_none) {
+            using Ret = decltype(try_invoke_impl(arg, std::forward<Fun>(fun)));
+            constexpr bool returns_void = std::is_same_v<Ret, void>;
+            if constexpr (!returns_void) {
+                if (!try_invoke_impl(arg, std::forward<Fun>(fun))) {
+                    handle_error_failed_check();
+                }
+            } else {
+                try_invoke_impl(arg, std::forward<Fun>(fun));
+            }
+        }
+    }
+
+    // tries to invoke the function if not none
+    // it first tries to invoke the function without arguments,
+    // than with one argument if the function accepts the whole tuple
+    // as an argument, and finally tries to invoke it with the tuple
+    // laid out as a parameter pack
+    template <typename Arg, typename Fun = none>
+    auto try_invoke_impl(Arg&& arg, Fun&& fun) {
+        constexpr bool is_none = std::is_same_v<std::decay_t<Fun>, none>;
+        if constexpr (!is_none) {
+            if constexpr (std::is_invocable_v<Fun>) {
+                return fun();
+            } else if constexpr (std::is_invocable_v<Fun, Arg>) {
+                return std::invoke(std::forward<Fun>(fun),
+                                   std::forward<Arg>(arg));
+            } else {
+                return std::apply(std::forward<Fun>(fun),
+                                  std::forward<Arg>(arg));
+            }
+        }
+    }
+
+    template <typename T, typename Fun = none>
+    composite<T> try_invoke_and_make_composite(T&& value, Fun&& fun) {
+        if (valid()) {
+            try_invoke(*value, std::forward<Fun>(fun));
+        }
+        return {valid() ? std::move(value) : std::nullopt, *this};
+    }
+
+    ////////////////
+    // header
+    ////////////////
+
+    // the fields are indexed using an open addressing hash table with
+    // linear probing, the slots contain the index of the field + 1, or 0
+    // if empty
+    void split_header_data() {
+        auto splitter =
+            make_with_resource<ss::splitter<Options...>>(reader_.resource_);
+        string_t<use_pmr> raw_header_copy{
+            raw_header_, make_allocator<use_pmr>(reader_.resource_)};
+        splitter.split(raw_header_copy.data(), reader_.delim_);
+
+        // the header is not truncated if it is wider than 'max_columns'
+        if constexpr (max_columns::enabled) {
+            if (!splitter.valid() &&
+                splitter.split_data_.size() == max_columns::size) {
+                handle_error_header_too_wide();
+                return;
+            }
+        }
+
+        const auto& split_data = splitter.split_data_;
+        size_t slots_size = 1;
+        while (slots_size < 2 * split_data.size()) {
+            slots_size *= 2;
+        }
+
+        header_.reserve(split_data.size());
+        header_slots_.assign(slots_size, 0);
+
+        for (const auto& [begin, end] : split_data) {
+            std::string_view field{begin, static_cast<size_t>(end - begin)};
+            size_t& slot = header_slot(field);
+            if (slot != 0) {
+                handle_error_invalid_header(std::string{field});
+                header_.clear();
+                header_slots_.clear();
+                return;
+            }
+
+            header_.emplace_back(field);
+            slot = header_.size();
+        }
+
+        // the rows are expected to have as many columns as the header
+        reader_.converter_->splitter_.split_data_.reserve(header_.size());
+        reader_.next_line_converter_->splitter_.split_data_.reserve(
+            header_.size());
+    }
+
+    size_t& header_slot(std::string_view field) {
+        size_t mask = header_slots_.size() - 1;
+        size_t i = std::hash<std::string_view>{}(field) & mask;
+        while (header_slots_[i] != 0 &&
+               header_[header_slots_[i] - 1] != field) {
+            i = (i + 1) & mask;
+        }
+        return header_slots_[i];
+    }
+
+    std::optional<std::vector<size_t>> header_columns(
+        const std::vector<std::string>& fields) {
+        if constexpr (ignore_header) {
+            handle_error_header_ignored();
+            return std::nullopt;
+        }
+
+        if (header_.empty()) {
+            split_header_data();
+        }
+
+        if (!valid()) {
+            return std::nullopt;
+        }
+
+        if (fields.empty()) {
+            handle_error_empty_mapping();
+            return std::nullopt;
+        }
+
+        std::vector<size_t> column_mappings;
+        column_mappings.reserve(fields.size());
+
+        // the fields are sorted to find the repeated ones, which are
+        // reported before the ones missing from the header
+        std::vector<std::string_view> sorted_fields{fields.begin(),
+                                                    fields.end()};
+        std::sort(sorted_fields.begin(), sorted_fields.end());
+
+        for (const auto& field : fields) {
+            auto [first, last] = std::equal_range(sorted_fields.begin(),
+                                                  sorted_fields.end(), field);
+            if (last - first != 1) {
+                handle_error_field_used_multiple_times(field);
+                return std::nullopt;
+            }
+
+            auto index = header_index(field);
+
+            if (!index) {
+                handle_error_invalid_field(field);
+                return std::nullopt;
+            }
+
+            column_mappings.push_back(*index);
+        }
+
+        return column_mappings;
+    }
+
+    std::optional<size_t> header_index(const std::string& field) {
+        if (header_slots_.empty()) {
+            return std::nullopt;
+        }
+
+        size_t slot = header_slot(field);
+        if (slot == 0) {
+            return std::nullopt;
+        }
+
+        return slot - 1;
+    }
+
+    ////////////////
+    // error
+    ////////////////
+
+    void clear_error() {
+        if constexpr (string_error) {
+            error_.clear();
+        } else if constexpr (structured_error) {
+            error_.code = error_code::none;
+        } else {
+            error_ = false;
+        }
     }
 
-    // same as above, but uses cached split line
-    template <typename T, typename... Ts>
-    T convert_object() {
-        return to_object<T>(convert<Ts...>());
+    void set_error(error_code code) {
+        error_.set(code);
+        error_.line = reader_.line_number_;
+        record_error();
     }
 
-    // parses already split line, returns either a tuple of objects with
-    // parsed values (returns raw element (no tuple) if Ts is empty), or if
-    // one argument is given which is a class which has a tied
-    // method which returns a tuple, returns that type
-    template <typename T, typename... Ts>
-    no_void_validator_tup_t<T, Ts...> convert(const split_data& elems) {
-        if constexpr (sizeof...(Ts) == 0 && is_instance_of_v<std::tuple, T>) {
-            return convert_impl(elems, static_cast<T*>(nullptr));
-        } else if constexpr (tied_class_v<T, Ts...>) {
-            using arg_ref_tuple = std::result_of_t<decltype (&T::tied)(T)>;
-            using arg_tuple = apply_trait_t<std::decay, arg_ref_tuple>;
+    void record_error() {
+        ++error_count_;
+        if constexpr (record_errors) {
+            if ((error_count_ - 1) % error_log::sample_rate != 0) {
+                return;
+            }
+
+            if (error_log::max_recorded != 0 &&
+                recorded_errors_.size() >= error_log::max_recorded) {
+                return;
+            }
+
+            recorded_errors_.push_back(error_);
+            recorded_errors_.back().raw = string_range{nullptr, nullptr};
+        }
+    }
+
+    void handle_error_failed_check() {
+        constexpr static auto error_msg = " failed check";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::failed_check);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_file_not_open() {
+        constexpr static auto error_msg = " could not be opened";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::file_not_open);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_eof_reached() {
+        constexpr static auto error_msg = " read on end of file";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::eof_reached);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_invalid_conversion() {
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_)
+                .append(" ")
+                .append(std::to_string(reader_.line_number_))
+                .append(": ")
+                .append(reader_.converter_->error_msg());
+        } else if constexpr (structured_error) {
+            error_ = reader_.converter_->error_info();
+            error_.line = reader_.line_number_;
+            error_.offset += reader_.line_offset_;
+            record_error();
+        } else if constexpr (!throw_on_error) {
+            error_ = true;
+        }
+    }
+
+    void handle_error_header_ignored() {
+        constexpr static auto error_msg =
+            ": the header row is ignored within the setup it cannot be used";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::header_ignored);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_invalid_field(const std::string& field) {
+        constexpr static auto error_msg =
+            ": header does not contain given field: ";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg).append(field);
+        } else if constexpr (structured_error) {
+            set_error(error_code::invalid_field);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg + field};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_field_used_multiple_times(const std::string& field) {
+        constexpr static auto error_msg = ": given field used multiple times: ";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg).append(field);
+        } else if constexpr (structured_error) {
+            set_error(error_code::field_used_multiple_times);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg + field};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_empty_mapping() {
+        constexpr static auto error_msg = "received empty mapping";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg);
+        } else if constexpr (structured_error) {
+            set_error(error_code::empty_mapping);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_invalid_header(const std::string& field) {
+        constexpr static auto error_msg = "header contains duplicates: ";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(error_msg).append(field);
+        } else if constexpr (structured_error) {
+            set_error(error_code::invalid_header);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{error_msg + field};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void handle_error_header_too_wide() {
+        constexpr static auto error_msg =
+            ": header has too many columns, limit: ";
+
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg).append(
+                std::to_string(max_columns::size));
+        } else if constexpr (structured_error) {
+            set_error(error_code::too_many_columns);
+            error_.expected = max_columns::size;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg +
+                                std::to_string(max_columns::size)};
+        } else {
+            error_ = true;
+        }
+    }
+
+    void decorate_rethrow(const ss::exception& e) const {
+        static_assert(throw_on_error,
+                      "throw_on_error needs to be enabled to use this method");
+        throw ss::exception{std::string{file_name_}
+                                .append(" ")
+                                .append(std::to_string(line()))
+                                .append(": ")
+                                .append(e.what())};
+    }
+
+    ////////////////
+    // line reading
+    ////////////////
+
+    // the splitter and the converter use the memory resource only if
+    // 'use_pmr' is enabled
+    template <typename T>
+    static T make_with_resource(ss::memory_resource* resource) {
+        if constexpr (use_pmr) {
+            return T{resource};
+        } else {
+            (void)resource;
+            return T{};
+        }
+    }
+
+    void open() {
+        SSP_PROBE2(file_open, file_name_.c_str(), reader_.file_ != nullptr);
+        if (reader_.file_) {
+            read_line();
+            if constexpr (ignore_header) {
+                ignore_next();
+            } else {
+                raw_header_ = reader_.get_buffer();
+            }
+        } else {
+            handle_error_file_not_open();
+            eof_ = true;
+        }
+    }
+
+    void read_line() {
+        reader_.timed(&parser_stats::read_ticks,
+                      [this] { eof_ = !reader_.read_next(); });
+    }
+
+    struct reader {
+        reader(const std::string& file_name_, const std::string& delim,
+               ss::memory_resource* resource)
+            : converters_{make_with_resource<converter<Options...>>(resource),
+                          make_with_resource<converter<Options...>>(resource)},
+              delim_{delim}, file_{fopen(file_name_.c_str(), "rb")},
+              raw_(make_allocator<use_pmr>(resource)),
+              next_raw_(make_allocator<use_pmr>(resource)),
+              resource_{resource} {
+        }
+
+        reader(reader&& other)
+            : buffer_{other.buffer_},
+              next_line_buffer_{other.next_line_buffer_},
+              helper_buffer_{other.helper_buffer_},
+              converters_{std::move(other.converters_)},
+              buffer_size_{other.buffer_size_},
+              next_line_buffer_size_{other.next_line_buffer_size_},
+              helper_size_{other.helper_size_}, delim_{std::move(other.delim_)},
+              file_{other.file_}, crlf_{other.crlf_},
+              line_number_{other.line_number_},
+              next_line_size_{other.next_line_size_},
+              bytes_read_{other.bytes_read_},
+              next_line_offset_{other.next_line_offset_},
+              line_offset_{other.line_offset_}, line_size_{other.line_size_},
+              capture_raw_{other.capture_raw_},
+              raw_started_{other.raw_started_}, raw_{std::move(other.raw_)},
+              next_raw_{std::move(other.next_raw_)}, stats_{other.stats_},
+              timed_{other.timed_},
+              record_size_estimate_{other.record_size_estimate_},
+              resource_{other.resource_} {
+            select_converters(other);
+            other.buffer_ = nullptr;
+            other.next_line_buffer_ = nullptr;
+            other.helper_buffer_ = nullptr;
+            other.file_ = nullptr;
+        }
+
+        reader& operator=(reader&& other) {
+            if (this != &other) {
+                buffer_ = other.buffer_;
+                next_line_buffer_ = other.next_line_buffer_;
+                helper_buffer_ = other.helper_buffer_;
+                converters_ = std::move(other.converters_);
+                select_converters(other);
+                buffer_size_ = other.buffer_size_;
+                next_line_buffer_size_ = other.next_line_buffer_size_;
+                helper_size_ = other.helper_size_;
+                delim_ = std::move(other.delim_);
+                file_ = other.file_;
+                crlf_ = other.crlf_;
+                line_number_ = other.line_number_;
+                next_line_size_ = other.next_line_size_;
+                bytes_read_ = other.bytes_read_;
+                next_line_offset_ = other.next_line_offset_;
+                line_offset_ = other.line_offset_;
+                line_size_ = other.line_size_;
+                capture_raw_ = other.capture_raw_;
+                raw_started_ = other.raw_started_;
+                raw_ = std::move(other.raw_);
+                next_raw_ = std::move(other.next_raw_);
+                stats_ = other.stats_;
+                timed_ = other.timed_;
+                record_size_estimate_ = other.record_size_estimate_;
+                resource_ = other.resource_;
+
+                other.buffer_ = nullptr;
+                other.next_line_buffer_ = nullptr;
+                other.helper_buffer_ = nullptr;
+                other.file_ = nullptr;
+            }
+
+            return *this;
+        }
+
+        // the converters keep the roles they had in the other reader
+        void select_converters(const reader& other) {
+            size_t current = other.converter_ - other.converters_.data();
+            converter_ = &converters_[current];
+            next_line_converter_ = &converters_[1 - current];
+        }
+
+        ~reader() {
+            deallocate(buffer_, buffer_size_);
+            deallocate(next_line_buffer_, next_line_buffer_size_);
+            deallocate(helper_buffer_, helper_size_);
+
+            if (file_) {
+                fclose(file_);
+            }
+        }
+
+        reader() = delete;
+        reader(const reader& other) = delete;
+        reader& operator=(const reader& other) = delete;
+
+        // read next line each time in order to set eof_
+        bool read_next() {
+            if constexpr (shrink_buffers) {
+                shrink_if_oversized(next_line_buffer_, next_line_buffer_size_);
+                shrink_if_oversized(helper_buffer_, helper_size_);
+            }
+
+            next_line_converter_->clear_error();
+            ssize_t ssize = 0;
+            size_t size = 0;
+            while (size == 0) {
+                ++line_number_;
+                if (next_line_buffer_size_ > 0) {
+                    next_line_buffer_[0] = '\0';
+                }
+                next_line_offset_ = bytes_read_;
+                ssize = get_line(next_line_buffer_, next_line_buffer_size_);
 
-            return to_object<T>(
-                convert_impl(elems, static_cast<arg_tuple*>(nullptr)));
-        } else {
-            return convert_impl<T, Ts...>(elems);
-        }
-    }
+                if (ssize == -1) {
+                    return false;
+                }
+                bytes_read_ += ssize;
+                SSP_PROBE2(read_line, line_number_, ssize);
+                if constexpr (collect_stats) {
+                    ++stats_.lines;
+                }
 
-    // same as above, but uses cached split line
-    template <typename T, typename... Ts>
-    no_void_validator_tup_t<T, Ts...> convert() {
-        return convert<T, Ts...>(splitter_.split_data_);
-    }
+                size = remove_eol(next_line_buffer_, ssize);
 
-    bool valid() const {
-        if constexpr (string_error) {
-            return error_.empty();
-        } else if constexpr (throw_on_error) {
+                if constexpr (!ignore_empty) {
+                    break;
+                }
+            }
+
+            next_line_size_ = size;
             return true;
-        } else {
-            return !error_;
         }
-    }
 
-    const std::string& error_msg() const {
-        assert_string_error_defined<string_error>();
-        return error_;
-    }
+        void parse(size_t columns = 0) {
+            if constexpr (collect_stats) {
+                if constexpr (timing_sample_rate > 0) {
+                    timed_ = stats_.records % timing_sample_rate == 0;
+                    stats_.timed_records += timed_;
+                }
+                ++stats_.records;
 
-    bool unterminated_quote() const {
-        return splitter_.unterminated_quote();
-    }
+                timed(&parser_stats::split_ticks,
+                      [&] { parse_record(columns); });
+                stats_.fields_split +=
+                    next_line_converter_->splitter_.split_data_.size();
+            } else {
+                parse_record(columns);
+            }
 
-    // 'splits' string by given delimiter, returns vector of pairs which
-    // contain the beginnings and the ends of each column of the string
-    const split_data& split(line_ptr_type line,
-                            const std::string& delim = default_delimiter) {
-        splitter_.split_data_.clear();
-        if (line[0] == '\0') {
-            return splitter_.split_data_;
+            // the last line appended could have made the record too large
+            if constexpr (max_record_size::enabled) {
+                if (next_line_converter_->valid()) {
+                    record_too_large();
+                }
+            }
+
+            if constexpr (estimate_record_size) {
+                update_record_size_estimate(record_size());
+            }
         }
 
-        return splitter_.split(line, delim);
-    }
+        // invokes the function, the time spent is added to the counter if
+        // the current record is sampled
+        template <typename Fun>
+        decltype(auto) timed(uint64_t parser_stats::*counter, Fun&& fun) {
+            if constexpr (timing_sample_rate > 0) {
+                tick_timer timer{timed_ ? &(stats_.*counter) : nullptr};
+                return fun();
+            } else {
+                return fun();
+            }
+        }
 
-private:
-    ////////////////
-    // resplit
-    ////////////////
+        void parse_record(size_t columns) {
+            size_t limit = 0;
+            raw_started_ = false;
+            // captured before any line is appended, so the raw record is
+            // also set if the record ends with an error while joining
+            capture_raw_if_enabled();
 
-    const split_data& resplit(line_ptr_type new_line, ssize_t new_size,
-                              const std::string& delim) {
-        return splitter_.resplit(new_line, new_size, delim);
-    }
+            if constexpr (escaped_multiline_enabled) {
+                while (escaped_eol(next_line_size_)) {
+                    if (record_limit_reached(limit)) {
+                        return;
+                    }
 
-    size_t size_shifted() {
-        return splitter_.size_shifted();
-    }
+                    if (!append_next_line_to_buffer(next_line_buffer_,
+                                                    next_line_size_)) {
+                        next_line_converter_
+                            ->handle_error_unterminated_escape();
+                        return;
+                    }
+                }
+            }
 
-    ////////////////
-    // error
-    ////////////////
+            next_line_converter_->split(next_line_buffer_, delim_, columns);
 
-    void clear_error() {
-        if constexpr (string_error) {
-            error_.clear();
-        } else {
-            error_ = false;
-        }
-    }
+            if constexpr (quoted_multiline_enabled) {
+                while (unterminated_quote()) {
+                    next_line_size_ -= next_line_converter_->size_shifted();
 
-    std::string error_sufix(const string_range msg, size_t pos) const {
-        std::string error;
-        error.reserve(32);
-        error.append("at column ")
-            .append(std::to_string(pos + 1))
-            .append(": \'")
-            .append(msg.first, msg.second)
-            .append("\'");
-        return error;
-    }
+                    if (record_limit_reached(limit)) {
+                        return;
+                    }
 
-    void handle_error_bad_split() {
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(splitter_.error_msg());
-        } else if constexpr (!throw_on_error) {
-            error_ = true;
-        }
-    }
+                    if (!append_next_line_to_buffer(next_line_buffer_,
+                                                    next_line_size_)) {
+                        next_line_converter_->handle_error_unterminated_quote();
+                        return;
+                    }
 
-    void handle_error_unterminated_escape() {
-        if constexpr (string_error) {
-            error_.clear();
-            splitter_.handle_error_unterminated_escape();
-            error_.append(splitter_.error_msg());
-        } else if constexpr (throw_on_error) {
-            splitter_.handle_error_unterminated_escape();
-        } else {
-            error_ = true;
-        }
-    }
+                    if constexpr (escaped_multiline_enabled) {
+                        while (escaped_eol(next_line_size_)) {
+                            if (record_limit_reached(limit)) {
+                                return;
+                            }
 
-    void handle_error_unterminated_quote() {
-        if constexpr (string_error) {
-            error_.clear();
-            splitter_.handle_error_unterminated_quote();
-            error_.append(splitter_.error_msg());
-        } else if constexpr (throw_on_error) {
-            splitter_.handle_error_unterminated_quote();
-        } else {
-            error_ = true;
-        }
-    }
+                            if (!append_next_line_to_buffer(next_line_buffer_,
+                                                            next_line_size_)) {
+                                next_line_converter_
+                                    ->handle_error_unterminated_escape();
+                                return;
+                            }
+                        }
+                    }
 
-    void handle_error_multiline_limit_reached() {
-        constexpr static auto error_msg = "multiline limit reached";
+                    next_line_converter_->resplit(next_line_buffer_,
+                                                  next_line_size_, delim_);
+                }
+            }
+        }
 
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg);
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg};
-        } else {
-            error_ = true;
+        void update() {
+            std::swap(buffer_, next_line_buffer_);
+            std::swap(buffer_size_, next_line_buffer_size_);
+            std::swap(converter_, next_line_converter_);
+            line_offset_ = next_line_offset_;
+            line_size_ = next_line_size_;
+            if constexpr (!is_const_line) {
+                std::swap(raw_, next_raw_);
+            }
         }
-    }
 
-    void handle_error_invalid_conversion(const string_range msg, size_t pos) {
-        constexpr static auto error_msg = "invalid conversion for parameter ";
+        // the splitter modifies the line if quoting or escaping is enabled
+        // so it has to be copied before it is split, the lines appended to
+        // it later are copied as they are read
+        void capture_raw_if_enabled() {
+            if constexpr (!is_const_line) {
+                if (capture_raw_) {
+                    next_raw_.assign(next_line_buffer_, next_line_size_);
+                    raw_started_ = true;
+                }
+            }
+        }
 
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg).append(error_sufix(msg, pos));
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg + error_sufix(msg, pos)};
-        } else {
-            error_ = true;
+        std::string_view get_raw() const {
+            if constexpr (is_const_line) {
+                return std::string_view{buffer_, line_size_};
+            } else {
+                return raw_;
+            }
         }
-    }
 
-    void handle_error_validation_failed(const char* const error,
-                                        const string_range msg, size_t pos) {
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error).append(" ").append(error_sufix(msg, pos));
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error + (" " + error_sufix(msg, pos))};
-        } else {
-            error_ = true;
+        // checked before the next line is appended to the record
+        bool record_limit_reached(size_t& limit) {
+            if constexpr (multiline::size > 0) {
+                if (limit++ >= multiline::size) {
+                    next_line_converter_
+                        ->handle_error_multiline_limit_reached();
+                    return true;
+                }
+            }
+            return record_too_large();
         }
-    }
 
-    void handle_error_number_of_columns(size_t expected_pos, size_t pos) {
-        constexpr static auto error_msg1 =
-            "invalid number of columns, expected: ";
-        constexpr static auto error_msg2 = ", got: ";
+        ////////////////
+        // record size
+        ////////////////
 
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg1)
-                .append(std::to_string(expected_pos))
-                .append(error_msg2)
-                .append(std::to_string(pos));
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg1 + std::to_string(expected_pos) +
-                                error_msg2 + std::to_string(pos)};
-        } else {
-            error_ = true;
+        // bytes of the record read so far, including the new lines
+        size_t record_size() const {
+            return bytes_read_ - next_line_offset_;
         }
-    }
-
-    void handle_error_incompatible_mapping(size_t argument_size,
-                                           size_t mapping_size) {
-        constexpr static auto error_msg1 =
-            "number of arguments does not match mapping, expected: ";
-        constexpr static auto error_msg2 = ", got: ";
 
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg1)
-                .append(std::to_string(mapping_size))
-                .append(error_msg2)
-                .append(std::to_string(argument_size));
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg1 + std::to_string(mapping_size) +
-                                error_msg2 + std::to_string(argument_size)};
-        } else {
-            error_ = true;
+        // the lines of the record which are not read yet are read as
+        // separate records, as when the multiline limit is reached
+        bool record_too_large() {
+            if constexpr (max_record_size::enabled) {
+                if (record_size() > max_record_size::size) {
+                    next_line_converter_->handle_error_record_too_large(
+                        max_record_size::size);
+                    return true;
+                }
+            }
+            return false;
         }
-    }
 
-    ////////////////
-    // convert implementation
-    ////////////////
+        // the estimate moves towards the 90th percentile of the record
+        // sizes, it is exceeded by about one record in ten
+        void update_record_size_estimate(size_t size) {
+            size_t step = record_size_estimate_ / 32 + 1;
+            if (size > record_size_estimate_) {
+                record_size_estimate_ += 9 * step;
+            } else {
+                record_size_estimate_ -= std::min(step, record_size_estimate_);
+            }
+        }
 
-    template <typename... Ts>
-    no_void_validator_tup_t<Ts...> convert_impl(const split_data& elems) {
-        clear_error();
+        // buffers left much larger than the usual records by an oversized
+        // one are released, and allocated again when the next line is read
+        void shrink_if_oversized(char*& buffer, size_t& size) {
+            constexpr static size_t min_shrink_size = 64 * 1024;
+            constexpr static size_t shrink_factor = 8;
+
+            if (size > min_shrink_size &&
+                size > shrink_factor * record_size_estimate_) {
+                deallocate(buffer, size);
+                buffer = nullptr;
+                size = 0;
+                if constexpr (collect_stats) {
+                    ++stats_.buffer_shrinks;
+                }
+            }
+        }
 
-        if (!splitter_.valid()) {
-            handle_error_bad_split();
-            return {};
+        bool escaped_eol(size_t size) {
+            const char* curr;
+            for (curr = next_line_buffer_ + size - 1;
+                 curr >= next_line_buffer_ &&
+                 setup<Options...>::escape::match(*curr);
+                 --curr) {
+            }
+            return (next_line_buffer_ - curr + size) % 2 == 0;
         }
 
-        if (!columns_mapped()) {
-            if (sizeof...(Ts) != elems.size()) {
-                handle_error_number_of_columns(sizeof...(Ts), elems.size());
-                return {};
-            }
-        } else {
-            if (sizeof...(Ts) != column_mappings_.size()) {
-                handle_error_incompatible_mapping(sizeof...(Ts),
-                                                  column_mappings_.size());
-                return {};
-            }
+        bool unterminated_quote() {
+            return next_line_converter_->unterminated_quote();
+        }
 
-            if (elems.size() != number_of_columns_) {
-                handle_error_number_of_columns(number_of_columns_,
-                                               elems.size());
-                return {};
+        void undo_remove_eol(char* buffer, size_t& string_end) {
+            if (crlf_) {
+                std::copy_n("\r\n\0", 3, buffer + string_end);
+                string_end += 2;
+            } else {
+                std::copy_n("\n\0", 2, buffer + string_end);
+                string_end += 1;
             }
         }
 
-        return extract_tuple<Ts...>(elems);
-    }
+        size_t remove_eol(char*& buffer, size_t ssize) {
+            size_t size = ssize - 1;
+            if (ssize >= 2 && buffer[ssize - 2] == '\r') {
+                crlf_ = true;
+                size--;
+            } else {
+                crlf_ = false;
+            }
 
-    // do not know how to specialize by return type :(
-    template <typename... Ts>
-    no_void_validator_tup_t<std::tuple<Ts...>> convert_impl(
-        const split_data& elems, const std::tuple<Ts...>*) {
-        return convert_impl<Ts...>(elems);
-    }
+            buffer[size] = '\0';
+            return size;
+        }
 
-    ////////////////
-    // column mapping
-    ////////////////
+        // the capacity of the buffer is at least doubled when it grows, so
+        // the cost of joining the lines of a record is linear in its size
+        void realloc_concat(char*& first, size_t& first_size,
+                            size_t& buffer_size, const char* const second,
+                            size_t second_size) {
+            // space for the new line and the null character appended by
+            // undo_remove_eol if another line is joined after this one
+            size_t required_size = first_size + second_size + 3;
+            if (required_size > buffer_size) {
+                size_t new_size = std::max(required_size, 2 * buffer_size);
+                auto new_first =
+                    reallocate(first, buffer_size, new_size, first_size);
+                if (!new_first) {
+                    throw std::bad_alloc{};
+                }
 
-    bool columns_mapped() const {
-        return column_mappings_.size() != 0;
-    }
+                first = new_first;
+                buffer_size = new_size;
+                if constexpr (collect_stats) {
+                    ++stats_.reallocs;
+                }
+            }
 
-    size_t column_position(size_t tuple_position) const {
-        if (!columns_mapped()) {
-            return tuple_position;
+            std::copy_n(second, second_size + 1, first + first_size);
+            first_size += second_size;
         }
-        return column_mappings_[tuple_position];
-    }
-
-    // assumes positions are valid and the vector is not empty
-    void set_column_mapping(std::vector<size_t> positions,
-                            size_t number_of_columns) {
-        column_mappings_ = positions;
-        number_of_columns_ = number_of_columns;
-    }
 
-    void clear_column_positions() {
-        column_mappings_.clear();
-        number_of_columns_ = 0;
-    }
+        bool append_next_line_to_buffer(char*& buffer, size_t& size) {
+            undo_remove_eol(buffer, size);
 
-    ////////////////
-    // conversion
-    ////////////////
+            ssize_t next_ssize = get_line(helper_buffer_, helper_size_);
+            if (next_ssize == -1) {
+                return false;
+            }
 
-    template <typename T>
-    void extract_one(no_validator_t<T>& dst, const string_range msg,
-                     size_t pos) {
-        if (!valid()) {
-            return;
+            bytes_read_ += next_ssize;
+            ++line_number_;
+            SSP_PROBE2(multiline_join, line_number_, next_ssize);
+            if constexpr (collect_stats) {
+                ++stats_.lines;
+                ++stats_.multiline_joins;
+            }
+            if constexpr (!is_const_line) {
+                if (raw_started_) {
+                    next_raw_.append(crlf_ ? "\r\n" : "\n");
+                }
+            }
+            size_t next_size = remove_eol(helper_buffer_, next_ssize);
+            if constexpr (!is_const_line) {
+                if (raw_started_) {
+                    next_raw_.append(helper_buffer_, next_size);
+                }
+            }
+            realloc_concat(buffer, size, next_line_buffer_size_, helper_buffer_,
+                           next_size);
+            return true;
         }
 
-        if constexpr (std::is_same_v<T, std::string>) {
-            extract(msg.first, msg.second, dst);
-            return;
+        std::string_view get_buffer() {
+            return std::string_view{next_line_buffer_, next_line_size_};
         }
 
-        if (!extract(msg.first, msg.second, dst)) {
-            handle_error_invalid_conversion(msg, pos);
-            return;
+        ////////////////
+        // allocation
+        ////////////////
+
+        // the buffers are allocated using the memory resource if 'use_pmr'
+        // is enabled, or with malloc as done by getline otherwise
+        ssize_t get_line(char*& buffer, size_t& size) {
+            if constexpr (use_pmr) {
+                return ss::get_line(&buffer, &size, file_, resource_);
+            } else {
+                return ss::get_line(&buffer, &size, file_);
+            }
         }
 
-        if constexpr (has_m_ss_valid_t<T>) {
-            if (T validator; !validator.ss_valid(dst)) {
-                if constexpr (has_m_error_t<T>) {
-                    handle_error_validation_failed(validator.error(), msg, pos);
-                } else {
-                    handle_error_validation_failed("validation error", msg,
-                                                   pos);
+        char* reallocate(char* buffer, size_t size, size_t new_size,
+                         size_t used) {
+            if constexpr (use_pmr) {
+                auto new_buffer =
+                    static_cast<char*>(resource_->allocate(new_size, 1));
+                if (buffer != nullptr) {
+                    std::copy_n(buffer, used, new_buffer);
+                    resource_->deallocate(buffer, size, 1);
                 }
-                return;
+                return new_buffer;
+            } else {
+                (void)size;
+                (void)used;
+                return static_cast<char*>(
+                    realloc(static_cast<void*>(buffer), new_size));
             }
         }
-    }
-
-    template <size_t ArgN, size_t TupN, typename... Ts>
-    void extract_multiple(no_void_validator_tup_t<Ts...>& tup,
-                          const split_data& elems) {
-        using elem_t = std::tuple_element_t<ArgN, std::tuple<Ts...>>;
-
-        constexpr bool not_void = !std::is_void_v<elem_t>;
-        constexpr bool one_element = count_not_v<std::is_void, Ts...> == 1;
 
-        if constexpr (not_void) {
-            if constexpr (one_element) {
-                extract_one<elem_t>(tup, elems[column_position(ArgN)], ArgN);
+        void deallocate(char* buffer, size_t size) {
+            if constexpr (use_pmr) {
+                if (buffer != nullptr) {
+                    resource_->deallocate(buffer, size, 1);
+                }
             } else {
-                auto& el = std::get<TupN>(tup);
-                extract_one<elem_t>(el, elems[column_position(ArgN)], ArgN);
+                (void)size;
+                free(buffer);
             }
         }
 
-        if constexpr (sizeof...(Ts) > ArgN + 1) {
-            constexpr size_t NewTupN = (not_void) ? TupN + 1 : TupN;
-            extract_multiple<ArgN + 1, NewTupN, Ts...>(tup, elems);
-        }
-    }
+        ////////////////
+        // members
+        ////////////////
+        char* buffer_{nullptr};
+        char* next_line_buffer_{nullptr};
+        char* helper_buffer_{nullptr};
 
-    template <typename... Ts>
-    no_void_validator_tup_t<Ts...> extract_tuple(const split_data& elems) {
-        static_assert(!all_of_v<std::is_void, Ts...>,
-                      "at least one parameter must be non void");
-        no_void_validator_tup_t<Ts...> ret{};
-        extract_multiple<0, 0, Ts...>(ret, elems);
-        return ret;
-    }
+        // the converters are swapped by their pointers after each record,
+        // so the split data, which may be an array, is not moved
+        std::array<converter<Options...>, 2> converters_;
+        converter<Options...>* converter_{&converters_[0]};
+        converter<Options...>* next_line_converter_{&converters_[1]};
+
+        size_t buffer_size_{0};
+        size_t next_line_buffer_size_{0};
+        size_t helper_size_{0};
+
+        std::string delim_;
+        FILE* file_{nullptr};
+
+        bool crlf_{false};
+        size_t line_number_{0};
+
+        size_t next_line_size_{0};
+
+        // byte offsets within the file
+        size_t bytes_read_{0};
+        size_t next_line_offset_{0};
+        size_t line_offset_{0};
+        size_t line_size_{0};
+
+        // raw records captured for the reject sink
+        bool capture_raw_{false};
+        bool raw_started_{false};
+        string_t<use_pmr> raw_;
+        string_t<use_pmr> next_raw_;
+
+        std::conditional_t<collect_stats, parser_stats, none> stats_{};
+        bool timed_{false};
+        size_t record_size_estimate_{0};
+        ss::memory_resource* resource_{nullptr};
+    };
 
     ////////////////
     // members
     ////////////////
 
+    std::string file_name_;
     error_type error_{};
-    splitter<Options...> splitter_;
-
-    template <typename...>
-    friend class parser;
-
-    std::vector<size_t> column_mappings_;
-    size_t number_of_columns_;
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
+    std::conditional_t<record_errors, std::vector<ss::error_info>, none>
+        recorded_errors_;
+    size_t error_count_{0};
+    reject_sink reject_sink_;
+    reader reader_;
+    vector_t<use_pmr, string_t<use_pmr>> header_;
+    vector_t<use_pmr, size_t> header_slots_;
+    string_t<use_pmr> raw_header_;
+    bool eof_{false};
 };
 
 } /* ss */
 
-// TODO add single header tests
-
 namespace ss {
 
+////////////////
+// push parser
+////////////////
+
+// parser for input which arrives in fragments of arbitrary size, eg. from
+// a socket or a message queue, the fragments are passed using 'feed' and
+// every complete record is converted and passed to the function given to
+// 'on_row', only the current incomplete record is buffered
 template <typename... Options>
-class parser {
+class push_parser {
     constexpr static auto string_error = setup<Options...>::string_error;
     constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
 
     using multiline = typename setup<Options...>::multiline;
-    using error_type = std::conditional_t<string_error, std::string, bool>;
 
     constexpr static bool escaped_multiline_enabled =
         multiline::enabled && setup<Options...>::escape::enabled;
@@ -2156,492 +6505,726 @@ class parser {
     constexpr static bool ignore_empty = setup<Options...>::ignore_empty;
 
 public:
-    parser(const std::string& file_name,
-           const std::string& delim = ss::default_delimiter)
-        : file_name_{file_name}, reader_{file_name_, delim} {
-        if (reader_.file_) {
-            read_line();
-            if constexpr (ignore_header) {
-                ignore_next();
-            } else {
-                raw_header_ = reader_.get_buffer();
-            }
-        } else {
-            handle_error_file_not_open();
-            eof_ = true;
-        }
+    push_parser(const std::string& delim = ss::default_delimiter)
+        : delim_{delim} {
     }
 
-    parser(parser&& other) = default;
-    parser& operator=(parser&& other) = default;
+    push_parser(push_parser&& other) = default;
+    push_parser& operator=(push_parser&& other) = default;
 
-    parser() = delete;
-    parser(const parser& other) = delete;
-    parser& operator=(const parser& other) = delete;
+    push_parser(const push_parser& other) = delete;
+    push_parser& operator=(const push_parser& other) = delete;
 
     bool valid() const {
-        if constexpr (string_error) {
-            return error_.empty();
-        } else if constexpr (throw_on_error) {
-            return true;
-        } else {
-            return !error_;
-        }
+        return converter_.valid();
     }
 
     const std::string& error_msg() const {
-        assert_string_error_defined<string_error>();
-        return error_;
+        return converter_.error_msg();
     }
 
-    bool eof() const {
-        return eof_;
+    const ss::error_info& error_info() const {
+        return converter_.error_info();
     }
 
-    bool ignore_next() {
-        return reader_.read_next();
+    // line of the input, the last one of the record if it spans multiple
+    // lines
+    size_t line() const {
+        return line_number_;
     }
 
-    template <typename T, typename... Ts>
-    T get_object() {
-        return to_object<T>(get_next<Ts...>());
+    // sets the function invoked with every record converted into 'T' and
+    // 'Ts', the function can accept the values as separate arguments or
+    // as a tuple, as with the iterators of the parser, the record was
+    // converted only if 'valid' returns true, views into the record are
+    // valid only during the invocation
+    template <typename T, typename... Ts, typename Fun>
+    void on_row(Fun&& fun) {
+        using Value = no_void_validator_tup_t<T, Ts...>;
+        row_handler_ = [fun = std::forward<Fun>(fun)](
+                           push_parser& p) mutable {
+            Value value{};
+            if (p.converter_.valid()) {
+                value = p.converter_.template convert<T, Ts...>();
+            }
+
+            if constexpr (std::is_invocable_v<std::decay_t<Fun>&, Value&>) {
+                fun(value);
+            } else {
+                std::apply(fun, value);
+            }
+        };
     }
 
-    size_t line() const {
-        return reader_.line_number_ > 1 ? reader_.line_number_ - 1
-                                        : reader_.line_number_;
+    // passes the next fragment of the input, the records completed by it
+    // are handled before returning, if an exception is thrown the rest of
+    // the fragment is discarded
+    void feed(const char* data, size_t size) {
+        const char* end = data + size;
+        while (data != end) {
+            auto eol = static_cast<const char*>(
+                std::memchr(data, '\n', end - data));
+            if (eol == nullptr) {
+                record_.append(data, end);
+                return;
+            }
+
+            record_.append(data, eol);
+            data = eol + 1;
+            read_line_and_reset_on_error();
+        }
     }
 
-    template <typename T, typename... Ts>
-    no_void_validator_tup_t<T, Ts...> get_next() {
-        std::optional<std::string> error;
+    void feed(const std::string& data) {
+        feed(data.data(), data.size());
+    }
 
-        if (!eof_) {
+    // handles the last line if it is not terminated by a new line, a
+    // record which is still incomplete is passed as invalid, the parser
+    // can be used for the next input afterwards
+    void finish() {
+        finish_input();
+        line_number_ = 0;
+        header_ignored_ = false;
+    }
+
+private:
+    ////////////////
+    // reading
+    ////////////////
+
+    void finish_input() {
+        if (record_.size() > line_begin_) {
+            read_line_and_reset_on_error();
+        }
+
+        if (pending_) {
+            bool escaped = pending_escape_;
             if constexpr (throw_on_error) {
-                try {
-                    reader_.parse();
-                } catch (const ss::exception& e) {
-                    read_line();
-                    decorate_rethrow(e);
-                }
+                reset_record();
+            }
+
+            if (escaped) {
+                converter_.handle_error_unterminated_escape();
             } else {
-                reader_.parse();
+                converter_.handle_error_unterminated_quote();
+            }
+            handle_record();
+        }
+    }
+
+    void read_line_and_reset_on_error() {
+        if constexpr (throw_on_error) {
+            try {
+                read_line();
+            } catch (...) {
+                reset_record();
+                throw;
+            }
+        } else {
+            read_line();
+        }
+    }
+
+    // the same steps as done by the reader of the parser, but the next
+    // line of a multiline record is waited for instead of read
+    void read_line() {
+        ++line_number_;
+        remove_eol();
+
+        if (!pending_) {
+            converter_.clear_error();
+            if constexpr (ignore_header) {
+                if (!header_ignored_) {
+                    header_ignored_ = true;
+                    reset_record();
+                    return;
+                }
+            }
+
+            if constexpr (ignore_empty) {
+                if (record_.empty()) {
+                    return;
+                }
             }
         }
 
-        reader_.update();
-        if (!reader_.converter_.valid()) {
-            handle_error_invalid_conversion();
-            read_line();
-            return {};
+        if constexpr (escaped_multiline_enabled) {
+            if (escaped_eol()) {
+                if (!multiline_limit_reached()) {
+                    wait_for_next_line(true);
+                }
+                return;
+            }
         }
 
-        clear_error();
-
-        if (eof_) {
-            handle_error_eof_reached();
-            return {};
+        if (!split_) {
+            converter_.split(record_.data(), delim_);
+            split_ = true;
+        } else {
+            converter_.resplit(record_.data(), record_.size(), delim_);
         }
 
-        if constexpr (throw_on_error) {
-            try {
-                auto value = reader_.converter_.template convert<T, Ts...>();
-                read_line();
-                return value;
-            } catch (const ss::exception& e) {
-                read_line();
-                decorate_rethrow(e);
+        if constexpr (quoted_multiline_enabled) {
+            if (converter_.unterminated_quote()) {
+                record_.resize(record_.size() - converter_.size_shifted());
+                if (!multiline_limit_reached()) {
+                    wait_for_next_line(false);
+                }
+                return;
             }
         }
 
-        auto value = reader_.converter_.template convert<T, Ts...>();
+        handle_record();
+    }
 
-        if (!reader_.converter_.valid()) {
-            handle_error_invalid_conversion();
+    void handle_record() {
+        if (row_handler_) {
+            row_handler_(*this);
         }
-
-        read_line();
-        return value;
+        reset_record();
     }
 
-    bool field_exists(const std::string& field) {
-        if (header_.empty()) {
-            split_header_data();
-        }
+    void reset_record() {
+        record_.clear();
+        line_begin_ = 0;
+        multiline_count_ = 0;
+        pending_ = false;
+        pending_escape_ = false;
+        split_ = false;
+    }
 
-        return header_index(field).has_value();
+    void wait_for_next_line(bool escaped) {
+        record_.append(crlf_ ? "\r\n" : "\n");
+        line_begin_ = record_.size();
+        pending_ = true;
+        pending_escape_ = escaped;
     }
 
-    template <typename... Ts>
-    void use_fields(const Ts&... fields_args) {
-        if constexpr (ignore_header) {
-            handle_error_header_ignored();
-            return;
+    // passes the record as invalid if the limit is reached
+    bool multiline_limit_reached() {
+        if constexpr (multiline::size > 0) {
+            if (multiline_count_++ >= multiline::size) {
+                converter_.handle_error_multiline_limit_reached();
+                handle_record();
+                return true;
+            }
         }
+        return false;
+    }
 
-        if (header_.empty()) {
-            split_header_data();
+    bool escaped_eol() const {
+        size_t escapes = 0;
+        for (auto it = record_.rbegin();
+             it != record_.rend() && setup<Options...>::escape::match(*it);
+             ++it) {
+            ++escapes;
         }
+        return escapes % 2 == 1;
+    }
 
-        if (!valid()) {
-            return;
+    void remove_eol() {
+        crlf_ = record_.size() > line_begin_ && record_.back() == '\r';
+        if (crlf_) {
+            record_.pop_back();
         }
+    }
 
-        auto fields = std::vector<std::string>{fields_args...};
-
-        if (fields.empty()) {
-            handle_error_empty_mapping();
-            return;
-        }
+    ////////////////
+    // members
+    ////////////////
 
-        std::vector<size_t> column_mappings;
+    std::string delim_;
+    converter<Options...> converter_;
+    std::function<void(push_parser&)> row_handler_;
+
+    // the current record, the last line of which starts at 'line_begin_'
+    std::string record_;
+    size_t line_begin_{0};
+
+    size_t line_number_{0};
+    size_t multiline_count_{0};
+    bool crlf_{false};
+    bool pending_{false};
+    bool pending_escape_{false};
+    bool split_{false};
+    bool header_ignored_{false};
+};
 
-        for (const auto& field : fields) {
-            if (std::count(fields.begin(), fields.end(), field) != 1) {
-                handle_error_field_used_multiple_times(field);
-                return;
-            }
+} /* ss */
 
-            auto index = header_index(field);
+namespace ss {
 
-            if (!index) {
-                handle_error_invalid_field(field);
-                return;
-            }
+////////////////
+// special characters
+////////////////
 
-            column_mappings.push_back(*index);
+// checks if any of the characters of the range is one of the given
+// characters, eight characters are checked at once by comparing each of
+// the bytes of a word, the characters are expected to be few
+inline bool contains_any(const char* begin, size_t size,
+                         std::string_view chars) {
+    constexpr uint64_t ones = 0x0101010101010101ull;
+    constexpr uint64_t highs = 0x8080808080808080ull;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, begin + i, sizeof(uint64_t));
+
+        uint64_t found = 0;
+        for (char c : chars) {
+            // a zero byte remains where the character matches
+            uint64_t x = word ^ (ones * static_cast<unsigned char>(c));
+            found |= (x - ones) & ~x & highs;
         }
 
-        reader_.converter_.set_column_mapping(column_mappings, header_.size());
-        reader_.next_line_converter_.set_column_mapping(column_mappings,
-                                                        header_.size());
+        if (found != 0) {
+            return true;
+        }
+    }
 
-        if (line() == 1) {
-            ignore_next();
+    for (; i < size; ++i) {
+        if (chars.find(begin[i]) != std::string_view::npos) {
+            return true;
         }
     }
+    return false;
+}
 
-    ////////////////
-    // iterator
-    ////////////////
+////////////////
+// row block
+////////////////
 
-    template <bool get_object, typename T, typename... Ts>
-    struct iterable {
-        struct iterator {
-            using value = std::conditional_t<get_object, T,
-                                             no_void_validator_tup_t<T, Ts...>>;
+// rows formatted in memory using the rules of the writer, fields are
+// quoted or escaped only if they contain special characters, blocks can be
+// formatted on multiple threads and written using the parallel writer
+template <typename... Options>
+class row_block {
+    using quote = typename setup<Options...>::quote;
+    using escape = typename setup<Options...>::escape;
+    using trim_left = typename setup<Options...>::trim_left;
+    using trim_right = typename setup<Options...>::trim_right;
 
-            iterator() : parser_{nullptr}, value_{} {
-            }
+    // enough for any number written using to_chars
+    constexpr static size_t max_number_size = 64;
 
-            iterator(parser<Options...>* parser) : parser_{parser}, value_{} {
-            }
+public:
+    row_block(const std::string& delim = ss::default_delimiter,
+              size_t capacity = 0)
+        : delim_{delim} {
+        special_ = delim_ + "\r\n";
+        if constexpr (quote::enabled) {
+            special_.append(quote::matches.begin(), quote::matches.end());
+        }
+        if constexpr (escape::enabled) {
+            special_.append(escape::matches.begin(), escape::matches.end());
+        }
+        reserve(capacity);
+    }
 
-            iterator(const iterator& other) = default;
-            iterator(iterator&& other) = default;
+    row_block(row_block&& other) = default;
+    row_block& operator=(row_block&& other) = default;
 
-            value& operator*() {
-                return value_;
-            }
+    row_block(const row_block& other) = delete;
+    row_block& operator=(const row_block& other) = delete;
 
-            value* operator->() {
-                return &value_;
-            }
+    // appends one row, the values can be given separately, as a tuple or
+    // as a non const object with a 'tied' method, returns false and
+    // leaves the block unchanged if a field cannot be written
+    template <typename T, typename... Ts>
+    bool write(T&& value, Ts&&... values) {
+        using U = std::decay_t<T>;
+        if constexpr (sizeof...(Ts) == 0 && is_instance_of_v<std::tuple, U>) {
+            return std::apply(
+                [this](auto&&... vs) { return write_row(vs...); }, value);
+        } else if constexpr (tied_class_v<U>) {
+            auto refs = value.tied();
+            return std::apply(
+                [this](auto&&... vs) { return write_row(vs...); }, refs);
+        } else {
+            return write_row(value, values...);
+        }
+    }
 
-            iterator& operator++() {
-                if (!parser_ || parser_->eof()) {
-                    parser_ = nullptr;
-                } else {
-                    if constexpr (get_object) {
-                        value_ =
-                            std::move(parser_->template get_object<T, Ts...>());
-                    } else {
-                        value_ =
-                            std::move(parser_->template get_next<T, Ts...>());
-                    }
-                }
-                return *this;
-            }
+    const char* data() const {
+        return buffer_.get();
+    }
 
-            iterator& operator++(int) {
-                return ++*this;
-            }
+    size_t size() const {
+        return size_;
+    }
 
-            friend bool operator==(const iterator& lhs, const iterator& rhs) {
-                return (lhs.parser_ == nullptr && rhs.parser_ == nullptr) ||
-                       (lhs.parser_ == rhs.parser_ &&
-                        &lhs.value_ == &rhs.value_);
-            }
+    bool empty() const {
+        return size_ == 0;
+    }
 
-            friend bool operator!=(const iterator& lhs, const iterator& rhs) {
-                return !(lhs == rhs);
-            }
+    // removes the rows but keeps the memory
+    void clear() {
+        size_ = 0;
+    }
 
-        private:
-            parser<Options...>* parser_;
-            value value_;
-        };
+    // index of the column which could not be written by the last 'write'
+    size_t invalid_column() const {
+        return invalid_column_;
+    }
 
-        iterable(parser<Options...>* parser) : parser_{parser} {
+private:
+    template <typename... Ts>
+    bool write_row(const Ts&... values) {
+        size_t row_begin = size_;
+        size_t column = 0;
+        if (!(write_column(values, column) && ...)) {
+            size_ = row_begin;
+            invalid_column_ = column;
+            return false;
         }
 
-        iterator begin() {
-            return ++iterator{parser_};
+        // replace the last delimiter
+        size_ -= delim_.size();
+        if constexpr (quote::enabled) {
+            // an empty line would be read as a row without columns
+            if (size_ == row_begin) {
+                write_plain({quote::matches.data(), 1});
+                write_plain({quote::matches.data(), 1});
+            }
         }
+        write_plain("\n");
+        return true;
+    }
 
-        iterator end() {
-            return iterator{};
+    // writes the field followed by the delimiter
+    template <typename T>
+    bool write_column(const T& value, size_t& column) {
+        if (!write_field(value)) {
+            return false;
         }
 
-    private:
-        parser<Options...>* parser_;
-    };
+        write_plain(delim_);
+        ++column;
+        return true;
+    }
 
-    template <typename... Ts>
-    auto iterate() {
-        return iterable<false, Ts...>{this};
+    ////////////////
+    // fields
+    ////////////////
+    template <typename T>
+    bool write_field(const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            return write_plain(value ? "true" : "false");
+        } else if constexpr (std::is_same_v<T, char>) {
+            return write_string(std::string_view{&value, 1});
+        } else if constexpr (std::is_integral_v<T>) {
+            reserve(max_number_size);
+            char* begin = buffer_.get() + size_;
+            auto result = std::to_chars(begin, begin + max_number_size, value);
+            size_ += result.ptr - begin;
+            return true;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            write_floating_point(value);
+            return true;
+        } else if constexpr (std::is_convertible_v<T, std::string_view>) {
+            return write_string(std::string_view{value});
+        } else if constexpr (is_instance_of_v<std::optional, T>) {
+            return !value.has_value() || write_field(*value);
+        } else if constexpr (is_instance_of_v<std::variant, T>) {
+            return std::visit([this](const auto& v) { return write_field(v); },
+                              value);
+        } else {
+            static_assert(!std::is_same_v<T, T>,
+                          "writing this type is not supported");
+        }
     }
 
-    template <typename... Ts>
-    auto iterate_object() {
-        return iterable<true, Ts...>{this};
+    template <typename T>
+    void write_floating_point(T value) {
+        reserve(max_number_size);
+        char* begin = buffer_.get() + size_;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        // the shortest representation which is read back as the same value
+        auto result = std::to_chars(begin, begin + max_number_size, value);
+        size_ += result.ptr - begin;
+#else
+        constexpr int digits = std::numeric_limits<T>::max_digits10;
+        int size = std::snprintf(begin, max_number_size, "%.*Lg", digits,
+                                 static_cast<long double>(value));
+        size_ += static_cast<size_t>(size);
+#endif
     }
 
-    ////////////////
-    // composite conversion
-    ////////////////
-    template <typename... Ts>
-    class composite {
-    public:
-        composite(std::tuple<Ts...>&& values, parser& parser)
-            : values_{std::move(values)}, parser_{parser} {
+    bool write_plain(std::string_view value) {
+        reserve(value.size());
+        std::memcpy(buffer_.get() + size_, value.data(), value.size());
+        size_ += value.size();
+        return true;
+    }
+
+    bool write_string(std::string_view value) {
+        if (!contains_any(value.data(), value.size(), special_) &&
+            !trimmed(value)) {
+            return write_plain(value);
         }
 
-        // tries to convert the same line with a different output type
-        // only if the previous conversion was not successful,
-        // returns composite containing itself and the new output
-        // as optional, additionally, if a parameter is passed, and
-        // that parameter can be invoked using the converted value,
-        // than it will be invoked in the case of a valid conversion
-        template <typename... Us, typename Fun = none>
-        composite<Ts..., std::optional<no_void_validator_tup_t<Us...>>> or_else(
-            Fun&& fun = none{}) {
-            using Value = no_void_validator_tup_t<Us...>;
-            std::optional<Value> value;
-            try_convert_and_invoke<Value, Us...>(value, fun);
-            return composite_with(std::move(value));
+        if constexpr (quote::enabled) {
+            write_quoted(value);
+            return true;
+        } else if constexpr (escape::enabled) {
+            if (trimmed(value)) {
+                return false;
+            }
+            write_escaped(value);
+            return true;
+        } else {
+            return false;
         }
+    }
 
-        // same as or_else, but saves the result into a 'U' object
-        // instead of a tuple
-        template <typename U, typename... Us, typename Fun = none>
-        composite<Ts..., std::optional<U>> or_object(Fun&& fun = none{}) {
-            std::optional<U> value;
-            try_convert_and_invoke<U, Us...>(value, fun);
-            return composite_with(std::move(value));
+    // quotes within the field are doubled, escape characters are escaped
+    void write_quoted(std::string_view value) {
+        reserve(2 * value.size() + 2);
+        char* out = buffer_.get() + size_;
+        *out++ = quote::matches[0];
+        for (char c : value) {
+            if (quote::match(c)) {
+                *out++ = c;
+            } else if constexpr (escape::enabled) {
+                if (escape::match(c)) {
+                    *out++ = escape::matches[0];
+                }
+            }
+            *out++ = c;
         }
+        *out++ = quote::matches[0];
+        size_ = out - buffer_.get();
+    }
 
-        std::tuple<Ts...> values() {
-            return values_;
+    void write_escaped(std::string_view value) {
+        reserve(2 * value.size());
+        char* out = buffer_.get() + size_;
+        for (char c : value) {
+            if (special_.find(c) != std::string::npos) {
+                *out++ = escape::matches[0];
+            }
+            *out++ = c;
         }
+        size_ = out - buffer_.get();
+    }
 
-        template <typename Fun>
-        auto on_error(Fun&& fun) {
-            assert_throw_on_error_not_defined<throw_on_error>();
-            if (!parser_.valid()) {
-                if constexpr (std::is_invocable_v<Fun>) {
-                    fun();
-                } else {
-                    static_assert(string_error,
-                                  "to enable error messages within the "
-                                  "on_error method "
-                                  "callback string_error needs to be enabled");
-                    std::invoke(std::forward<Fun>(fun), parser_.error_msg());
-                }
+    // fields which start or end with characters removed by trimming
+    bool trimmed(std::string_view value) const {
+        if (value.empty()) {
+            return false;
+        }
+
+        if constexpr (trim_left::enabled) {
+            if (trim_left::match(value.front())) {
+                return true;
             }
-            return *this;
         }
 
-    private:
-        template <typename T>
-        composite<Ts..., T> composite_with(T&& new_value) {
-            auto merged_values =
-                std::tuple_cat(std::move(values_),
-                               std::tuple<T>{parser_.valid()
-                                                 ? std::forward<T>(new_value)
-                                                 : std::nullopt});
-            return {std::move(merged_values), parser_};
+        if constexpr (trim_right::enabled) {
+            if (trim_right::match(value.back())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ////////////////
+    // buffer
+    ////////////////
+
+    // makes space for 'size' more characters
+    void reserve(size_t size) {
+        if (size_ + size <= capacity_) {
+            return;
+        }
+
+        size_t capacity = std::max(2 * capacity_, size_ + size);
+        std::unique_ptr<char[]> buffer{new char[capacity]};
+        if (size_ > 0) {
+            std::memcpy(buffer.get(), buffer_.get(), size_);
         }
+        buffer_ = std::move(buffer);
+        capacity_ = capacity;
+    }
 
-        template <typename U, typename... Us, typename Fun = none>
-        void try_convert_and_invoke(std::optional<U>& value, Fun&& fun) {
-            if (!parser_.valid()) {
-                auto tuple_output = try_same<Us...>();
-                if (!parser_.valid()) {
-                    return;
-                }
+    ////////////////
+    // members
+    ////////////////
 
-                if constexpr (!std::is_same_v<U, decltype(tuple_output)>) {
-                    value = to_object<U>(std::move(tuple_output));
-                } else {
-                    value = std::move(tuple_output);
-                }
+    std::string delim_;
 
-                parser_.try_invoke(*value, std::forward<Fun>(fun));
-            }
-        }
+    // characters which need quoting or escaping
+    std::string special_;
 
-        template <typename U, typename... Us>
-        no_void_validator_tup_t<U, Us...> try_same() {
-            parser_.clear_error();
-            auto value =
-                parser_.reader_.converter_.template convert<U, Us...>();
-            if (!parser_.reader_.converter_.valid()) {
-                parser_.handle_error_invalid_conversion();
-            }
-            return value;
+    std::unique_ptr<char[]> buffer_;
+    size_t capacity_{0};
+    size_t size_{0};
+    size_t invalid_column_{0};
+};
+
+////////////////
+// writer
+////////////////
+
+// writes rows into a file using the same setup as the parser, so the
+// written file can be read by a parser with the same setup, the rows are
+// formatted into a large buffer which is written once it is full, fields
+// which contain new lines need the 'multiline' setup option when read
+template <typename... Options>
+class writer {
+    constexpr static auto string_error = setup<Options...>::string_error;
+    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
+
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
+
+public:
+    constexpr static size_t default_buffer_size = 1024 * 1024;
+
+    writer(const std::string& file_name,
+           const std::string& delim = ss::default_delimiter,
+           size_t buffer_size = default_buffer_size)
+        : file_name_{file_name}, buffer_size_{buffer_size},
+          file_{fopen(file_name.c_str(), "wb")} {
+        if (!file_) {
+            handle_error_file_not_open();
+            return;
         }
 
-        ////////////////
-        // members
-        ////////////////
+        // the output is already buffered
+        setvbuf(file_.get(), nullptr, _IONBF, 0);
 
-        std::tuple<Ts...> values_;
-        parser& parser_;
-    };
+        // some space is left for the last row before the buffer is written
+        block_ = row_block<Options...>{delim, buffer_size_ + buffer_size_ / 4};
+    }
 
-    // tries to convert a line and returns a composite which is
-    // able to try additional conversions in case of failure
-    template <typename... Ts, typename Fun = none>
-    composite<std::optional<no_void_validator_tup_t<Ts...>>> try_next(
-        Fun&& fun = none{}) {
-        assert_throw_on_error_not_defined<throw_on_error>();
-        using Ret = no_void_validator_tup_t<Ts...>;
-        return try_invoke_and_make_composite<
-            std::optional<Ret>>(get_next<Ts...>(), std::forward<Fun>(fun));
+    writer(writer&& other) = default;
+
+    writer& operator=(writer&& other) {
+        if (this != &other) {
+            write_buffer();
+            file_name_ = std::move(other.file_name_);
+            error_ = std::move(other.error_);
+            buffer_size_ = other.buffer_size_;
+            block_ = std::move(other.block_);
+            file_ = std::move(other.file_);
+        }
+        return *this;
     }
 
-    // identical to try_next but returns composite with object instead of a
-    // tuple
-    template <typename T, typename... Ts, typename Fun = none>
-    composite<std::optional<T>> try_object(Fun&& fun = none{}) {
-        assert_throw_on_error_not_defined<throw_on_error>();
-        return try_invoke_and_make_composite<
-            std::optional<T>>(get_object<T, Ts...>(), std::forward<Fun>(fun));
+    writer(const writer& other) = delete;
+    writer& operator=(const writer& other) = delete;
+
+    // the remaining rows are written, errors are ignored
+    ~writer() {
+        write_buffer();
     }
 
-private:
-    // tries to invoke the given function (see below), if the function
-    // returns a value which can be used as a conditional, and it returns
-    // false, the function sets an error, and allows the invoke of the
-    // next possible conversion as if the validation of the current one
-    // failed
-    template <typename Arg, typename Fun = none>
-    void try_invoke(Arg&& arg, Fun&& fun) {
-        constexpr bool is_none = std::is_same_v<std::decay_t<Fun>, none>;
-        if constexpr (!is_none) {
-            using Ret = decltype(try_invoke_impl(arg, std::forward<Fun>(fun)));
-            constexpr bool returns_void = std::is_same_v<Ret, void>;
-            if constexpr (!returns_void) {
-                if (!try_invoke_impl(arg, std::forward<Fun>(fun))) {
-                    handle_error_failed_check();
-                }
-            } else {
-                try_invoke_impl(arg, std::forward<Fun>(fun));
-            }
+    bool valid() const {
+        if constexpr (string_error) {
+            return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
+        } else if constexpr (throw_on_error) {
+            return true;
+        } else {
+            return !error_;
         }
     }
 
-    // tries to invoke the function if not none
-    // it first tries to invoke the function without arguments,
-    // than with one argument if the function accepts the whole tuple
-    // as an argument, and finally tries to invoke it with the tuple
-    // laid out as a parameter pack
-    template <typename Arg, typename Fun = none>
-    auto try_invoke_impl(Arg&& arg, Fun&& fun) {
-        constexpr bool is_none = std::is_same_v<std::decay_t<Fun>, none>;
-        if constexpr (!is_none) {
-            if constexpr (std::is_invocable_v<Fun>) {
-                return fun();
-            } else if constexpr (std::is_invocable_v<Fun, Arg>) {
-                return std::invoke(std::forward<Fun>(fun),
-                                   std::forward<Arg>(arg));
-            } else {
-                return std::apply(std::forward<Fun>(fun),
-                                  std::forward<Arg>(arg));
-            }
+    const std::string& error_msg() const {
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = file_name_ + ": " + error_.message();
+            return error_msg_;
+        } else {
+            return error_;
         }
     }
 
-    template <typename T, typename Fun = none>
-    composite<T> try_invoke_and_make_composite(T&& value, Fun&& fun) {
-        if (valid()) {
-            try_invoke(*value, std::forward<Fun>(fun));
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
+        return error_;
+    }
+
+    // writes one row, the values can be given separately, as a tuple or as
+    // a non const object with a 'tied' method, if a field cannot be written
+    // the whole row is discarded
+    template <typename T, typename... Ts>
+    void write(T&& value, Ts&&... values) {
+        clear_error();
+        if (!file_) {
+            handle_error_file_not_open();
+            return;
+        }
+
+        if (!block_.write(std::forward<T>(value),
+                          std::forward<Ts>(values)...)) {
+            handle_error_invalid_output_field(block_.invalid_column());
+            return;
+        }
+
+        if (block_.size() >= buffer_size_ && !write_buffer()) {
+            handle_error_write_failed();
         }
-        return {valid() ? std::move(value) : std::nullopt, *this};
     }
 
-    ////////////////
-    // header
-    ////////////////
+    // writes the buffered rows into the file
+    void flush() {
+        if (!write_buffer()) {
+            handle_error_write_failed();
+            return;
+        }
 
-    void split_header_data() {
-        ss::splitter<Options...> splitter;
-        std::string raw_header_copy = raw_header_;
-        splitter.split(raw_header_copy.data(), reader_.delim_);
-        for (const auto& [begin, end] : splitter.split_data_) {
-            std::string field{begin, end};
-            if (std::find(header_.begin(), header_.end(), field) !=
-                header_.end()) {
-                handle_error_invalid_header(field);
-                header_.clear();
-                return;
-            }
-            header_.push_back(std::move(field));
+        if (file_) {
+            fflush(file_.get());
         }
     }
 
-    std::optional<size_t> header_index(const std::string& field) {
-        auto it = std::find(header_.begin(), header_.end(), field);
+private:
+    struct file_closer {
+        void operator()(FILE* file) const {
+            fclose(file);
+        }
+    };
 
-        if (it == header_.end()) {
-            return std::nullopt;
+    bool write_buffer() {
+        if (!file_ || block_.empty()) {
+            return true;
         }
 
-        return std::distance(header_.begin(), it);
+        size_t size = block_.size();
+        size_t written = fwrite(block_.data(), 1, size, file_.get());
+        block_.clear();
+        return written == size;
     }
 
     ////////////////
     // error
     ////////////////
-
     void clear_error() {
         if constexpr (string_error) {
             error_.clear();
+        } else if constexpr (structured_error) {
+            error_.code = error_code::none;
         } else {
             error_ = false;
         }
     }
 
-    void handle_error_failed_check() {
-        constexpr static auto error_msg = " failed check";
-
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(file_name_).append(error_msg);
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{file_name_ + error_msg};
-        } else {
-            error_ = true;
-        }
-    }
-
     void handle_error_file_not_open() {
         constexpr static auto error_msg = " could not be opened";
 
         if constexpr (string_error) {
             error_.clear();
             error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::file_not_open);
         } else if constexpr (throw_on_error) {
             throw ss::exception{file_name_ + error_msg};
         } else {
@@ -2649,12 +7232,14 @@ private:
         }
     }
 
-    void handle_error_eof_reached() {
-        constexpr static auto error_msg = " read on end of file";
+    void handle_error_write_failed() {
+        constexpr static auto error_msg = " write failed";
 
         if constexpr (string_error) {
             error_.clear();
             error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::write_failed);
         } else if constexpr (throw_on_error) {
             throw ss::exception{file_name_ + error_msg};
         } else {
@@ -2662,368 +7247,425 @@ private:
         }
     }
 
-    void handle_error_invalid_conversion() {
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(file_name_)
-                .append(" ")
-                .append(std::to_string(reader_.line_number_))
-                .append(": ")
-                .append(reader_.converter_.error_msg());
-        } else if constexpr (!throw_on_error) {
-            error_ = true;
-        }
-    }
-
-    void handle_error_header_ignored() {
+    void handle_error_invalid_output_field(size_t column) {
         constexpr static auto error_msg =
-            ": the header row is ignored within the setup it cannot be used";
+            "field cannot be written without quoting or escaping at column ";
 
         if constexpr (string_error) {
             error_.clear();
-            error_.append(file_name_).append(error_msg);
+            error_.append(error_msg).append(std::to_string(column + 1));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::invalid_output_field);
+            error_.column = column;
         } else if constexpr (throw_on_error) {
-            throw ss::exception{file_name_ + error_msg};
+            throw ss::exception{error_msg + std::to_string(column + 1)};
         } else {
             error_ = true;
         }
     }
 
-    void handle_error_invalid_field(const std::string& field) {
-        constexpr static auto error_msg =
-            ": header does not contain given field: ";
+    ////////////////
+    // members
+    ////////////////
 
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(file_name_).append(error_msg).append(field);
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{file_name_ + error_msg + field};
-        } else {
-            error_ = true;
-        }
-    }
+    std::string file_name_;
+    error_type error_{};
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
 
-    void handle_error_field_used_multiple_times(const std::string& field) {
-        constexpr static auto error_msg = ": given field used multiple times: ";
+    size_t buffer_size_;
+    row_block<Options...> block_;
+    std::unique_ptr<FILE, file_closer> file_;
+};
 
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(file_name_).append(error_msg).append(field);
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{file_name_ + error_msg + field};
-        } else {
-            error_ = true;
+} /* ss */
+
+#if __unix__
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace ss {
+
+////////////////
+// parallel writer
+////////////////
+
+// writes row blocks formatted on multiple threads into a file, each block
+// is given a sequence number, starting from 0, and the blocks are written
+// in the order of their sequence numbers by a separate thread, consecutive
+// blocks are written using a single call where supported, producers wait
+// while the submitted blocks which are not yet written exceed the limit
+template <typename... Options>
+class parallel_writer {
+    constexpr static auto string_error = setup<Options...>::string_error;
+    constexpr static auto throw_on_error = setup<Options...>::throw_on_error;
+    constexpr static auto structured_error =
+        setup<Options...>::structured_error;
+
+    using error_type = std::conditional_t<
+        string_error, std::string,
+        std::conditional_t<structured_error, ss::error_info, bool>>;
+
+    // number of blocks written with one call
+    constexpr static size_t max_batch_size = 64;
+
+public:
+    using block = row_block<Options...>;
+
+    constexpr static size_t default_max_buffered = 64 * 1024 * 1024;
+
+    parallel_writer(const std::string& file_name,
+                    const std::string& delim = ss::default_delimiter,
+                    size_t max_buffered = default_max_buffered)
+        : file_name_{file_name}, delim_{delim}, max_buffered_{max_buffered} {
+        if (!open()) {
+            handle_error_file_not_open();
+            return;
         }
+
+        thread_ = std::thread{[this] { run(); }};
     }
 
-    void handle_error_empty_mapping() {
-        constexpr static auto error_msg = "received empty mapping";
+    parallel_writer(parallel_writer&& other) = delete;
+    parallel_writer& operator=(parallel_writer&& other) = delete;
+    parallel_writer(const parallel_writer& other) = delete;
+    parallel_writer& operator=(const parallel_writer& other) = delete;
+
+    // the remaining blocks are written, errors are ignored
+    ~parallel_writer() {
+        stop();
+    }
 
+    bool valid() const {
         if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg);
+            return error_.empty();
+        } else if constexpr (structured_error) {
+            return error_.valid();
         } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg};
+            return true;
         } else {
-            error_ = true;
+            return !error_;
         }
     }
 
-    void handle_error_invalid_header(const std::string& field) {
-        constexpr static auto error_msg = "header contains duplicates: ";
-
-        if constexpr (string_error) {
-            error_.clear();
-            error_.append(error_msg).append(error_msg);
-        } else if constexpr (throw_on_error) {
-            throw ss::exception{error_msg + field};
+    const std::string& error_msg() const {
+        assert_string_error_defined<string_error || structured_error>();
+        if constexpr (structured_error) {
+            error_msg_ = file_name_ + ": " + error_.message();
+            return error_msg_;
         } else {
-            error_ = true;
+            return error_;
         }
     }
 
-    void decorate_rethrow(const ss::exception& e) const {
-        static_assert(throw_on_error,
-                      "throw_on_error needs to be enabled to use this method");
-        throw ss::exception{std::string{file_name_}
-                                .append(" ")
-                                .append(std::to_string(line()))
-                                .append(": ")
-                                .append(e.what())};
+    const ss::error_info& error_info() const {
+        assert_structured_error_defined<structured_error>();
+        return error_;
     }
 
-    ////////////////
-    // line reading
-    ////////////////
+    // returns an empty block, the memory of the written blocks is reused,
+    // can be called from any thread
+    block make_block() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (free_blocks_.empty()) {
+            return block{delim_};
+        }
 
-    void read_line() {
-        eof_ = !reader_.read_next();
+        block b = std::move(free_blocks_.back());
+        free_blocks_.pop_back();
+        return b;
     }
 
-    struct reader {
-        reader(const std::string& file_name_, const std::string& delim)
-            : delim_{delim}, file_{fopen(file_name_.c_str(), "rb")} {
+    // passes the block with the given sequence number to the writing
+    // thread, each number is to be used once, can be called from any
+    // thread, waits while the buffered blocks exceed the limit unless the
+    // block is the next one to be written, returns false if the sequence
+    // number was already used, or if writing failed, the error is reported
+    // by 'finish'
+    bool submit(size_t sequence, block&& b) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        space_.wait(lock, [&] {
+            return failed_ || stop_ || buffered_ == 0 || sequence == next_ ||
+                   buffered_ + b.size() <= max_buffered_;
+        });
+
+        if (failed_ || stop_ || !file_open()) {
+            return false;
         }
 
-        reader(reader&& other)
-            : buffer_{other.buffer_},
-              next_line_buffer_{other.next_line_buffer_},
-              helper_buffer_{other.helper_buffer_}, converter_{std::move(
-                                                        other.converter_)},
-              next_line_converter_{std::move(other.next_line_converter_)},
-              buffer_size_{other.buffer_size_},
-              next_line_buffer_size_{other.next_line_buffer_size_},
-              helper_size_{other.helper_size_}, delim_{std::move(other.delim_)},
-              file_{other.file_}, crlf_{other.crlf_},
-              line_number_{other.line_number_}, next_line_size_{
-                                                    other.next_line_size_} {
-            other.buffer_ = nullptr;
-            other.next_line_buffer_ = nullptr;
-            other.helper_buffer_ = nullptr;
-            other.file_ = nullptr;
+        // a block with a sequence number which was already used is not
+        // buffered, it would never be written
+        size_t size = b.size();
+        if (sequence < next_ ||
+            !pending_.emplace(sequence, std::move(b)).second) {
+            return false;
         }
 
-        reader& operator=(reader&& other) {
-            if (this != &other) {
-                buffer_ = other.buffer_;
-                next_line_buffer_ = other.next_line_buffer_;
-                helper_buffer_ = other.helper_buffer_;
-                converter_ = std::move(other.converter_);
-                next_line_converter_ = std::move(other.next_line_converter_);
-                buffer_size_ = other.buffer_size_;
-                next_line_buffer_size_ = other.next_line_buffer_size_;
-                helper_size_ = other.helper_size_;
-                delim_ = std::move(other.delim_);
-                file_ = other.file_;
-                crlf_ = other.crlf_;
-                line_number_ = other.line_number_;
-                next_line_size_ = other.next_line_size_;
-
-                other.buffer_ = nullptr;
-                other.next_line_buffer_ = nullptr;
-                other.helper_buffer_ = nullptr;
-                other.file_ = nullptr;
-            }
-
-            return *this;
+        buffered_ += size;
+        if (sequence == next_) {
+            ready_.notify_one();
         }
+        return true;
+    }
 
-        ~reader() {
-            free(buffer_);
-            free(next_line_buffer_);
-            free(helper_buffer_);
+    // waits until the submitted blocks are written and closes the file,
+    // all of the sequence numbers up to the last one need to be submitted,
+    // the blocks after a missing one are not written
+    void finish() {
+        if (!thread_.joinable()) {
+            return;
+        }
 
-            if (file_) {
-                fclose(file_);
-            }
+        bool missing = stop();
+        if (failed_) {
+            handle_error_write_failed();
+        } else if (missing) {
+            handle_error_missing_block();
         }
+    }
 
-        reader() = delete;
-        reader(const reader& other) = delete;
-        reader& operator=(const reader& other) = delete;
+private:
+    ////////////////
+    // writing thread
+    ////////////////
 
-        // read next line each time in order to set eof_
-        bool read_next() {
-            next_line_converter_.clear_error();
-            ssize_t ssize = 0;
-            size_t size = 0;
-            while (size == 0) {
-                ++line_number_;
-                if (next_line_buffer_size_ > 0) {
-                    next_line_buffer_[0] = '\0';
-                }
-                ssize = get_line(&next_line_buffer_, &next_line_buffer_size_,
-                                 file_);
+    // returns true if blocks were left unwritten
+    bool stop() {
+        if (!thread_.joinable()) {
+            return false;
+        }
 
-                if (ssize == -1) {
-                    return false;
-                }
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stop_ = true;
+        }
+        ready_.notify_one();
+        space_.notify_all();
+        thread_.join();
+        close();
+
+        bool missing = !pending_.empty();
+        pending_.clear();
+        return missing;
+    }
 
-                size = remove_eol(next_line_buffer_, ssize);
+    bool next_ready() const {
+        return !pending_.empty() && pending_.begin()->first == next_;
+    }
 
-                if constexpr (!ignore_empty) {
-                    break;
-                }
+    void run() {
+        std::vector<block> batch;
+        std::unique_lock<std::mutex> lock{mutex_};
+        while (true) {
+            ready_.wait(lock, [this] { return stop_ || next_ready(); });
+            if (!next_ready()) {
+                break;
             }
 
-            next_line_size_ = size;
-            return true;
-        }
-
-        void parse() {
-            size_t limit = 0;
-
-            if constexpr (escaped_multiline_enabled) {
-                while (escaped_eol(next_line_size_)) {
-                    if (multiline_limit_reached(limit)) {
-                        return;
-                    }
+            while (batch.size() < max_batch_size && next_ready()) {
+                batch.push_back(std::move(pending_.begin()->second));
+                pending_.erase(pending_.begin());
+                ++next_;
+            }
 
-                    if (!append_next_line_to_buffer(next_line_buffer_,
-                                                    next_line_size_)) {
-                        next_line_converter_.handle_error_unterminated_escape();
-                        return;
-                    }
+            // once a write fails the following blocks are not written, so
+            // the file does not continue after the lost data
+            lock.unlock();
+            bool failed = failed_ || !write(batch);
+            SSP_PROBE2(write_batch, batch.size(), batch_size(batch));
+            lock.lock();
+
+            failed_ = failed;
+            for (auto& b : batch) {
+                buffered_ -= b.size();
+                if (free_blocks_.size() < max_batch_size) {
+                    b.clear();
+                    free_blocks_.push_back(std::move(b));
                 }
             }
+            batch.clear();
+            space_.notify_all();
+        }
+    }
 
-            next_line_converter_.split(next_line_buffer_, delim_);
-
-            if constexpr (quoted_multiline_enabled) {
-                while (unterminated_quote()) {
-                    next_line_size_ -= next_line_converter_.size_shifted();
-
-                    if (multiline_limit_reached(limit)) {
-                        return;
-                    }
+    static size_t batch_size(const std::vector<block>& blocks) {
+        size_t size = 0;
+        for (const auto& b : blocks) {
+            size += b.size();
+        }
+        return size;
+    }
 
-                    if (!append_next_line_to_buffer(next_line_buffer_,
-                                                    next_line_size_)) {
-                        next_line_converter_.handle_error_unterminated_quote();
-                        return;
-                    }
+    ////////////////
+    // output
+    ////////////////
 
-                    if constexpr (escaped_multiline_enabled) {
-                        while (escaped_eol(next_line_size_)) {
-                            if (multiline_limit_reached(limit)) {
-                                return;
-                            }
+#if __unix__
+    bool open() {
+        fd_ = ::open(file_name_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        return fd_ != -1;
+    }
 
-                            if (!append_next_line_to_buffer(next_line_buffer_,
-                                                            next_line_size_)) {
-                                next_line_converter_
-                                    .handle_error_unterminated_escape();
-                                return;
-                            }
-                        }
-                    }
+    bool file_open() const {
+        return fd_ != -1;
+    }
 
-                    next_line_converter_.resplit(next_line_buffer_,
-                                                 next_line_size_, delim_);
-                }
-            }
+    void close() {
+        if (fd_ != -1) {
+            ::close(fd_);
+            fd_ = -1;
         }
+    }
 
-        void update() {
-            std::swap(buffer_, next_line_buffer_);
-            std::swap(buffer_size_, next_line_buffer_size_);
-            std::swap(converter_, next_line_converter_);
+    // consecutive blocks are written using one call, partial writes are
+    // continued from where they stopped
+    bool write(const std::vector<block>& blocks) {
+        std::vector<iovec> iov;
+        iov.reserve(blocks.size());
+        for (const auto& b : blocks) {
+            if (!b.empty()) {
+                iov.push_back(iovec{const_cast<char*>(b.data()), b.size()});
+            }
         }
 
-        bool multiline_limit_reached(size_t& limit) {
-            if constexpr (multiline::size > 0) {
-                if (limit++ >= multiline::size) {
-                    next_line_converter_.handle_error_multiline_limit_reached();
-                    return true;
+        size_t first = 0;
+        while (first < iov.size()) {
+            ssize_t written = ::writev(fd_, iov.data() + first,
+                                       static_cast<int>(iov.size() - first));
+            if (written < 0) {
+                // interrupted by a signal before anything was written
+                if (errno == EINTR) {
+                    continue;
                 }
+                return false;
             }
-            return false;
-        }
 
-        bool escaped_eol(size_t size) {
-            const char* curr;
-            for (curr = next_line_buffer_ + size - 1;
-                 curr >= next_line_buffer_ &&
-                 setup<Options...>::escape::match(*curr);
-                 --curr) {
+            size_t remaining = static_cast<size_t>(written);
+            while (first < iov.size() && remaining >= iov[first].iov_len) {
+                remaining -= iov[first++].iov_len;
             }
-            return (next_line_buffer_ - curr + size) % 2 == 0;
-        }
-
-        bool unterminated_quote() {
-            return next_line_converter_.unterminated_quote();
-        }
 
-        void undo_remove_eol(char* buffer, size_t& string_end) {
-            if (crlf_) {
-                std::copy_n("\r\n\0", 3, buffer + string_end);
-                string_end += 2;
-            } else {
-                std::copy_n("\n\0", 2, buffer + string_end);
-                string_end += 1;
+            if (remaining > 0) {
+                iov[first].iov_base =
+                    static_cast<char*>(iov[first].iov_base) + remaining;
+                iov[first].iov_len -= remaining;
             }
         }
-
-        size_t remove_eol(char*& buffer, size_t ssize) {
-            size_t size = ssize - 1;
-            if (ssize >= 2 && buffer[ssize - 2] == '\r') {
-                crlf_ = true;
-                size--;
-            } else {
-                crlf_ = false;
-            }
-
-            buffer[size] = '\0';
-            return size;
+        return true;
+    }
+#else
+    bool open() {
+        file_ = fopen(file_name_.c_str(), "wb");
+        if (file_) {
+            setvbuf(file_, nullptr, _IONBF, 0);
         }
+        return file_ != nullptr;
+    }
 
-        void realloc_concat(char*& first, size_t& first_size,
-                            const char* const second, size_t second_size) {
-            // TODO make buffer_size an argument
-            next_line_buffer_size_ = first_size + second_size + 3;
-            auto new_first = static_cast<char*>(
-                realloc(static_cast<void*>(first), next_line_buffer_size_));
-            if (!first) {
-                throw std::bad_alloc{};
-            }
+    bool file_open() const {
+        return file_ != nullptr;
+    }
 
-            first = new_first;
-            std::copy_n(second, second_size + 1, first + first_size);
-            first_size += second_size;
+    void close() {
+        if (file_) {
+            fclose(file_);
+            file_ = nullptr;
         }
+    }
 
-        bool append_next_line_to_buffer(char*& buffer, size_t& size) {
-            undo_remove_eol(buffer, size);
-
-            ssize_t next_ssize =
-                get_line(&helper_buffer_, &helper_size_, file_);
-            if (next_ssize == -1) {
+    bool write(const std::vector<block>& blocks) {
+        for (const auto& b : blocks) {
+            if (fwrite(b.data(), 1, b.size(), file_) != b.size()) {
                 return false;
             }
-
-            ++line_number_;
-            size_t next_size = remove_eol(helper_buffer_, next_ssize);
-            realloc_concat(buffer, size, helper_buffer_, next_size);
-            return true;
         }
+        return true;
+    }
+#endif
 
-        std::string get_buffer() {
-            return std::string{next_line_buffer_, next_line_buffer_size_};
-        }
+    ////////////////
+    // error
+    ////////////////
 
-        ////////////////
-        // members
-        ////////////////
-        char* buffer_{nullptr};
-        char* next_line_buffer_{nullptr};
-        char* helper_buffer_{nullptr};
+    void handle_error_file_not_open() {
+        constexpr static auto error_msg = " could not be opened";
 
-        converter<Options...> converter_;
-        converter<Options...> next_line_converter_;
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::file_not_open);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
 
-        size_t buffer_size_{0};
-        size_t next_line_buffer_size_{0};
-        size_t helper_size_{0};
+    void handle_error_write_failed() {
+        constexpr static auto error_msg = " write failed";
 
-        std::string delim_;
-        FILE* file_{nullptr};
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg);
+        } else if constexpr (structured_error) {
+            error_.set(error_code::write_failed);
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg};
+        } else {
+            error_ = true;
+        }
+    }
 
-        bool crlf_{false};
-        size_t line_number_{0};
+    void handle_error_missing_block() {
+        constexpr static auto error_msg = " missing block with sequence: ";
 
-        size_t next_line_size_{0};
-    };
+        if constexpr (string_error) {
+            error_.clear();
+            error_.append(file_name_).append(error_msg).append(
+                std::to_string(next_));
+        } else if constexpr (structured_error) {
+            error_.set(error_code::missing_block);
+            error_.expected = next_;
+        } else if constexpr (throw_on_error) {
+            throw ss::exception{file_name_ + error_msg +
+                                std::to_string(next_)};
+        } else {
+            error_ = true;
+        }
+    }
 
     ////////////////
     // members
     ////////////////
 
     std::string file_name_;
+    std::string delim_;
+    size_t max_buffered_;
+
     error_type error_{};
-    reader reader_;
-    std::vector<std::string> header_;
-    std::string raw_header_;
-    bool eof_{false};
+    mutable std::conditional_t<structured_error, std::string, none> error_msg_;
+
+#if __unix__
+    int fd_{-1};
+#else
+    FILE* file_{nullptr};
+#endif
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable space_;
+
+    // blocks waiting for the ones before them, by sequence number
+    std::map<size_t, block> pending_;
+    std::vector<block> free_blocks_;
+    size_t next_{0};
+    size_t buffered_{0};
+    bool failed_{false};
+    bool stop_{false};
+
+    std::thread thread_;
 };
 
 } /* ss */
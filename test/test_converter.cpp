@@ -785,11 +785,423 @@ TEST_CASE("converter test error mode") {
     CHECK_FALSE(c.error_msg().empty());
 }
 
+TEST_CASE("converter test structured error mode") {
+    ss::converter<ss::structured_error, ss::quote<'"'>> c;
+    c.convert<int, int>(buff("1,junk"));
+    REQUIRE_FALSE(c.valid());
+    CHECK_EQ(c.error_info().code, ss::error_code::invalid_conversion);
+    CHECK_EQ(c.error_info().column, 1);
+    CHECK_EQ(c.error_info().offset, 2);
+    CHECK_NE(c.error_msg().find("junk"), std::string::npos);
+
+    c.convert<int, ss::gt<int, 5>>(buff("1,2"));
+    REQUIRE_FALSE(c.valid());
+    CHECK_EQ(c.error_info().code, ss::error_code::validation_failed);
+    CHECK_EQ(c.error_info().column, 1);
+    CHECK_NE(c.error_info().detail, nullptr);
+
+    c.convert<int, int>(buff("1,2,3"));
+    REQUIRE_FALSE(c.valid());
+    CHECK_EQ(c.error_info().code, ss::error_code::number_of_columns);
+    CHECK_EQ(c.error_info().expected, 2);
+    CHECK_EQ(c.error_info().got, 3);
+    CHECK_FALSE(c.error_msg().empty());
+
+    c.convert<int, std::string>(buff("1,\"x\"y"));
+    REQUIRE_FALSE(c.valid());
+    CHECK_EQ(c.error_info().code, ss::error_code::mismatched_quote);
+
+    c.convert<int, int>(buff("1,2"));
+    CHECK(c.valid());
+    CHECK_EQ(c.error_info().code, ss::error_code::none);
+}
+
 TEST_CASE("converter test throw on error mode") {
     ss::converter<ss::throw_on_error> c;
     REQUIRE_EXCEPTION(c.convert<int>("junk"));
 }
 
+namespace {
+constexpr char null_empty[] = "";
+constexpr char null_na[] = "NA";
+constexpr char null_null[] = "NULL";
+} /* namespace */
+
+template <typename... Ts>
+void test_null_values() {
+    using null_values = ss::null_values<null_empty, null_na, null_null>;
+    ss::converter<null_values, Ts...> c;
+
+    for (const auto& s : {",NA,NULL", "NA,,NA", "NULL,NULL,"}) {
+        c.template convert<std::optional<int>, int, std::optional<double>>(
+            s);
+        CHECK_FALSE(c.valid());
+    }
+
+    for (const auto& s : {",NA,NULL", "NA,,NA", "NULL,NULL,"}) {
+        auto [a, b] = c.template convert<std::optional<int>, void,
+                                         std::optional<double>>(s);
+        REQUIRE(c.valid());
+        CHECK_FALSE(a.has_value());
+        CHECK_FALSE(b.has_value());
+    }
+
+    {
+        auto [a, b] =
+            c.template convert<std::optional<int>, std::optional<double>>(
+                "5,NAN");
+        REQUIRE(c.valid());
+        REQUIRE(a.has_value());
+        CHECK_EQ(*a, 5);
+        CHECK(b.has_value());
+    }
+
+    {
+        auto [a, b] =
+            c.template convert<std::optional<int>, std::optional<double>>(
+                "junk,5.5");
+        REQUIRE(c.valid());
+        CHECK_FALSE(a.has_value());
+        REQUIRE(b.has_value());
+        CHECK_EQ(*b, 5.5);
+    }
+}
+
+template <typename... Ts>
+void test_null_values_strict() {
+    using null_values = ss::null_values_strict<null_empty, null_na>;
+    ss::converter<null_values, Ts...> c;
+
+    {
+        auto [a, b] =
+            c.template convert<std::optional<int>, std::optional<double>>(
+                "NA,");
+        REQUIRE(c.valid());
+        CHECK_FALSE(a.has_value());
+        CHECK_FALSE(b.has_value());
+    }
+
+    {
+        auto [a, b] =
+            c.template convert<std::optional<int>, std::optional<double>>(
+                "5,5.5");
+        REQUIRE(c.valid());
+        REQUIRE(a.has_value());
+        CHECK_EQ(*a, 5);
+        REQUIRE(b.has_value());
+        CHECK_EQ(*b, 5.5);
+    }
+
+    if constexpr (ss::setup<Ts...>::throw_on_error) {
+        REQUIRE_EXCEPTION(c.template convert<std::optional<int>>("NULL"));
+        REQUIRE_EXCEPTION(c.template convert<std::optional<int>>("junk"));
+    } else {
+        c.template convert<std::optional<int>>("NULL");
+        CHECK_FALSE(c.valid());
+        c.template convert<std::optional<int>>("junk");
+        CHECK_FALSE(c.valid());
+        if constexpr (ss::setup<Ts...>::string_error) {
+            CHECK_FALSE(c.error_msg().empty());
+        }
+    }
+}
+
+TEST_CASE("converter test null values") {
+    test_null_values();
+    test_null_values<ss::string_error>();
+    test_null_values_strict();
+    test_null_values_strict<ss::string_error>();
+    test_null_values_strict<ss::throw_on_error>();
+}
+
+namespace {
+enum class shape { circle, square, rectangle, triangle };
+
+constexpr char circle_code[] = "circle";
+constexpr char square_code[] = "square";
+constexpr char rectangle_code[] = "rectangle";
+constexpr char triangle_code[] = "triangle";
+constexpr char square_short_code[] = "sq";
+
+using shape_map = ss::enum_map<shape, ss::enum_code<circle_code, shape::circle>,
+                               ss::enum_code<square_code, shape::square>,
+                               ss::enum_code<rectangle_code, shape::rectangle>,
+                               ss::enum_code<triangle_code, shape::triangle>,
+                               ss::enum_code<square_short_code, shape::square>>;
+} /* namespace */
+
+template <typename... Ts>
+void test_enum_map() {
+    ss::converter<Ts...> c;
+
+    for (const auto& [s, expected] :
+         {std::pair<std::string, shape>{"circle,10", shape::circle},
+          {"square,10", shape::square},
+          {"sq,10", shape::square},
+          {"rectangle,10", shape::rectangle},
+          {"triangle,10", shape::triangle}}) {
+        auto [value, x] = c.template convert<shape_map, int>(s.c_str());
+        REQUIRE(c.valid());
+        CHECK_EQ(value, expected);
+        CHECK_EQ(x, 10);
+    }
+
+    {
+        auto value =
+            c.template convert<ss::nx<shape_map, shape::circle, shape::square>>(
+                "sq");
+        REQUIRE(c.valid());
+        CHECK_EQ(value, shape::square);
+    }
+
+    {
+        auto value = c.template convert<ss::ax<shape_map, shape::circle>>(
+            "triangle");
+        REQUIRE(c.valid());
+        CHECK_EQ(value, shape::triangle);
+    }
+
+    for (const auto& s : {"", "circl", "circlee", "Circle", "s", "junk"}) {
+        if constexpr (ss::setup<Ts...>::throw_on_error) {
+            REQUIRE_EXCEPTION(c.template convert<shape_map>(s));
+        } else {
+            c.template convert<shape_map>(s);
+            CHECK_FALSE(c.valid());
+        }
+    }
+
+    if constexpr (ss::setup<Ts...>::throw_on_error) {
+        REQUIRE_EXCEPTION(c.template convert<ss::nx<shape_map, shape::circle>>(
+            "square"));
+        REQUIRE_EXCEPTION(
+            c.template convert<ss::ax<shape_map, shape::circle>>("circle"));
+    } else {
+        c.template convert<ss::nx<shape_map, shape::circle>>("square");
+        CHECK_FALSE(c.valid());
+        c.template convert<ss::ax<shape_map, shape::circle>>("circle");
+        CHECK_FALSE(c.valid());
+        if constexpr (ss::setup<Ts...>::string_error) {
+            CHECK_FALSE(c.error_msg().empty());
+        }
+    }
+}
+
+TEST_CASE("converter test enum map") {
+    test_enum_map();
+    test_enum_map<ss::string_error>();
+    test_enum_map<ss::throw_on_error>();
+}
+
+template <typename... Ts>
+void test_selected_columns() {
+    ss::converter<Ts...> c;
+
+    {
+        auto [x, s] =
+            c.template convert<ss::col<3, int>, ss::col<1, std::string>>(
+                buff("junk,str,junk,5,junk"));
+        REQUIRE(c.valid());
+        CHECK_EQ(x, 5);
+        CHECK_EQ(s, "str");
+    }
+
+    {
+        auto x = c.template convert<ss::col<2, ss::gt<int, 3>>>(
+            buff("junk,junk,4"));
+        REQUIRE(c.valid());
+        CHECK_EQ(x, 4);
+    }
+
+    {
+        // the line is split only up to the last selected column
+        auto [x, y] = c.template convert<ss::col<0, int>, ss::col<1, double>>(
+            buff("1,2.5,\"junk"));
+        REQUIRE(c.valid());
+        CHECK_EQ(x, 1);
+        CHECK_EQ(y, 2.5);
+    }
+
+    if constexpr (ss::setup<Ts...>::throw_on_error) {
+        REQUIRE_EXCEPTION(c.template convert<ss::col<3, int>>(buff("1,2,3")));
+        REQUIRE_EXCEPTION(c.template convert<ss::col<1, int>>(buff("1,x,3")));
+    } else {
+        c.template convert<ss::col<3, int>>(buff("1,2,3"));
+        CHECK_FALSE(c.valid());
+        c.template convert<ss::col<1, int>>(buff("1,x,3"));
+        CHECK_FALSE(c.valid());
+        if constexpr (ss::setup<Ts...>::string_error) {
+            CHECK_NE(c.error_msg().find("column 2"), std::string::npos);
+        }
+    }
+}
+
+namespace {
+struct tied_in_place {
+    int i;
+    std::string s;
+    double d;
+
+    auto tied() {
+        return std::tie(i, s, d);
+    }
+};
+
+struct aggregate {
+    std::string s;
+    int i;
+    std::optional<double> d;
+};
+
+struct pair_aggregate {
+    std::string s;
+    int i;
+};
+} /* namespace */
+
+// aggregates with more members than values use the tuple in between
+static_assert(ss::direct_construction_v<aggregate, std::string, int,
+                                        std::optional<double>>);
+static_assert(!ss::direct_construction_v<aggregate, std::string, int>);
+
+template <typename... Ts>
+void test_direct_construction() {
+    ss::converter<Ts...> c;
+
+    {
+        auto value = c.template convert<tied_in_place>(buff("1,str,2.5"));
+        REQUIRE(c.valid());
+        CHECK_EQ(value.i, 1);
+        CHECK_EQ(value.s, "str");
+        CHECK_EQ(value.d, 2.5);
+    }
+
+    {
+        auto value =
+            c.template convert_object<aggregate, ss::ne<std::string>, int,
+                                      std::optional<double>>(buff("str,1,x"));
+        REQUIRE(c.valid());
+        CHECK_EQ(value.s, "str");
+        CHECK_EQ(value.i, 1);
+        CHECK_FALSE(value.d.has_value());
+    }
+
+    {
+        auto value =
+            c.template convert_object<pair_aggregate, ss::col<2, std::string>,
+                                      ss::col<0, int>>(buff("1,junk,str"));
+        REQUIRE(c.valid());
+        CHECK_EQ(value.s, "str");
+        CHECK_EQ(value.i, 1);
+    }
+
+    {
+        c.split(buff("str,2"));
+        auto value = c.template convert_object<pair_aggregate,
+                                               ss::ne<std::string>, int>();
+        REQUIRE(c.valid());
+        CHECK_EQ(value.s, "str");
+        CHECK_EQ(value.i, 2);
+    }
+
+    for (const auto& line : {"1,str", "x,str,2.5", "1,str,x"}) {
+        if constexpr (ss::setup<Ts...>::throw_on_error) {
+            REQUIRE_EXCEPTION(c.template convert<tied_in_place>(buff(line)));
+        } else {
+            c.template convert<tied_in_place>(buff(line));
+            CHECK_FALSE(c.valid());
+        }
+    }
+
+    for (const auto& line : {",1,2.5", "str,x,2.5", "str,1"}) {
+        if constexpr (ss::setup<Ts...>::throw_on_error) {
+            REQUIRE_EXCEPTION(
+                c.template convert_object<aggregate, ss::ne<std::string>, int,
+                                          std::optional<double>>(buff(line)));
+        } else {
+            c.template convert_object<aggregate, ss::ne<std::string>, int,
+                                      std::optional<double>>(buff(line));
+            CHECK_FALSE(c.valid());
+        }
+    }
+}
+
+TEST_CASE("converter test direct object construction") {
+    test_direct_construction();
+    test_direct_construction<ss::string_error>();
+    test_direct_construction<ss::throw_on_error>();
+    test_direct_construction<ss::structured_error>();
+}
+
+template <typename... Ts>
+void test_plan() {
+    ss::converter<Ts...> c;
+    ss::plan<int, ss::ne<std::string>> plan{{2, 0}, 3};
+
+    {
+        auto [x, s] = c.convert(plan, c.split(buff("str,junk,5")));
+        REQUIRE(c.valid());
+        CHECK_EQ(x, 5);
+        CHECK_EQ(s, "str");
+    }
+
+    {
+        ss::plan<double> single{{1}, 2};
+        auto x = c.convert(single, c.split(buff("junk,2.5")));
+        REQUIRE(c.valid());
+        CHECK_EQ(x, 2.5);
+    }
+
+    for (const auto& line : {"str,junk", "str,junk,x", ",junk,5"}) {
+        if constexpr (ss::setup<Ts...>::throw_on_error) {
+            REQUIRE_EXCEPTION(c.convert(plan, c.split(buff(line))));
+        } else {
+            c.convert(plan, c.split(buff(line)));
+            CHECK_FALSE(c.valid());
+        }
+    }
+
+    if constexpr (ss::setup<Ts...>::throw_on_error) {
+        REQUIRE_EXCEPTION(c.convert(ss::plan<int>{}, c.split(buff("1"))));
+    } else {
+        c.convert(ss::plan<int>{}, c.split(buff("1")));
+        CHECK_FALSE(c.valid());
+    }
+}
+
+TEST_CASE("converter test plan") {
+    test_plan();
+    test_plan<ss::string_error>();
+    test_plan<ss::throw_on_error>();
+    test_plan<ss::structured_error>();
+}
+
+TEST_CASE("converter test selected columns") {
+    test_selected_columns<ss::quote<'"'>>();
+    test_selected_columns<ss::quote<'"'>, ss::string_error>();
+    test_selected_columns<ss::quote<'"'>, ss::throw_on_error>();
+    test_selected_columns<ss::trim<' '>, ss::structured_error>();
+}
+
+#ifdef SSP_HAS_PMR
+TEST_CASE("converter test memory resource") {
+    std::array<std::byte, 4096> memory;
+    std::pmr::monotonic_buffer_resource resource{
+        memory.data(), memory.size(), std::pmr::null_memory_resource()};
+
+    ss::converter<ss::use_pmr, ss::quote<'"'>> c{&resource};
+    std::string line = "1,\"a,b\",x";
+    const auto& split_data = c.split(line.data());
+    CHECK(split_data.get_allocator().resource() == &resource);
+    CHECK_EQ(split_data.size(), 3);
+
+    auto [i, s, ch] = c.convert<int, std::string, char>(split_data);
+    REQUIRE(c.valid());
+    CHECK_EQ(i, 1);
+    CHECK_EQ(s, "a,b");
+    CHECK_EQ(ch, 'x');
+}
+#endif
+
 TEST_CASE("converter test converter with quotes spacing and escaping") {
     {
         ss::converter c;
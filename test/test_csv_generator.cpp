@@ -0,0 +1,121 @@
+#include "../benchmark/csv_generator.hpp"
+#include "test_helpers.hpp"
+#include <ss/push_parser.hpp>
+
+namespace {
+ss_bench::csv_schema make_schema(const std::string& columns) {
+    ss_bench::csv_schema schema;
+    REQUIRE(ss_bench::parse_columns(columns, schema.columns));
+    return schema;
+}
+
+// every row is read and the invalid ones are exactly the rows with an
+// injected error
+template <typename... Ts>
+void test_generated(const ss_bench::csv_schema& schema, size_t rows) {
+    ss_bench::csv_generator generator{schema, 7};
+    std::string data;
+    size_t errors = generator.generate(0, rows, data);
+
+    std::vector<bool> invalid;
+    ss::push_parser<Ts...> p{std::string{schema.delimiter}};
+    p.template on_row<int, double, std::string>(
+        [&](int, double, const std::string&) {
+            invalid.push_back(!p.valid());
+        });
+
+    // fragments of varying size
+    for (size_t i = 0, size = 1; i < data.size(); i += size, size += 7) {
+        p.feed(data.data() + i, std::min(size, data.size() - i));
+    }
+    p.finish();
+
+    REQUIRE_EQ(invalid.size(), rows);
+    size_t invalid_rows = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        CHECK_EQ(invalid[i], generator.row_invalid(i));
+        invalid_rows += invalid[i];
+    }
+    CHECK_EQ(invalid_rows, errors);
+}
+} /* namespace */
+
+TEST_CASE("csv_generator test parse columns") {
+    std::vector<ss_bench::column> columns;
+    REQUIRE(ss_bench::parse_columns("int,double,text:3-12,text:5,text",
+                                    columns));
+    REQUIRE_EQ(columns.size(), 5);
+    CHECK(columns[0].type == ss_bench::column_type::integer);
+    CHECK(columns[1].type == ss_bench::column_type::decimal);
+    CHECK(columns[2].type == ss_bench::column_type::text);
+    CHECK_EQ(columns[2].min_length, 3);
+    CHECK_EQ(columns[2].max_length, 12);
+    CHECK_EQ(columns[3].min_length, 5);
+    CHECK_EQ(columns[3].max_length, 5);
+
+    for (const auto& invalid : {"", "int,", "float", "int:3", "text:0",
+                                "text:5-3", "text:x", "int,,text"}) {
+        CHECK_FALSE(ss_bench::parse_columns(invalid, columns));
+    }
+}
+
+TEST_CASE("csv_generator test deterministic") {
+    auto schema = make_schema("int,double,text:1-30");
+    schema.quote_ratio = 0.3;
+    schema.newline_ratio = 0.1;
+    schema.crlf_ratio = 0.5;
+    schema.error_ratio = 0.1;
+
+    ss_bench::csv_generator generator{schema, 11};
+    auto data = generator.generate(1000);
+    CHECK_EQ(data, ss_bench::csv_generator{schema, 11}.generate(1000));
+    auto other = ss_bench::csv_generator{schema, 12}.generate(1000);
+    CHECK_NE(data, other);
+
+    // the result does not depend on the ranges generated
+    std::string chunks;
+    size_t errors = 0;
+    for (size_t i = 0; i < 1000; i += 64) {
+        errors += generator.generate(i, std::min<size_t>(64, 1000 - i),
+                                     chunks);
+    }
+    CHECK_EQ(chunks, data);
+
+    size_t expected_errors = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+        expected_errors += generator.row_invalid(i);
+    }
+    CHECK_EQ(errors, expected_errors);
+    CHECK(errors > 50);
+    CHECK(errors < 150);
+
+    CHECK_NE(data.find("\r\n"), std::string::npos);
+    CHECK_NE(data.find("\"\""), std::string::npos);
+}
+
+TEST_CASE("csv_generator test parse generated") {
+    constexpr size_t rows = 2000;
+
+    auto schema = make_schema("int,double,text:1-20");
+    schema.crlf_ratio = 0.5;
+    schema.error_ratio = 0.05;
+    test_generated(schema, rows);
+    test_generated<ss::string_error>(schema, rows);
+
+    auto quoted = schema;
+    quoted.quote_ratio = 0.5;
+    quoted.newline_ratio = 0.1;
+    test_generated<ss::quote<'"'>, ss::multiline>(quoted, rows);
+    test_generated<ss::quote<'"'>, ss::multiline, ss::structured_error>(
+        quoted, rows);
+
+    auto escaped = schema;
+    escaped.escape_ratio = 0.5;
+    escaped.delimiter = ';';
+    test_generated<ss::escape<'\\'>>(escaped, rows);
+
+    auto spaced = quoted;
+    spaced.space_ratio = 0.5;
+    test_generated<ss::quote<'"'>, ss::multiline, ss::trim<' '>>(spaced,
+                                                                 rows);
+}
@@ -275,3 +275,75 @@ TEST_CASE("extract test functions for std::variant") {
         }
     }
 }
+
+TEST_CASE("extract test lexical classification") {
+    using lc = ss::lexical_class;
+    auto classify = [](const std::string& s) {
+        return ss::lexical_classify(s.c_str(), s.c_str() + s.size());
+    };
+
+    CHECK_EQ(classify("22"), lc::integer | lc::floating_point);
+    CHECK_EQ(classify("-22"), lc::integer | lc::floating_point);
+    CHECK_EQ(classify("1"), lc::integer | lc::floating_point | lc::boolean |
+                                lc::character);
+    CHECK_EQ(classify("x"), lc::character);
+    CHECK_EQ(classify("true"), lc::boolean);
+    CHECK_EQ(classify("false"), lc::boolean);
+    CHECK_EQ(classify("junk"), lc::none);
+    CHECK_EQ(classify("22.2"), lc::floating_point);
+    CHECK_EQ(classify("+22"), lc::floating_point);
+    CHECK_EQ(classify("-.5"), lc::floating_point);
+    CHECK_EQ(classify("inf"), lc::floating_point);
+    CHECK_EQ(classify("-"), lc::character);
+
+    CHECK_EQ(ss::lexical_mask<int>(), lc::integer);
+    CHECK_EQ(ss::lexical_mask<double>(), lc::floating_point);
+    CHECK_EQ(ss::lexical_mask<bool>(), lc::boolean);
+    CHECK_EQ(ss::lexical_mask<char>(), lc::character);
+    CHECK_EQ(ss::lexical_mask<std::string>(), lc::any);
+}
+
+TEST_CASE("extract test functions for std::variant with skipped "
+          "alternatives") {
+    using var_type = std::variant<int, double, bool, char, std::string>;
+    auto extract = [](const std::string& s) {
+        var_type var;
+        REQUIRE(ss::extract(s.c_str(), s.c_str() + s.size(), var));
+        return var;
+    };
+
+    {
+        auto var = extract("22");
+        REQUIRE_VARIANT(var, 22, int);
+    }
+    {
+        auto var = extract("22.5");
+        REQUIRE_VARIANT(var, 22.5, double);
+    }
+    {
+        auto var = extract("true");
+        REQUIRE_VARIANT(var, true, bool);
+    }
+    {
+        auto var = extract("1");
+        REQUIRE_VARIANT(var, 1, int);
+    }
+    {
+        auto var = extract("x");
+        REQUIRE_VARIANT(var, 'x', char);
+    }
+    {
+        auto var = extract("junk");
+        REQUIRE_VARIANT(var, "junk", std::string);
+    }
+    {
+        auto var = extract("99999999999999999999");
+        REQUIRE_VARIANT(var, 99999999999999999999.0, double);
+    }
+    {
+        std::string s = "junk";
+        std::variant<bool, int> var;
+        REQUIRE_FALSE(ss::extract(s.c_str(), s.c_str() + s.size(), var));
+        REQUIRE_VARIANT(var, false, bool);
+    }
+}
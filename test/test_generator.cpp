@@ -0,0 +1,112 @@
+#include "test_helpers.hpp"
+#include <fstream>
+#include <ss/parser.hpp>
+
+#ifdef SSP_HAS_COROUTINES
+namespace {
+struct row {
+    int i;
+    std::string s;
+
+    auto tied() {
+        return std::tie(i, s);
+    }
+};
+
+void write_rows(const std::string& file_name) {
+    std::ofstream out{file_name};
+    out << "1,x" << std::endl;
+    out << "junk" << std::endl;
+    out << "3,z" << std::endl;
+}
+} /* namespace */
+
+template <typename... Ts>
+void test_rows() {
+    unique_file_name f{"test_generator"};
+    write_rows(f.name);
+
+    ss::parser<Ts...> p{f.name, ","};
+    std::vector<std::tuple<int, std::string>> values;
+    const std::tuple<int, std::string>* address = nullptr;
+    size_t invalid = 0;
+    for (auto& value : p.template rows<int, std::string>()) {
+        if (address != nullptr) {
+            // the same object is reused
+            CHECK_EQ(address, &value);
+        }
+        address = &value;
+
+        if (p.valid()) {
+            values.push_back(value);
+        } else {
+            ++invalid;
+        }
+    }
+
+    std::vector<std::tuple<int, std::string>> expected = {{1, "x"}, {3, "z"}};
+    CHECK_EQ(values, expected);
+    CHECK_EQ(invalid, 1);
+}
+
+TEST_CASE("generator test rows") {
+    test_rows();
+    test_rows<ss::string_error>();
+    test_rows<ss::structured_error>();
+}
+
+TEST_CASE("generator test object rows") {
+    unique_file_name f{"test_generator"};
+    write_rows(f.name);
+
+    ss::parser p{f.name, ","};
+    std::vector<int> values;
+    for (const auto& value : p.object_rows<row>()) {
+        if (p.valid()) {
+            values.push_back(value.i);
+        }
+    }
+    CHECK_EQ(values, std::vector<int>{1, 3});
+}
+
+TEST_CASE("generator test interleaved files") {
+    unique_file_name f1{"test_generator"};
+    unique_file_name f2{"test_generator"};
+    write_rows(f1.name);
+    {
+        std::ofstream out{f2.name};
+        out << "10" << std::endl;
+        out << "20" << std::endl;
+    }
+
+    ss::parser p1{f1.name, ","};
+    ss::parser p2{f2.name, ","};
+    auto g1 = p1.rows<void, std::string>();
+    auto g2 = p2.rows<int>();
+
+    std::vector<std::string> order;
+    bool more1 = true;
+    bool more2 = true;
+    while (more1 || more2) {
+        if (more1 && (more1 = g1.next()) && p1.valid()) {
+            order.push_back(g1.value());
+        }
+        if (more2 && (more2 = g2.next()) && p2.valid()) {
+            order.push_back(std::to_string(g2.value()));
+        }
+    }
+
+    CHECK_EQ(order, std::vector<std::string>{"x", "10", "20", "z"});
+}
+
+TEST_CASE("generator test exceptions") {
+    unique_file_name f{"test_generator"};
+    write_rows(f.name);
+
+    ss::parser<ss::throw_on_error> p{f.name, ","};
+    auto g = p.rows<int, std::string>();
+    REQUIRE(g.next());
+    CHECK_EQ(std::get<0>(g.value()), 1);
+    REQUIRE_EXCEPTION(g.next());
+}
+#endif
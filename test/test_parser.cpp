@@ -32,7 +32,8 @@ void expect_error_on_command(ss::parser<Ts...>& p,
     } else {
         command();
         CHECK(!p.valid());
-        if constexpr (ss::setup<Ts...>::string_error) {
+        if constexpr (ss::setup<Ts...>::string_error ||
+                      ss::setup<Ts...>::structured_error) {
             CHECK_FALSE(p.error_msg().empty());
         }
     }
@@ -370,6 +371,7 @@ TEST_CASE("parser test various cases") {
     test_various_cases();
     test_various_cases<ss::string_error>();
     test_various_cases<ss::throw_on_error>();
+    test_various_cases<ss::structured_error>();
 }
 
 using test_tuple = std::tuple<double, char, double>;
@@ -610,6 +612,7 @@ void test_composite_conversion() {
 // various scenarios
 TEST_CASE("parser test composite conversion") {
     test_composite_conversion<ss::string_error>();
+    test_composite_conversion<ss::structured_error>();
 }
 
 struct my_string {
@@ -668,6 +671,62 @@ void test_moving_of_parsed_composite_values() {
             [](auto&, auto&, auto&) {});
 }
 
+namespace {
+struct counted_int {
+    using value_type = int;
+    static inline size_t extractions = 0;
+
+    static bool ss_extract(const char* begin, const char* end, int& value) {
+        ++extractions;
+        return ss::extract(begin, end, value);
+    }
+};
+} /* namespace */
+
+template <typename... Ts>
+void test_composite_memoization() {
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        out << "1,2,x" << std::endl;
+        out << "y,2,3" << std::endl;
+        out << "4,5,6" << std::endl;
+    }
+
+    ss::parser<Ts...> p{f.name, ","};
+    counted_int::extractions = 0;
+
+    // the first two columns are extracted only once for both alternatives
+    auto [a, b] = p.template try_next<counted_int, counted_int, int>()
+                      .template or_else<counted_int, counted_int,
+                                        std::string>()
+                      .values();
+    CHECK_FALSE(a.has_value());
+    REQUIRE(b.has_value());
+    CHECK_EQ(*b, std::make_tuple(1, 2, "x"));
+    CHECK_EQ(counted_int::extractions, 2);
+
+    // the failed extraction is reused too
+    p.template try_next<counted_int, int, int>()
+        .template or_else<counted_int, int, std::string>()
+        .on_error([] {});
+    CHECK_FALSE(p.valid());
+    CHECK_EQ(counted_int::extractions, 3);
+
+    // results of a previous line are not reused
+    auto [c] = p.template try_next<counted_int, counted_int, counted_int>()
+                   .values();
+    REQUIRE(c.has_value());
+    CHECK_EQ(*c, std::make_tuple(4, 5, 6));
+    CHECK_EQ(counted_int::extractions, 6);
+}
+
+TEST_CASE("parser test composite memoization") {
+    test_composite_memoization();
+    test_composite_memoization<ss::string_error>();
+    test_composite_memoization<ss::structured_error>();
+}
+
 TEST_CASE("parser test the moving of parsed composite values") {
     test_moving_of_parsed_composite_values();
     test_moving_of_parsed_composite_values<ss::string_error>();
@@ -708,6 +767,300 @@ TEST_CASE("parser throw on error mode") {
     }
 }
 
+TEST_CASE("parser structured error mode") {
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        out << "1,2" << std::endl;
+        out << "3,x" << std::endl;
+        out << "5" << std::endl;
+        out << "y,8" << std::endl;
+        out << "9,10" << std::endl;
+    }
+
+    ss::parser<ss::structured_error> p(f.name, ",");
+
+    p.get_next<int, int>();
+    CHECK(p.valid());
+
+    p.get_next<int, int>();
+    REQUIRE_FALSE(p.valid());
+    CHECK_EQ(p.error_info().code, ss::error_code::invalid_conversion);
+    CHECK_EQ(p.error_info().line, 2);
+    CHECK_EQ(p.error_info().column, 1);
+    CHECK_EQ(p.error_info().offset, 6);
+    CHECK_EQ(std::string(p.error_info().raw.first, p.error_info().raw.second),
+             "x");
+    CHECK_NE(p.error_msg().find("x"), std::string::npos);
+
+    p.get_next<int, int>();
+    REQUIRE_FALSE(p.valid());
+    CHECK_EQ(p.error_info().code, ss::error_code::number_of_columns);
+    CHECK_EQ(p.error_info().expected, 2);
+    CHECK_EQ(p.error_info().got, 1);
+
+    p.get_next<int, int>();
+    CHECK_FALSE(p.valid());
+    CHECK_EQ(p.error_info().offset, 10);
+
+    p.get_next<int, int>();
+    CHECK(p.valid());
+    CHECK(p.eof());
+
+    p.get_next<int, int>();
+    CHECK_EQ(p.error_info().code, ss::error_code::eof_reached);
+    CHECK_EQ(p.error_count(), 4);
+}
+
+TEST_CASE("parser structured error log") {
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        for (size_t i = 0; i < 10; ++i) {
+            out << "junk" << i << std::endl;
+        }
+    }
+
+    {
+        ss::parser<ss::structured_error_log<3>> p(f.name, ",");
+        for (const auto& i : p.iterate<int>()) {
+            (void)(i);
+        }
+
+        CHECK_EQ(p.error_count(), 10);
+        REQUIRE_EQ(p.recorded_errors().size(), 3);
+        for (size_t i = 0; i < 3; ++i) {
+            const auto& error = p.recorded_errors()[i];
+            CHECK_EQ(error.code, ss::error_code::invalid_conversion);
+            CHECK_EQ(error.line, i + 1);
+            CHECK_EQ(error.offset, i * 6);
+            CHECK_EQ(error.raw.first, nullptr);
+        }
+    }
+
+    {
+        ss::parser<ss::structured_error_log<0, 4>> p(f.name, ",");
+        for (const auto& i : p.iterate<int>()) {
+            (void)(i);
+        }
+
+        CHECK_EQ(p.error_count(), 10);
+        REQUIRE_EQ(p.recorded_errors().size(), 3);
+        CHECK_EQ(p.recorded_errors()[0].line, 1);
+        CHECK_EQ(p.recorded_errors()[1].line, 5);
+        CHECK_EQ(p.recorded_errors()[2].line, 9);
+    }
+}
+
+template <typename... Ts>
+void test_reject_sink() {
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        out << "1,\"x\"" << std::endl;
+        out << "junk,\"y\"" << std::endl;
+        out << "2,\"multi" << std::endl;
+        out << "line\"" << std::endl;
+        out << "3,\"bad\"x" << std::endl;
+        out << "4" << std::endl;
+        out << "5,\"z\"" << std::endl;
+    }
+
+    std::vector<std::string> expected_raw = {"junk,\"y\"", "3,\"bad\"x",
+                                             "4"};
+    std::vector<size_t> expected_lines = {2, 5, 6};
+
+    std::vector<std::string> raw;
+    std::vector<size_t> lines;
+
+    ss::parser<ss::quote<'"'>, ss::multiline, Ts...> p{f.name, ","};
+    p.set_reject_sink([&](const ss::rejected_record& record) {
+        raw.emplace_back(record.raw);
+        lines.push_back(record.line);
+        if constexpr (ss::setup<Ts...>::structured_error) {
+            CHECK_NE(record.code, ss::error_code::none);
+        } else {
+            CHECK_EQ(record.code, ss::error_code::invalid_conversion);
+        }
+    });
+
+    std::vector<std::tuple<int, std::string>> values;
+    while (!p.eof()) {
+        try {
+            auto value = p.template get_next<int, std::string>();
+            if (p.valid()) {
+                values.emplace_back(std::move(value));
+            }
+        } catch (const ss::exception&) {
+            continue;
+        }
+    }
+
+    std::vector<std::tuple<int, std::string>> expected_values = {
+        {1, "x"}, {2, "multi\nline"}, {5, "z"}};
+    CHECK_EQ(values, expected_values);
+    CHECK_EQ(raw, expected_raw);
+    CHECK_EQ(lines, expected_lines);
+}
+
+TEST_CASE("parser test reject sink") {
+    test_reject_sink();
+    test_reject_sink<ss::string_error>();
+    test_reject_sink<ss::throw_on_error>();
+    test_reject_sink<ss::structured_error>();
+
+    unique_file_name f{"test_parser"};
+    unique_file_name rejected{"test_parser"};
+    unique_file_name log{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        out << "1,2" << std::endl;
+        out << "x,2" << std::endl;
+        out << "3,4" << std::endl;
+        out << "5,y,z" << std::endl;
+    }
+
+    {
+        ss::parser<ss::structured_error> p{f.name, ","};
+        ss::reject_file sink{rejected.name, log.name};
+        REQUIRE(sink.valid());
+        p.set_reject_sink(sink);
+
+        for (const auto& [a, b] : p.iterate<int, int>()) {
+            (void)(a);
+            (void)(b);
+        }
+
+        // composite conversions do not reject records
+        ss::parser<ss::structured_error> p2{f.name, ","};
+        p2.set_reject_sink(sink);
+        while (!p2.eof()) {
+            p2.try_next<int, int>().or_else<std::string, int>();
+        }
+    }
+
+    std::ifstream in{rejected.name};
+    std::stringstream rejected_content;
+    rejected_content << in.rdbuf();
+    CHECK_EQ(rejected_content.str(), "x,2\n5,y,z\n");
+
+    std::ifstream in_log{log.name};
+    std::stringstream log_content;
+    log_content << in_log.rdbuf();
+    CHECK_EQ(log_content.str(),
+             "2 invalid conversion\n4 invalid number of columns\n");
+
+    // the raw record is captured before the lines are joined, so it is set
+    // if the multiline limit is reached
+    {
+        std::ofstream out{f.name};
+        out << "1,a\n2,b\n3,c\\\n4\\\n5\\\n6\n7,d\n";
+    }
+
+    std::vector<std::string> raw;
+    std::vector<ss::error_code> codes;
+    ss::parser<ss::escape<'\\'>, ss::multiline_restricted<1>,
+               ss::structured_error>
+        p{f.name, ","};
+    p.set_reject_sink([&](const ss::rejected_record& record) {
+        raw.emplace_back(record.raw);
+        codes.push_back(record.code);
+    });
+    while (!p.eof()) {
+        p.get_next<int, std::string>();
+    }
+
+    std::vector<std::string> expected_raw = {"3,c\\\n4\\", "5\\\n6"};
+    std::vector<ss::error_code> expected_codes = {
+        ss::error_code::multiline_limit_reached,
+        ss::error_code::number_of_columns};
+    CHECK_EQ(raw, expected_raw);
+    CHECK_EQ(codes, expected_codes);
+}
+
+template <typename... Ts>
+void test_string_view_with_arena() {
+    unique_file_name f{"test_parser"};
+    std::vector<X> data = {{1, 2, "x"},         {3, 4, "\"y,y\""},
+                           {5, 6, "zzzzzzzzzz"}, {7, 8, ""},
+                           {9, 10, "\"v\"\"\""}, {11, 12, "w"}};
+    make_and_write(f.name, data);
+
+    std::vector<std::string> expected = {"x", "y,y", "zzzzzzzzzz",
+                                         "",  "v\"", "w"};
+
+    ss::arena arena{8};
+    ss::parser<ss::quote<'"'>, Ts...> p{f.name, ","};
+    p.use_arena(&arena);
+
+    ss::parser<ss::quote<'"'>, Ts...> p2{f.name, ","};
+    p2.use_arena(&arena);
+
+    std::vector<std::string_view> views;
+    std::vector<std::optional<std::string_view>> optional_views;
+    while (!p.eof() && !p2.eof()) {
+        auto [i, s] = p.template get_next<int, void, std::string_view>();
+        REQUIRE(p.valid());
+        views.push_back(s);
+
+        auto o = p2.template get_next<void, void,
+                                      std::optional<std::string_view>>();
+        REQUIRE(p2.valid());
+        optional_views.push_back(o);
+    }
+
+    REQUIRE_EQ(views.size(), expected.size());
+    REQUIRE_EQ(optional_views.size(), expected.size());
+    for (size_t i = 0; i < views.size(); ++i) {
+        CHECK_EQ(std::string{views[i]}, expected[i]);
+        REQUIRE(optional_views[i].has_value());
+        CHECK_EQ(std::string{*optional_views[i]}, expected[i]);
+    }
+
+    CHECK(arena.used() > 0);
+    arena.clear();
+    CHECK_EQ(arena.used(), 0);
+    CHECK(arena.capacity() > 0);
+
+    arena.release();
+    CHECK_EQ(arena.capacity(), 0);
+}
+
+TEST_CASE("parser test string_view with arena") {
+    test_string_view_with_arena();
+    test_string_view_with_arena<ss::string_error>();
+    test_string_view_with_arena<ss::throw_on_error>();
+}
+
+TEST_CASE("parser test arena move") {
+    ss::arena a{16};
+    auto first = a.store("abcd");
+
+    ss::arena b{std::move(a)};
+    CHECK_EQ(a.used(), 0);
+    CHECK_EQ(a.capacity(), 0);
+    auto moved = a.store("efgh");
+    auto kept = b.store("ijkl");
+    CHECK_EQ(first, "abcd");
+    CHECK_EQ(moved, "efgh");
+    CHECK_EQ(kept, "ijkl");
+    CHECK_EQ(a.used(), 4);
+    CHECK_EQ(b.used(), 8);
+
+    ss::arena c{16};
+    c.store("xxxx");
+    c = std::move(b);
+    CHECK_EQ(b.used(), 0);
+    CHECK_EQ(b.capacity(), 0);
+    auto moved_assigned = b.store("mnop");
+    auto kept_assigned = c.store("qrst");
+    CHECK_EQ(first, "abcd");
+    CHECK_EQ(kept, "ijkl");
+    CHECK_EQ(moved_assigned, "mnop");
+    CHECK_EQ(kept_assigned, "qrst");
+    CHECK_EQ(c.used(), 12);
+}
+
 static inline std::string no_quote(const std::string& s) {
     if (!s.empty() && s[0] == '"') {
         return {std::next(begin(s)), std::prev(end(s))};
@@ -875,6 +1228,7 @@ TEST_CASE("parser test csv on multiple lines with quotes and escapes") {
     test_quote_escape_multiline();
     test_quote_escape_multiline<ss::string_error>();
     test_quote_escape_multiline<ss::throw_on_error>();
+    test_quote_escape_multiline<ss::table_driven>();
 }
 
 template <typename... Ts>
@@ -944,8 +1298,217 @@ TEST_CASE("parser test multiline restricted") {
     test_multiline_restricted();
     test_multiline_restricted<ss::string_error>();
     test_multiline_restricted<ss::throw_on_error>();
+    test_multiline_restricted<ss::string_error, ss::table_driven>();
 }
 
+template <typename... Ts>
+void test_max_record_size() {
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        out << "1,abc\n2,abcdefghijkl\n3,\"x\ny\"\n4,\"abc\ndefgh\nij\"\n"
+               "5,x\n";
+    }
+
+    ss::parser<ss::max_record_size<12>, ss::quote<'"'>, ss::multiline,
+               Ts...>
+        p{f.name};
+    auto command = [&] { return p.template get_next<int, std::string>(); };
+
+    CHECK_EQ(command(), std::make_tuple(1, "abc"));
+    expect_error_on_command(p, command);
+    if constexpr (ss::setup<Ts...>::structured_error) {
+        CHECK_EQ(p.error_info().code, ss::error_code::record_too_large);
+        CHECK_EQ(p.error_info().expected, 12);
+        CHECK_NE(p.error_msg().find("limit: 12"), std::string::npos);
+    }
+    CHECK_EQ(command(), std::make_tuple(3, "x\ny"));
+
+    // the lines not appended to the record are read as separate records
+    expect_error_on_command(p, command);
+    expect_error_on_command(p, command);
+    CHECK_EQ(command(), std::make_tuple(5, "x"));
+    CHECK(p.eof());
+}
+
+TEST_CASE("parser test max record size") {
+    test_max_record_size();
+    test_max_record_size<ss::string_error>();
+    test_max_record_size<ss::structured_error>();
+    test_max_record_size<ss::throw_on_error>();
+}
+
+template <typename... Ts>
+void test_max_columns() {
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        out << "a,b,c\n1,\"x\ny\",2\n3,z,4,5\n6,\"w\",7\n";
+    }
+
+    ss::parser<ss::max_columns<3>, ss::quote<'"'>, ss::multiline, Ts...> p{
+        f.name};
+    p.use_fields("c", "b");
+    auto command = [&] { return p.template get_next<int, std::string>(); };
+
+    CHECK_EQ(command(), std::make_tuple(2, "x\ny"));
+    expect_error_on_command(p, command);
+    if constexpr (ss::setup<Ts...>::structured_error) {
+        CHECK_EQ(p.error_info().code, ss::error_code::too_many_columns);
+        CHECK_EQ(p.error_info().expected, 3);
+    }
+    CHECK_EQ(command(), std::make_tuple(7, "w"));
+    CHECK(p.eof());
+
+    unique_file_name f2{"test_parser"};
+    {
+        std::ofstream out{f2.name};
+        out << "a,b,c,d\n1,2,3,4\n";
+    }
+
+    ss::parser<ss::max_columns<3>, Ts...> p2{f2.name};
+    expect_error_on_command(p2, [&] { p2.use_fields("a"); });
+    if constexpr (ss::setup<Ts...>::structured_error) {
+        CHECK_EQ(p2.error_info().code, ss::error_code::too_many_columns);
+        CHECK_EQ(p2.error_info().expected, 3);
+    }
+}
+
+TEST_CASE("parser test max columns") {
+    test_max_columns();
+    test_max_columns<ss::string_error>();
+    test_max_columns<ss::structured_error>();
+    test_max_columns<ss::throw_on_error>();
+}
+
+template <typename... Ts>
+void test_shrink_buffers() {
+    unique_file_name f{"test_parser"};
+    const std::string long_value(200 * 1024, 'x');
+    {
+        std::ofstream out{f.name};
+        for (size_t i = 0; i < 100; ++i) {
+            out << i << ",a\n";
+        }
+        out << 100 << "," << long_value << "\n";
+        for (size_t i = 101; i < 200; ++i) {
+            out << i << ",a\n";
+        }
+    }
+
+    ss::parser<ss::shrink_buffers, ss::collect_stats, Ts...> p{f.name};
+    size_t i = 0;
+    for (const auto& [n, s] : p.template iterate<size_t, std::string>()) {
+        CHECK_EQ(n, i);
+        CHECK_EQ(s, (i == 100 ? long_value : "a"));
+        ++i;
+    }
+    CHECK_EQ(i, 200);
+
+    auto stats = p.stats();
+    CHECK_EQ(stats.buffer_shrinks, 1);
+    CHECK(stats.record_size_percentile >= 4);
+    CHECK(stats.record_size_percentile < 64);
+}
+
+TEST_CASE("parser test shrink buffers") {
+    test_shrink_buffers();
+    test_shrink_buffers<ss::quote<'"'>, ss::multiline>();
+}
+
+#ifdef SSP_HAS_PMR
+namespace {
+struct counting_resource : std::pmr::memory_resource {
+    size_t allocations{0};
+    size_t allocated{0};
+
+    void* do_allocate(size_t size, size_t alignment) override {
+        ++allocations;
+        allocated += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* p, size_t size, size_t alignment) override {
+        allocated -= size;
+        std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other)
+        const noexcept override {
+        return this == &other;
+    }
+};
+
+// the default resource is replaced with one which cannot allocate, so the
+// test fails if anything is allocated from it instead of the given one
+struct null_default_resource {
+    std::pmr::memory_resource* old_resource{
+        std::pmr::set_default_resource(std::pmr::null_memory_resource())};
+
+    ~null_default_resource() {
+        std::pmr::set_default_resource(old_resource);
+    }
+};
+} /* namespace */
+
+template <typename... Ts>
+void test_memory_resource() {
+    unique_file_name f{"test_parser"};
+    std::vector<std::pair<int, std::string>> expected;
+    {
+        std::ofstream out{f.name};
+        // the header is long enough to be allocated when copied
+        out << "string_column,integer_column\n";
+        for (int i = 0; i < 500; ++i) {
+            std::string s(i, 'x');
+            if (i % 7 == 0) {
+                s += "\n" + s;
+            }
+            out << "\"" << s << "\"," << i << "\n";
+            expected.emplace_back(i, s);
+        }
+    }
+
+    counting_resource resource;
+    {
+        null_default_resource null_default;
+        ss::parser<ss::use_pmr, ss::quote<'"'>, ss::multiline, Ts...>
+            p{f.name, ",", &resource};
+        p.use_fields("integer_column", "string_column");
+        p.set_reject_sink([](const ss::rejected_record&) {});
+
+        std::vector<std::pair<int, std::string>> values;
+        for (const auto& [i, s] :
+             p.template iterate<int, std::string>()) {
+            values.emplace_back(i, s);
+        }
+        CHECK_EQ(values, expected);
+        CHECK(resource.allocations > 0);
+        CHECK(resource.allocated > 0);
+    }
+    CHECK_EQ(resource.allocated, 0);
+}
+
+TEST_CASE("parser test memory resource") {
+    test_memory_resource();
+    test_memory_resource<ss::string_error>();
+    test_memory_resource<ss::throw_on_error>();
+
+    // the memory is only released together with the monotonic buffer
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        out << "1,a\n2,b\n";
+    }
+
+    std::pmr::monotonic_buffer_resource resource;
+    ss::parser<ss::use_pmr> p{f.name, ",", &resource};
+    auto [i, s] = p.get_next<int, std::string>();
+    CHECK_EQ(i, 1);
+    CHECK_EQ(s, "a");
+}
+#endif
+
 template <typename... Ts>
 void test_unterminated_line_impl(const std::vector<std::string>& lines,
                                  size_t bad_line) {
@@ -978,6 +1541,7 @@ void test_unterminated_line(const std::vector<std::string>& lines,
     test_unterminated_line_impl<Ts...>(lines, bad_line);
     test_unterminated_line_impl<Ts..., ss::string_error>(lines, bad_line);
     test_unterminated_line_impl<Ts..., ss::throw_on_error>(lines, bad_line);
+    test_unterminated_line_impl<Ts..., ss::structured_error>(lines, bad_line);
 }
 
 TEST_CASE("parser test csv on multiline with errors") {
@@ -1424,6 +1988,40 @@ void test_invalid_fields_impl(const std::vector<std::string>& lines,
         }
     }
 
+    // the header is invalid if it contains duplicates
+    bool unique_fields =
+        !fields.empty() &&
+        std::unordered_set<std::string>{fields.begin(), fields.end()}.size() ==
+            fields.size();
+
+    {
+        // Field used multiple times is reported before an unknown field
+        ss::parser<Ts...> p{f.name, ","};
+        auto command = [&] {
+            p.use_fields(fields.at(0), "Unknown", fields.at(0));
+        };
+        if (unique_fields) {
+            expect_error_on_command(p, command);
+            if constexpr (ss::setup<Ts...>::structured_error) {
+                CHECK_EQ(p.error_info().code,
+                         ss::error_code::field_used_multiple_times);
+            }
+        }
+    }
+
+    {
+        // Unknown field used multiple times
+        ss::parser<Ts...> p{f.name, ","};
+        auto command = [&] { p.use_fields("Unknown", "Unknown"); };
+        if (unique_fields) {
+            expect_error_on_command(p, command);
+            if constexpr (ss::setup<Ts...>::structured_error) {
+                CHECK_EQ(p.error_info().code,
+                         ss::error_code::field_used_multiple_times);
+            }
+        }
+    }
+
     {
         // Mapping out of range
         ss::parser<Ts...> p{f.name, ","};
@@ -1465,6 +2063,7 @@ void test_invalid_fields(const std::vector<std::string>& lines,
     test_invalid_fields_impl(lines, fields);
     test_invalid_fields_impl<ss::string_error>(lines, fields);
     test_invalid_fields_impl<ss::throw_on_error>(lines, fields);
+    test_invalid_fields_impl<ss::structured_error>(lines, fields);
 }
 
 TEST_CASE("parser test invalid header fields usage") {
@@ -1491,6 +2090,242 @@ TEST_CASE("parser test invalid header fields usage") {
     test_invalid_fields({"Int,String,Int", "1,hi,3"}, {"Int", "String", "Int"});
 }
 
+template <typename... Ts>
+void test_selected_columns() {
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        out << "1,a,2.5,\"x\"" << std::endl;
+        out << "2,b,3.5,\"y" << std::endl;
+        out << "z\"" << std::endl;
+        out << "3,c" << std::endl;
+        out << "4,d,4.5,w" << std::endl;
+    }
+
+    ss::parser<ss::quote<'"'>, Ts...> p{f.name, ","};
+    std::vector<std::tuple<double, int>> values;
+    while (!p.eof()) {
+        try {
+            auto value =
+                p.template get_next<ss::col<2, double>, ss::col<0, int>>();
+            if (p.valid()) {
+                values.push_back(value);
+            }
+        } catch (const ss::exception&) {
+            continue;
+        }
+    }
+
+    // without multiline the line is split only up to the last selected
+    // column, so the unterminated quote is not found and 'z"' is read as
+    // an invalid line
+    std::vector<std::tuple<double, int>> expected = {{2.5, 1},
+                                                     {3.5, 2},
+                                                     {4.5, 4}};
+    CHECK_EQ(values, expected);
+}
+
+TEST_CASE("parser test selected columns") {
+    test_selected_columns();
+    test_selected_columns<ss::string_error>();
+    test_selected_columns<ss::throw_on_error>();
+    test_selected_columns<ss::multiline>();
+    test_selected_columns<ss::multiline, ss::string_error>();
+    test_selected_columns<ss::multiline, ss::throw_on_error>();
+}
+
+template <typename... Ts>
+void test_plan() {
+    unique_file_name f{"test_parser"};
+    unique_file_name f2{"test_parser"};
+    std::vector<X> data = {{1, 2, "x"}, {3, 4, "y"}, {5, 6, "z"}};
+    make_and_write(f.name, data, {"Int", "Dbl", "Str"});
+    make_and_write(f2.name, data, {"Int", "Dbl", "Str"});
+
+    ss::parser<Ts...> p{f.name, ","};
+    auto plan = p.template make_plan<std::string, int>("Str", "Int");
+    REQUIRE(p.valid());
+    REQUIRE(plan.valid());
+
+    std::vector<std::tuple<std::string, int>> values;
+    while (!p.eof()) {
+        values.push_back(p.get_next(plan));
+        REQUIRE(p.valid());
+    }
+
+    std::vector<std::tuple<std::string, int>> expected = {{"x", 1},
+                                                          {"y", 3},
+                                                          {"z", 5}};
+    CHECK_EQ(values, expected);
+
+    // the plan can be used with other files with the same header
+    ss::parser<Ts...> p2{f2.name, ","};
+    p2.ignore_next();
+    std::vector<X> objects;
+    auto object_plan = ss::plan<int, double, std::string>{{0, 1, 2}, 3};
+    while (!p2.eof()) {
+        objects.push_back(p2.template get_object<X>(object_plan));
+        REQUIRE(p2.valid());
+    }
+    CHECK_EQ(objects, data);
+
+    ss::parser<Ts...> p3{f.name, ","};
+    auto command = [&] {
+        auto invalid_plan = p3.template make_plan<int>("Unknown");
+        CHECK_FALSE(invalid_plan.valid());
+    };
+    expect_error_on_command(p3, command);
+}
+
+TEST_CASE("parser test plan") {
+    test_plan();
+    test_plan<ss::string_error>();
+    test_plan<ss::throw_on_error>();
+    test_plan<ss::structured_error>();
+}
+
+namespace {
+struct tied_row {
+    int i;
+    std::string s;
+
+    auto tied() {
+        return std::tie(i, s);
+    }
+};
+
+struct plain_row {
+    int i;
+    std::string s;
+};
+} /* namespace */
+
+template <typename... Ts>
+void test_batch() {
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        for (size_t i = 0; i < 10; ++i) {
+            if (i % 4 == 3) {
+                out << "junk" << std::endl;
+            } else {
+                out << i << ",s" << i << std::endl;
+            }
+        }
+    }
+
+    auto check_valid = [](size_t line, bool valid) {
+        CHECK_EQ(valid, line % 4 != 3);
+    };
+
+    {
+        ss::parser<Ts...> p{f.name, ","};
+        std::vector<std::tuple<int, std::string>> rows;
+        std::vector<bool> valid;
+        size_t line = 0;
+        for (size_t size : {4, 4, 2, 0}) {
+            REQUIRE_EQ(p.template get_batch<int, std::string>(rows, valid, 4),
+                       size);
+            REQUIRE_EQ(rows.size(), size);
+            REQUIRE_EQ(valid.size(), size);
+            for (size_t i = 0; i < size; ++i, ++line) {
+                check_valid(line, valid[i]);
+                if (valid[i]) {
+                    CHECK_EQ(rows[i],
+                             std::make_tuple(line, "s" + std::to_string(line)));
+                }
+            }
+        }
+        CHECK(p.eof());
+    }
+
+    {
+        ss::parser<Ts...> p{f.name, ","};
+        std::vector<tied_row> rows;
+        std::vector<bool> valid;
+        REQUIRE_EQ(p.template get_object_batch<tied_row>(rows, valid, 100),
+                   10);
+        for (size_t i = 0; i < rows.size(); ++i) {
+            check_valid(i, valid[i]);
+            if (valid[i]) {
+                CHECK_EQ(rows[i].i, i);
+                CHECK_EQ(rows[i].s, "s" + std::to_string(i));
+            }
+        }
+    }
+
+    {
+        ss::parser<Ts...> p{f.name, ","};
+        std::vector<plain_row> rows;
+        std::vector<bool> valid;
+        REQUIRE_EQ(p.template get_object_batch<plain_row, int, std::string>(
+                       rows, valid, 100),
+                   10);
+        for (size_t i = 0; i < rows.size(); ++i) {
+            check_valid(i, valid[i]);
+            if (valid[i]) {
+                CHECK_EQ(rows[i].i, i);
+                CHECK_EQ(rows[i].s, "s" + std::to_string(i));
+            }
+        }
+    }
+}
+
+TEST_CASE("parser test batch") {
+    test_batch();
+    test_batch<ss::string_error>();
+    test_batch<ss::structured_error>();
+}
+
+TEST_CASE("parser test wide header") {
+    constexpr size_t columns = 5000;
+    unique_file_name f{"test_parser"};
+    {
+        std::ofstream out{f.name};
+        for (size_t i = 0; i < columns; ++i) {
+            out << (i == 0 ? "" : ",") << "c" << i;
+        }
+        out << std::endl;
+        for (size_t i = 0; i < columns; ++i) {
+            out << (i == 0 ? "" : ",") << i;
+        }
+        out << std::endl;
+    }
+
+    {
+        ss::parser<ss::string_error> p{f.name, ","};
+        CHECK(p.field_exists("c0"));
+        CHECK(p.field_exists("c4999"));
+        CHECK_FALSE(p.field_exists("c5000"));
+        CHECK_FALSE(p.field_exists(""));
+
+        p.use_fields("c4321", "c7", "c1234");
+        REQUIRE(p.valid());
+        auto [a, b, c] = p.get_next<int, int, int>();
+        REQUIRE(p.valid());
+        CHECK_EQ(a, 4321);
+        CHECK_EQ(b, 7);
+        CHECK_EQ(c, 1234);
+    }
+
+    {
+        ss::parser<ss::string_error> p{f.name, ","};
+        p.use_fields("c1", "c2", "c1");
+        CHECK_FALSE(p.valid());
+        CHECK_NE(p.error_msg().find("c1"), std::string::npos);
+    }
+
+    {
+        std::ofstream out{f.name};
+        out << "a,b,c,b" << std::endl;
+    }
+
+    ss::parser<ss::string_error> p{f.name, ","};
+    p.use_fields("a");
+    CHECK_FALSE(p.valid());
+    CHECK_EQ(p.error_msg(), "header contains duplicates: b");
+}
+
 template <typename... Ts>
 void test_ignore_empty_impl(const std::vector<X>& data) {
     unique_file_name f{"test_parser"};
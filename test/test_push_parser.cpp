@@ -0,0 +1,171 @@
+#include "test_helpers.hpp"
+#include <fstream>
+#include <optional>
+#include <ss/parser.hpp>
+#include <ss/push_parser.hpp>
+
+namespace {
+using row = std::optional<std::tuple<std::string, int>>;
+
+// reference result, the same input read from a file
+template <typename... Ts>
+std::vector<row> parse_file(const std::string& data) {
+    unique_file_name f{"test_push_parser"};
+    {
+        std::ofstream out{f.name, std::ios::binary};
+        out << data;
+    }
+
+    std::vector<row> rows;
+    ss::parser<Ts...> p{f.name, ","};
+    while (!p.eof()) {
+        auto value = p.template get_next<std::string, int>();
+        rows.push_back(p.valid() ? row{value} : std::nullopt);
+    }
+    return rows;
+}
+
+template <typename... Ts>
+std::vector<row> push(const std::string& data, size_t fragment_size) {
+    std::vector<row> rows;
+    ss::push_parser<Ts...> p{","};
+    p.template on_row<std::string, int>(
+        [&](const std::string& s, int i) {
+            rows.push_back(p.valid() ? row{{s, i}} : std::nullopt);
+        });
+
+    for (size_t i = 0; i < data.size(); i += fragment_size) {
+        p.feed(data.data() + i, std::min(fragment_size, data.size() - i));
+    }
+    p.finish();
+    return rows;
+}
+
+// every fragment size gives the same result as the parser
+template <typename... Ts>
+void test_fragments(const std::string& data) {
+    auto expected = parse_file<Ts...>(data);
+    for (size_t i = 1; i <= data.size(); ++i) {
+        CHECK_EQ(push<Ts...>(data, i), expected);
+    }
+}
+} /* namespace */
+
+TEST_CASE("push_parser test fragments") {
+    const std::string data = "a,1\nb,2\r\nc,x\n\nd,4\n  e , 5 \nf,6\n";
+
+    test_fragments(data);
+    test_fragments<ss::ignore_empty>(data);
+    test_fragments<ss::ignore_header>(data);
+    test_fragments<ss::trim<' '>, ss::string_error>(data);
+}
+
+TEST_CASE("push_parser test quoted multiline") {
+    const std::string data = "\"a\nb\",1\n\"c\"\"d\",2\r\n\"e\r\n\nf\",3\n"
+                             "\"g\"x,4\n\"h,5\ni,6\n";
+
+    test_fragments<ss::quote<'"'>>(data);
+    test_fragments<ss::quote<'"'>, ss::multiline>(data);
+    test_fragments<ss::quote<'"'>, ss::multiline_restricted<1>>(data);
+    test_fragments<ss::quote<'"'>, ss::multiline, ss::string_error>(data);
+}
+
+TEST_CASE("push_parser test escaped multiline") {
+    const std::string data = "a\\\nb,1\nc\\,d,2\ne\\\\,3\nf\\\n\\\ng,4\nh\\\n";
+
+    test_fragments<ss::escape<'\\'>>(data);
+    test_fragments<ss::escape<'\\'>, ss::multiline>(data);
+    test_fragments<ss::escape<'\\'>, ss::multiline_restricted<1>>(data);
+    test_fragments<ss::escape<'\\'>, ss::multiline,
+                   ss::structured_error>(data);
+}
+
+TEST_CASE("push_parser test quoted and escaped multiline") {
+    const std::string data = "\"a\\\"\nb\",1\n\"c\\\n\\\nd\\\\\",2\nx\\\n"
+                             "\"y\",3\n\"e\\\n";
+
+    using quote = ss::quote<'"'>;
+    using escape = ss::escape<'\\'>;
+    test_fragments<quote, escape, ss::multiline>(data);
+    test_fragments<quote, escape, ss::multiline_restricted<2>>(data);
+    test_fragments<quote, escape, ss::multiline, ss::string_error>(data);
+
+    const std::string restricted = "1,\"ju\n\r\n\nnk\"\n2,ju\\\n\\\n\\\nnk\n"
+                                   "3,\"ju\\\n|\n\n\n\nk\"\n4,just strings\n";
+    test_fragments<quote, escape, ss::multiline_restricted<2>>(restricted);
+}
+
+TEST_CASE("push_parser test objects and lines") {
+    struct x {
+        int i;
+        std::string s;
+
+        auto tied() {
+            return std::tie(i, s);
+        }
+    };
+
+    std::vector<std::pair<size_t, int>> values;
+    ss::push_parser<ss::quote<'"'>, ss::multiline> p;
+    p.on_row<x>([&](const x& value) {
+        values.emplace_back(p.line(), value.i);
+    });
+
+    p.feed("1,\"a\n");
+    CHECK(values.empty());
+    p.feed("b\"\n2,c\n3,d");
+    CHECK_EQ(values.size(), 2);
+    p.finish();
+
+    std::vector<std::pair<size_t, int>> expected = {{2, 1}, {3, 2}, {4, 3}};
+    CHECK_EQ(values, expected);
+
+    // reused for the next input
+    values.clear();
+    p.feed("4,d\n");
+    CHECK_EQ(values, std::vector<std::pair<size_t, int>>{{1, 4}});
+}
+
+TEST_CASE("push_parser test errors") {
+    {
+        ss::push_parser<ss::quote<'"'>, ss::multiline, ss::string_error> p;
+        std::vector<std::string> errors;
+        p.on_row<int>([&](int) {
+            if (!p.valid()) {
+                errors.push_back(p.error_msg());
+            }
+        });
+
+        p.feed("1\nx\n\"2");
+        p.finish();
+        REQUIRE_EQ(errors.size(), 2);
+        CHECK_NE(errors[0].find("invalid conversion"), std::string::npos);
+        CHECK_NE(errors[1].find("unterminated quote"), std::string::npos);
+    }
+
+    {
+        ss::push_parser<ss::structured_error> p;
+        std::vector<ss::error_code> errors;
+        p.on_row<int, int>([&](int, int) {
+            errors.push_back(p.error_info().code);
+        });
+
+        p.feed("1,2\n3\n");
+        std::vector<ss::error_code> expected = {
+            ss::error_code::none, ss::error_code::number_of_columns};
+        CHECK_EQ(errors, expected);
+    }
+
+    {
+        ss::push_parser<ss::throw_on_error> p;
+        std::vector<int> values;
+        p.on_row<int>([&](int i) { values.push_back(i); });
+
+        REQUIRE_EXCEPTION(p.feed("1\nx\n2\n"));
+        CHECK_EQ(values, std::vector<int>{1});
+
+        // the rest of the fragment is discarded
+        p.feed("3\n");
+        CHECK_EQ(values, std::vector<int>{1, 3});
+    }
+}
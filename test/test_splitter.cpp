@@ -17,7 +17,8 @@ struct set_num_combinations {
     }
 };
 
-std::vector<std::string> words(const ss::split_data& input) {
+template <typename SplitData>
+std::vector<std::string> words(const SplitData& input) {
     std::vector<std::string> ret;
     for (const auto& [begin, end] : input) {
         ret.emplace_back(begin, end);
@@ -158,6 +159,8 @@ static inline void test_combinations(matches_type& matches,
 
     ss::splitter<Matchers...> s;
     ss::splitter<Matchers..., ss::throw_on_error> st;
+    ss::splitter<Matchers..., ss::max_columns<num_combinations_default>> si;
+    ss::splitter<Matchers..., ss::table_driven> sd;
 
     std::vector<std::string> inputs;
     std::vector<std::string> outputs;
@@ -184,6 +187,14 @@ static inline void test_combinations(matches_type& matches,
             } catch (ss::exception& e) {
                 FAIL(std::string{e.what()});
             }
+
+            const auto& inline_vec = si.split(buff(lines[i].c_str()), delim);
+            CHECK(si.valid());
+            CHECK_EQ(words(inline_vec), expectations[i]);
+
+            auto table_vec = sd.split(buff(lines[i].c_str()), delim);
+            CHECK(sd.valid());
+            CHECK_EQ(words(table_vec), expectations[i]);
         }
     }
 }
@@ -405,11 +416,13 @@ TEST_CASE("splitter test with escape and trim") {
     case_type case4 = spaced({R"(\,)"}, " ");
     case_type case6 = spaced({R"(#,x)"}, " ");
     case_type case7 = spaced({R"(x\,x)"}, " ");
+    case_type case5 = spaced({R"(x \,x)"}, " ");
 
     {
         matches_type p{{case1, "x"},
                        {case3, "\\"},
                        {case4, ","},
+                       {case5, "x ,x"},
                        {case6, ",x"},
                        {case7, "x,x"}};
         test_combinations<ss::escape<'\\', '#'>, ss::trim<' '>>(p, {","});
@@ -520,6 +533,51 @@ TEST_CASE("splitter test error mode") {
     }
 }
 
+TEST_CASE("splitter test max columns") {
+    using expected_type = std::vector<std::string>;
+
+    {
+        ss::splitter<ss::max_columns<3>> s;
+        CHECK_EQ(words(s.split(buff("a,b,c"))), expected_type{"a", "b", "c"});
+        CHECK(s.valid());
+        CHECK_EQ(words(s.split(buff("a"))), expected_type{"a"});
+        CHECK(s.valid());
+        CHECK_EQ(words(s.split(buff("a,b,"))), expected_type{"a", "b", ""});
+        CHECK(s.valid());
+
+        s.split(buff("a,b,c,d"));
+        CHECK_FALSE(s.valid());
+        s.split(buff("a,b,c,"));
+        CHECK_FALSE(s.valid());
+    }
+
+    {
+        ss::splitter<ss::max_columns<2>, ss::quote<'"'>, ss::string_error> s;
+        s.split(buff("\"a,b\",c"));
+        CHECK(s.valid());
+        s.split(buff("\"a\",b,\"c\""));
+        CHECK_FALSE(s.valid());
+        CHECK_EQ(s.error_msg(), "too many columns, limit: 2");
+    }
+
+    {
+        ss::splitter<ss::max_columns<1>, ss::structured_error> s;
+        s.split(buff("a,b"));
+        CHECK_FALSE(s.valid());
+        CHECK_EQ(s.error_info().code, ss::error_code::too_many_columns);
+        CHECK_EQ(s.error_info().column, 1);
+        CHECK_EQ(s.error_info().expected, 1);
+    }
+
+    try {
+        ss::splitter<ss::max_columns<2>, ss::throw_on_error> s;
+        s.split(buff("a,b,c"));
+        FAIL("expected exception");
+    } catch (ss::exception& e) {
+        CHECK_EQ(std::string{e.what()}, "too many columns, limit: 2");
+    }
+}
+
 template <typename Splitter>
 static inline auto expect_unterminated_quote(Splitter& s,
                                              const std::string& line) {
@@ -1214,3 +1272,143 @@ TEST_CASE("splitter test with quote and escape, trim_left and trim_right") {
                           ss::trim_right<'-'>>(p, delims);
     }
 }
+
+// the ranges relative to the beginning of the line, the fields and the
+// error of a split, the fields are not compared if the quote is
+// unterminated since the last element then points to the whole line
+template <typename Splitter, typename SplitData>
+static inline std::string describe_split(const Splitter& s,
+                                         const SplitData& vec,
+                                         const char* line) {
+    std::string ret;
+    for (const auto& [begin, end] : vec) {
+        ret.append("[")
+            .append(std::to_string(begin - line))
+            .append(",")
+            .append(std::to_string(end - line))
+            .append("]");
+    }
+
+    if (s.valid() && !s.unterminated_quote()) {
+        for (const auto& word : words(vec)) {
+            ret.append(" ").append(word);
+        }
+    }
+
+    const auto& error = s.error_info();
+    ret.append(" code: ")
+        .append(std::to_string(static_cast<int>(error.code)))
+        .append(" column: ")
+        .append(std::to_string(error.column))
+        .append(" offset: ")
+        .append(std::to_string(error.offset))
+        .append(s.unterminated_quote() ? " unterminated" : "");
+    return ret;
+}
+
+template <typename... Ts>
+static inline std::string split_joined(const std::string& first,
+                                       const std::string& second) {
+    ss::converter<ss::structured_error, Ts...> c;
+    auto& s = c.splitter;
+
+    std::string line = first;
+    auto vec = s.split(line.data());
+    if (!second.empty() && s.valid() && s.unterminated_quote()) {
+        // the lines are joined the same way the parser joins them
+        line.resize(line.size() - c.size_shifted());
+        line += second;
+        vec = c.resplit(line.data(), line.size());
+    }
+    return describe_split(s, vec, line.data());
+}
+
+// every line made of the characters of the alphabet, up to the given size,
+// is split using both engines, and resplit with every continuation up to
+// the given size if multiline is enabled
+template <typename... Ts>
+static inline void test_table_driven(size_t max_size,
+                                     size_t max_continuation_size = 0) {
+    const std::string alphabet = "a,\"\\ _";
+
+    auto for_each_line = [&](size_t max, auto&& f) {
+        std::vector<size_t> digits;
+        for (size_t size = 0; size <= max; ++size) {
+            digits.assign(size, 0);
+            while (true) {
+                std::string line;
+                for (const auto& digit : digits) {
+                    line += alphabet[digit];
+                }
+                f(line);
+
+                size_t i = 0;
+                while (i < size && ++digits[i] == alphabet.size()) {
+                    digits[i++] = 0;
+                }
+                if (i == size) {
+                    break;
+                }
+            }
+        }
+    };
+
+    for_each_line(max_size, [&](const std::string& first) {
+        for_each_line(max_continuation_size, [&](const std::string& second) {
+            auto expected = split_joined<Ts...>(first, second);
+            auto result = split_joined<Ts..., ss::table_driven>(first, second);
+            if (expected != result) {
+                // the lines are a part of the message if the check fails
+                auto lines = first + " + " + second + ": ";
+                CHECK_EQ(lines + result, lines + expected);
+            }
+        });
+    });
+}
+
+TEST_CASE("splitter test table driven") {
+    using quote = ss::quote<'"'>;
+    using escape = ss::escape<'\\'>;
+    using trim = ss::trim<' '>;
+
+    test_table_driven<>(6);
+    test_table_driven<quote>(6);
+    test_table_driven<escape>(6);
+    test_table_driven<trim>(6);
+    test_table_driven<ss::trim_left<' ', '_'>>(6);
+    test_table_driven<ss::trim_right<' '>>(6);
+    test_table_driven<quote, escape>(6);
+    test_table_driven<quote, trim>(6);
+    test_table_driven<escape, trim>(6);
+    test_table_driven<quote, escape, trim>(6);
+    test_table_driven<quote, escape, ss::trim_left<' ', '_'>>(6);
+    test_table_driven<quote, escape, ss::trim_right<' ', '_'>>(6);
+    test_table_driven<quote, escape, ss::trim_left<'_'>,
+                      ss::trim_right<' '>>(6);
+    test_table_driven<quote, escape, trim, ss::max_columns<2>>(6);
+
+    test_table_driven<quote, ss::multiline>(4, 3);
+    test_table_driven<quote, escape, ss::multiline>(4, 3);
+    test_table_driven<quote, escape, trim, ss::multiline>(4, 3);
+}
+
+TEST_CASE("splitter test table driven delimiters") {
+    using expected_type = std::vector<std::string>;
+
+    ss::splitter<ss::quote<'"'>, ss::trim<' '>, ss::table_driven> s;
+    CHECK_EQ(words(s.split(buff(R"( a ; "b;c" ;)"), ";")),
+             expected_type{"a", "b;c", ""});
+
+    // delimiters which are not single characters, or which are matched by
+    // the setup, are split the same way by the default engine
+    CHECK_EQ(words(s.split(buff(R"( a :: "b::c" ::)"), "::")),
+             expected_type{"a", "b::c", ""});
+    CHECK_EQ(words(s.split(buff(R"(a "b c")"), " ")),
+             words(ss::splitter<ss::quote<'"'>, ss::trim<' '>>{}.split(
+                 buff(R"(a "b c")"), " ")));
+
+    ss::splitter<ss::string_error, ss::table_driven> se;
+    se.split(buff("a,b"), "");
+    CHECK_FALSE(se.valid());
+    CHECK_EQ(se.error_msg(), "empty delimiter");
+}
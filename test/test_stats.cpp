@@ -0,0 +1,176 @@
+#include "test_helpers.hpp"
+#include <fstream>
+#include <ss/parser.hpp>
+
+namespace {
+void write_file(const std::string& name, const std::string& data) {
+    std::ofstream out{name, std::ios::binary};
+    out << data;
+}
+
+template <typename... Ts>
+void test_counters() {
+    unique_file_name f{"test_stats"};
+    const std::string data = "1,2.5,a\n2,x,b\n\n3,3.5\n4,4.5,c\n";
+    write_file(f.name, data);
+
+    ss::parser<ss::collect_stats, Ts...> p{f.name, ","};
+    size_t valid = 0;
+    while (!p.eof()) {
+        if constexpr (ss::setup<Ts...>::throw_on_error) {
+            try {
+                p.template get_next<int, double, std::string>();
+                ++valid;
+            } catch (ss::exception&) {
+            }
+        } else {
+            p.template get_next<int, double, std::string>();
+            valid += p.valid();
+        }
+    }
+    CHECK_EQ(valid, 2);
+
+    auto stats = p.stats();
+    CHECK_EQ(stats.bytes_read, data.size());
+    CHECK_EQ(stats.lines, 5);
+    CHECK_EQ(stats.records, 5);
+    CHECK_EQ(stats.multiline_joins, 0);
+    CHECK_EQ(stats.fields_split, 3 + 3 + 0 + 2 + 3);
+    CHECK_EQ(stats.integer_conversions, 3);
+    CHECK_EQ(stats.floating_point_conversions, 2);
+    CHECK_EQ(stats.string_conversions, 2);
+    CHECK_EQ(stats.conversions(), 7);
+    CHECK_EQ(stats.failure_count(ss::error_code::invalid_conversion), 1);
+    CHECK_EQ(stats.failure_count(ss::error_code::number_of_columns), 2);
+    CHECK_EQ(stats.timed_records, 0);
+    CHECK_EQ(stats.split_ticks, 0);
+}
+
+template <typename... Ts>
+void test_multiline_counters() {
+    unique_file_name f{"test_stats"};
+    const std::string data = "\"a\"\"b\",1\n\"c\n\nd\",2\ne\\,f,3\n"
+                             "\"g\\\"h\"\"\n\",4\n";
+    write_file(f.name, data);
+
+    ss::parser<ss::collect_stats, ss::quote<'"'>, ss::escape<'\\'>,
+               ss::multiline, Ts...>
+        p{f.name, ","};
+    std::vector<std::string> values;
+    for (const auto& [s, i] : p.template iterate<std::string, int>()) {
+        values.push_back(s);
+    }
+
+    std::vector<std::string> expected = {"a\"b", "c\n\nd", "e,f",
+                                         "g\"h\"\n"};
+    CHECK_EQ(values, expected);
+
+    auto stats = p.stats();
+    CHECK_EQ(stats.bytes_read, data.size());
+    CHECK_EQ(stats.lines, 7);
+    CHECK_EQ(stats.records, 4);
+    CHECK_EQ(stats.multiline_joins, 3);
+    // the records fit into the buffers allocated while reading the lines
+    CHECK_EQ(stats.reallocs, 0);
+    CHECK_EQ(stats.escapes_shifted, 4);
+    CHECK_EQ(stats.fields_split, 8);
+    CHECK_EQ(stats.string_conversions, 4);
+    CHECK_EQ(stats.integer_conversions, 4);
+}
+} /* namespace */
+
+TEST_CASE("stats test counters") {
+    test_counters();
+    test_counters<ss::string_error>();
+    test_counters<ss::structured_error>();
+    test_counters<ss::throw_on_error>();
+}
+
+TEST_CASE("stats test multiline counters") {
+    test_multiline_counters();
+    test_multiline_counters<ss::string_error>();
+    test_multiline_counters<ss::structured_error>();
+    test_multiline_counters<ss::throw_on_error>();
+    test_multiline_counters<ss::table_driven>();
+}
+
+TEST_CASE("stats test multiline growth") {
+    unique_file_name f{"test_stats"};
+    std::string value;
+    for (size_t i = 0; i < 10000; ++i) {
+        value += "line " + std::to_string(i) + "\n";
+    }
+    write_file(f.name, "1,\"" + value + "\",x\n2,\"" + value + "\",y\n");
+
+    ss::parser<ss::collect_stats, ss::quote<'"'>, ss::multiline> p{f.name,
+                                                                    ","};
+    for (const auto& [i, s, c] : p.iterate<int, std::string, char>()) {
+        CHECK_EQ(s, value);
+        (void)i;
+        (void)c;
+    }
+
+    // the buffer of each record grows geometrically
+    auto stats = p.stats();
+    CHECK_EQ(stats.records, 2);
+    CHECK_EQ(stats.multiline_joins, 2 * 10000);
+    CHECK(stats.reallocs > 0);
+    CHECK(stats.reallocs < 2 * 16);
+}
+
+TEST_CASE("stats test split failures") {
+    unique_file_name f{"test_stats"};
+    write_file(f.name, "\"a\"b,1\n\"c\n\nd\",2\n3\\\n");
+
+    ss::parser<ss::collect_stats, ss::quote<'"'>, ss::escape<'\\'>,
+               ss::multiline_restricted<1>>
+        p{f.name, ","};
+    while (!p.eof()) {
+        p.get_next<std::string, int>();
+    }
+
+    auto stats = p.stats();
+    CHECK_EQ(stats.failure_count(ss::error_code::mismatched_quote), 1);
+    CHECK_EQ(stats.failure_count(ss::error_code::multiline_limit_reached),
+             1);
+    CHECK_EQ(stats.failure_count(ss::error_code::unterminated_escape), 1);
+}
+
+TEST_CASE("stats test timing") {
+    unique_file_name f{"test_stats"};
+    std::string data;
+    for (size_t i = 0; i < 101; ++i) {
+        data += std::to_string(i) + ",x\n";
+    }
+    write_file(f.name, data);
+
+    ss::parser<ss::collect_stats_timed<10>> p{f.name, ","};
+    for (const auto& [i, s] : p.iterate<int, std::string>()) {
+        (void)i;
+        (void)s;
+    }
+
+    auto stats = p.stats();
+    CHECK_EQ(stats.records, 101);
+    CHECK_EQ(stats.timed_records, 11);
+    CHECK_NE(stats.read_ticks, 0);
+    CHECK_NE(stats.split_ticks, 0);
+    CHECK_NE(stats.convert_ticks, 0);
+}
+
+TEST_CASE("stats test converter") {
+    ss::converter<ss::collect_stats, ss::quote<'"'>> c;
+    std::string line = "\"a\"\"b\",1,x";
+    c.convert<std::string, int, char>(line.data());
+    c.convert<std::string, int, int>(buff("1,2,x"));
+    c.convert<std::string, int>(buff("1,2,x"));
+
+    auto stats = c.stats();
+    CHECK_EQ(stats.escapes_shifted, 1);
+    CHECK_EQ(stats.string_conversions, 2);
+    CHECK_EQ(stats.integer_conversions, 2);
+    CHECK_EQ(stats.other_conversions, 1);
+    CHECK_EQ(stats.failure_count(ss::error_code::invalid_conversion), 1);
+    CHECK_EQ(stats.failure_count(ss::error_code::number_of_columns), 1);
+    CHECK_EQ(stats.records, 0);
+}
@@ -0,0 +1,406 @@
+#include "test_helpers.hpp"
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <ss/parallel_writer.hpp>
+#include <ss/parser.hpp>
+#include <ss/writer.hpp>
+#include <thread>
+
+#if __unix__
+#include <csignal>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+struct row {
+    int i;
+    double d;
+    std::string s;
+    std::optional<int> o;
+    bool b;
+    char c;
+
+    auto tied() {
+        return std::tie(i, d, s, o, b, c);
+    }
+
+    bool operator==(const row& other) const {
+        return i == other.i && d == other.d && s == other.s && o == other.o &&
+               b == other.b && c == other.c;
+    }
+};
+
+std::vector<row> make_rows() {
+    const std::vector<std::string> strings = {"plain",
+                                              "",
+                                              ",",
+                                              "with,delimiter",
+                                              "with \"quotes\"",
+                                              "\"",
+                                              "new\nline",
+                                              "crlf\r\nline",
+                                              "back\\slash",
+                                              "\\",
+                                              " leading",
+                                              "trailing ",
+                                              "::",
+                                              "a longer field with a comma ,",
+                                              "a longer field without one"};
+
+    std::vector<row> rows;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        int n = static_cast<int>(i);
+        std::optional<int> o;
+        if (i % 2 == 0) {
+            o = -n;
+        }
+        rows.push_back(row{n * 1000 - 7, 1.0 / (n + 3), strings[i], o,
+                           i % 3 == 0, static_cast<char>('a' + n)});
+    }
+    rows.push_back(row{std::numeric_limits<int>::min(), 1e300, "x", 0, true,
+                       ','});
+    rows.push_back(row{std::numeric_limits<int>::max(), -0.1, "y", {}, false,
+                       '"'});
+    return rows;
+}
+
+template <typename... Ts>
+void test_round_trip(const std::string& delim, size_t buffer_size) {
+    unique_file_name f{"test_writer"};
+    auto rows = make_rows();
+
+    {
+        ss::writer<Ts...> w{f.name, delim, buffer_size};
+        for (auto& r : rows) {
+            w.write(r);
+            CHECK(w.valid());
+        }
+    }
+
+    ss::parser<Ts..., ss::multiline> p{f.name, delim};
+    std::vector<row> read;
+    for (auto& r : p.template iterate<row>()) {
+        REQUIRE(p.valid());
+        read.push_back(r);
+    }
+    CHECK_EQ(read, rows);
+}
+} /* namespace */
+
+TEST_CASE("writer test contains any") {
+    std::string data(37, 'x');
+    CHECK_FALSE(ss::contains_any(data.data(), data.size(), ",\n"));
+    for (size_t i = 0; i < data.size(); ++i) {
+        std::string copy = data;
+        copy[i] = '\n';
+        CHECK(ss::contains_any(copy.data(), copy.size(), ",\n"));
+        CHECK_FALSE(ss::contains_any(copy.data(), i, ",\n"));
+    }
+}
+
+TEST_CASE("writer test round trip") {
+    using quote = ss::quote<'"'>;
+    using escape = ss::escape<'\\'>;
+
+    for (size_t buffer_size : {64, 1024 * 1024}) {
+        test_round_trip<quote>(",", buffer_size);
+        test_round_trip<quote, escape>(",", buffer_size);
+        test_round_trip<quote, ss::trim<' '>>(",", buffer_size);
+        test_round_trip<quote, ss::string_error>("::", buffer_size);
+        test_round_trip<escape, ss::throw_on_error>(",", buffer_size);
+        test_round_trip<escape, ss::structured_error>("::", buffer_size);
+    }
+}
+
+TEST_CASE("writer test numbers and values") {
+    unique_file_name f{"test_writer"};
+    {
+        ss::writer w{f.name};
+        w.write(1, -2, 3u, 0.5, 'c', true, std::string_view{"sv"}, "cs");
+        w.write(std::make_tuple(std::variant<int, std::string>{"v"},
+                                std::optional<double>{}));
+        w.flush();
+        CHECK(w.valid());
+    }
+
+    std::ifstream in{f.name};
+    std::string line;
+    std::getline(in, line);
+    CHECK_EQ(line, "1,-2,3,0.5,c,true,sv,cs");
+    std::getline(in, line);
+    CHECK_EQ(line, "v,");
+}
+
+template <typename... Ts>
+void test_invalid_field() {
+    unique_file_name f{"test_writer"};
+    {
+        ss::writer<Ts...> w{f.name};
+        w.write("a", 1);
+        CHECK(w.valid());
+
+        if constexpr (ss::setup<Ts...>::throw_on_error) {
+            REQUIRE_EXCEPTION(w.write("b,c", 2));
+        } else {
+            w.write("b,c", 2);
+            CHECK_FALSE(w.valid());
+        }
+
+        w.write("d", 3);
+        CHECK(w.valid());
+    }
+
+    std::ifstream in{f.name};
+    std::string content{std::istreambuf_iterator<char>{in}, {}};
+    CHECK_EQ(content, "a,1\nd,3\n");
+}
+
+TEST_CASE("writer test invalid field") {
+    test_invalid_field();
+    test_invalid_field<ss::string_error>();
+    test_invalid_field<ss::structured_error>();
+    test_invalid_field<ss::throw_on_error>();
+
+    ss::writer<ss::structured_error> w{"invalid_directory/file.csv"};
+    CHECK_EQ(w.error_info().code, ss::error_code::file_not_open);
+    w.write(1);
+    CHECK_FALSE(w.valid());
+}
+
+TEST_CASE("writer test row block") {
+    ss::row_block<> b;
+    CHECK(b.write(1, "x"));
+    CHECK_FALSE(b.write(2, "y", "z,"));
+    CHECK_EQ(b.invalid_column(), 2);
+    CHECK_EQ(std::string(b.data(), b.size()), "1,x\n");
+
+    b.clear();
+    CHECK(b.empty());
+}
+
+template <typename... Ts>
+void test_parallel_writer(size_t max_buffered) {
+    constexpr size_t blocks = 64;
+    constexpr size_t rows = 50;
+    constexpr size_t threads = 4;
+
+    unique_file_name f{"test_writer"};
+    {
+        ss::parallel_writer<ss::quote<'"'>, Ts...> w{f.name, ",",
+                                                     max_buffered};
+        std::vector<std::thread> producers;
+        for (size_t t = 0; t < threads; ++t) {
+            producers.emplace_back([&w, t] {
+                // every thread formats every n-th block
+                for (size_t i = t; i < blocks; i += threads) {
+                    auto b = w.make_block();
+                    for (size_t j = 0; j < rows; ++j) {
+                        b.write(i * rows + j, "a,\"" + std::to_string(j));
+                    }
+                    w.submit(i, std::move(b));
+                }
+            });
+        }
+
+        for (auto& p : producers) {
+            p.join();
+        }
+        w.finish();
+        CHECK(w.valid());
+    }
+
+    ss::parser<ss::quote<'"'>> p{f.name, ","};
+    size_t n = 0;
+    for (const auto& [i, s] : p.iterate<size_t, std::string>()) {
+        REQUIRE(p.valid());
+        CHECK_EQ(i, n);
+        CHECK_EQ(s, "a,\"" + std::to_string(n % rows));
+        ++n;
+    }
+    CHECK_EQ(n, blocks * rows);
+}
+
+TEST_CASE("writer test parallel writer") {
+    test_parallel_writer(0);
+    test_parallel_writer(1024);
+    test_parallel_writer<ss::string_error>(1024 * 1024);
+}
+
+template <typename... Ts>
+void test_parallel_writer_missing_block() {
+    unique_file_name f{"test_writer"};
+    ss::parallel_writer<Ts...> w{f.name};
+    for (size_t i : {0, 2}) {
+        auto b = w.make_block();
+        b.write(i);
+        CHECK(w.submit(i, std::move(b)));
+    }
+
+    if constexpr (ss::setup<Ts...>::throw_on_error) {
+        REQUIRE_EXCEPTION(w.finish());
+    } else {
+        w.finish();
+        CHECK_FALSE(w.valid());
+        if constexpr (ss::setup<Ts...>::structured_error) {
+            CHECK_EQ(w.error_info().code, ss::error_code::missing_block);
+            CHECK_EQ(w.error_info().expected, 1);
+        }
+    }
+
+    auto b = w.make_block();
+    CHECK_FALSE(w.submit(3, std::move(b)));
+
+    std::ifstream in{f.name};
+    std::string content{std::istreambuf_iterator<char>{in}, {}};
+    CHECK_EQ(content, "0\n");
+}
+
+TEST_CASE("writer test parallel writer missing block") {
+    test_parallel_writer_missing_block();
+    test_parallel_writer_missing_block<ss::string_error>();
+    test_parallel_writer_missing_block<ss::structured_error>();
+    test_parallel_writer_missing_block<ss::throw_on_error>();
+}
+
+template <typename... Ts>
+void test_parallel_writer_reused_sequence() {
+    unique_file_name f{"test_writer"};
+    ss::parallel_writer<Ts...> w{f.name};
+    auto submit = [&w](size_t i, const std::string& value) {
+        auto b = w.make_block();
+        b.write(value);
+        return w.submit(i, std::move(b));
+    };
+
+    CHECK(submit(1, "1"));
+    CHECK_FALSE(submit(1, "x"));
+    CHECK(submit(0, "0"));
+    CHECK_FALSE(submit(0, "y"));
+    CHECK(submit(2, "2"));
+
+    w.finish();
+    CHECK(w.valid());
+
+    std::ifstream in{f.name};
+    std::string content{std::istreambuf_iterator<char>{in}, {}};
+    CHECK_EQ(content, "0\n1\n2\n");
+}
+
+TEST_CASE("writer test parallel writer reused sequence") {
+    test_parallel_writer_reused_sequence();
+    test_parallel_writer_reused_sequence<ss::string_error>();
+    test_parallel_writer_reused_sequence<ss::structured_error>();
+    test_parallel_writer_reused_sequence<ss::throw_on_error>();
+}
+
+#if __unix__
+template <typename... Ts>
+void test_parallel_writer_write_failed() {
+    ss::parallel_writer<Ts...> w{"/dev/full"};
+    REQUIRE(w.valid());
+
+    // the first block is submitted last, so the blocks up to 63 are written
+    // in one batch which fails, and the last block is skipped after it
+    auto submit = [&w](size_t i) {
+        auto b = w.make_block();
+        b.write(i, std::string(1024, 'x'));
+        w.submit(i, std::move(b));
+    };
+    for (size_t i = 1; i <= 64; ++i) {
+        submit(i);
+    }
+    submit(0);
+
+    if constexpr (ss::setup<Ts...>::throw_on_error) {
+        REQUIRE_EXCEPTION(w.finish());
+    } else {
+        w.finish();
+        CHECK_FALSE(w.valid());
+        if constexpr (ss::setup<Ts...>::string_error) {
+            CHECK_FALSE(w.error_msg().empty());
+        } else if constexpr (ss::setup<Ts...>::structured_error) {
+            CHECK_EQ(w.error_info().code, ss::error_code::write_failed);
+        }
+    }
+}
+
+TEST_CASE("writer test parallel writer write failed") {
+    test_parallel_writer_write_failed();
+    test_parallel_writer_write_failed<ss::string_error>();
+    test_parallel_writer_write_failed<ss::structured_error>();
+    test_parallel_writer_write_failed<ss::throw_on_error>();
+}
+
+extern "C" void ignore_signal(int) {
+}
+
+TEST_CASE("writer test parallel writer interrupted write") {
+    unique_file_name f{"test_writer"};
+    REQUIRE_EQ(::mkfifo(f.name.c_str(), 0600), 0);
+
+    // the pipe is filled first, so the write of the writer blocks without
+    // writing anything until the pipe is read
+    int in = ::open(f.name.c_str(), O_RDONLY | O_NONBLOCK);
+    int fill = ::open(f.name.c_str(), O_WRONLY | O_NONBLOCK);
+    REQUIRE(in != -1);
+    REQUIRE(fill != -1);
+
+    std::string chunk(4096, 'x');
+    size_t filled = 0;
+    for (ssize_t n; (n = ::write(fill, chunk.data(), chunk.size())) > 0;) {
+        filled += n;
+    }
+    ::close(fill);
+
+    // without SA_RESTART the blocked write fails with EINTR
+    struct sigaction action {};
+    struct sigaction old_action {};
+    action.sa_handler = ignore_signal;
+    ::sigaction(SIGUSR1, &action, &old_action);
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+
+    std::string content;
+    {
+        ss::parallel_writer<ss::structured_error> w{f.name};
+        REQUIRE(w.valid());
+
+        // the writing thread is the only one which receives the signal
+        ::pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        auto b = w.make_block();
+        b.write("a");
+        REQUIRE(w.submit(0, std::move(b)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        ::kill(::getpid(), SIGUSR1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        char buffer[4096];
+        for (size_t tries = 0; content.size() < filled + 2 && tries < 5000;
+             ++tries) {
+            ssize_t n = ::read(in, buffer, sizeof(buffer));
+            if (n > 0) {
+                content.append(buffer, n);
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        w.finish();
+        CHECK(w.valid());
+    }
+
+    ::pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+    ::sigaction(SIGUSR1, &old_action, nullptr);
+    ::close(in);
+
+    REQUIRE_EQ(content.size(), filled + 2);
+    CHECK_EQ(content.substr(filled), "a\n");
+}
+#endif